@@ -11,9 +11,17 @@ echo "  eduWRENCH - Build"
 echo "======================================"
 printf "\n${NC}"
 
-# Start Node server
+# Start simulator launcher
 printf "${CYAN}"
-echo "[1/2] START NODE SERVER"
+echo "[1/3] START SIMULATOR LAUNCHER"
+printf "${NC}\n"
+
+cd /home/wrench/eduwrench/simulators/launcher
+./eduwrench_launcher &
+
+# Start Node server
+printf "${CYAN}\n"
+echo "[2/3] START NODE SERVER"
 printf "${NC}\n"
 
 cd /home/wrench/eduwrench/server
@@ -22,7 +30,7 @@ node app.js &
 
 # Start Gatsby server
 printf "${CYAN}\n"
-echo "[2/2] START GATSBY SERVER"
+echo "[3/3] START GATSBY SERVER"
 printf "${NC}\n"
 
 cd /home/wrench/eduwrench/web
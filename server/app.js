@@ -12,10 +12,31 @@ const express = require("express"),
     bodyParser = require("body-parser"),
     methodOverride = require("method-override"),
     au = require("ansi_up"),
-    {spawnSync} = require("child_process"),
-    fs = require("fs")
+    {spawn} = require("child_process"),
+    fs = require("fs"),
+    net = require("net"),
+    os = require("os"),
+    path = require("path"),
+    {readColumnarOutput} = require("./columnar-reader")
 
 const PORT = process.env.EDUWRENCH_NODE_PORT || 3000
+// Unix socket of the simulator launcher daemon (simulators/launcher)
+const LAUNCHER_SOCKET = process.env.EDUWRENCH_LAUNCHER_SOCKET || "/tmp/eduwrench_launcher.sock"
+// simulators whose results only depend on their arguments, and can thus be cached by the launcher
+// (not thrustd: its args.json names workflow, trace and pstate table files, which the cache key
+// does not cover)
+const CACHEABLE_SIMULATORS = new Set([
+    "networking_fundamentals_simulator",
+    "io_simulator",
+    "multi_core_simulator",
+    "multi_core_io_simulator",
+    "client_server_simulator",
+    "workflow_fundamentals_simulator",
+    "workflow_distributed_simulator",
+    "workflow_task_data_parallelism_simulator",
+    "ci_overhead_simulator",
+    "storage_simulator"
+])
 const cors = require("cors")
 const db = require("./data/db-config")
 // WRENCH produces output to the terminal using ansi colors, ansi_up will apply those colors to <span> html elements
@@ -55,7 +76,7 @@ app.get("/", function (req, res) {
 })
 
 // execute networking fundamentals simulation route
-app.post("/run/networking_fundamentals", function (req, res) {
+app.post("/run/networking_fundamentals", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("networking_fundamentals")
     const SIMULATOR = "networking_fundamentals_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -76,7 +97,10 @@ app.post("/run/networking_fundamentals", function (req, res) {
     ];
     const SIMULATION_ARGS = FILE_SIZES.concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS, true)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS, true)
 
     if (simulation_output !== null) {
         logData({
@@ -90,13 +114,14 @@ app.post("/run/networking_fundamentals", function (req, res) {
         })
 
         res.json({
-            simulation_output: simulation_output.replace(/[\n\r]/g, "<br>\n")
+            simulation_output: simulation_output.replace(/[\n\r]/g, "<br>\n"),
+            event_log: readEventLog(OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute workflow execution fundamentals simulation route
-app.post("/run/workflow_execution_fundamentals", function (req, res) {
+app.post("/run/workflow_execution_fundamentals", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("workflow_execution_fundamentals")
     const SIMULATOR = "workflow_execution_fundamentals_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -115,7 +140,10 @@ app.post("/run/workflow_execution_fundamentals", function (req, res) {
 
     const SIMULATION_ARGS = [COMPUTE_SPEED].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -129,14 +157,15 @@ app.post("/run/workflow_execution_fundamentals", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR),
         });
     }
-});
+}));
 
 // execute activity 1 simulation route
-app.post("/run/workflow_execution_data_locality", function (req, res) {
+app.post("/run/workflow_execution_data_locality", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("workflow_execution_data_locality")
     const SIMULATOR = "workflow_execution_data_locality_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -156,7 +185,10 @@ app.post("/run/workflow_execution_data_locality", function (req, res) {
 
     const SIMULATION_ARGS = [LINK_BANDWIDTH, STORAGE_OPTION].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -170,14 +202,15 @@ app.post("/run/workflow_execution_data_locality", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR),
         })
     }
-});
+}));
 
 // execute Workflow Execution and Parallelism simulation route
-app.post("/run/workflow_execution_parallelism", function (req, res) {
+app.post("/run/workflow_execution_parallelism", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("workflow_execution_parallelism")
     const SIMULATOR = "workflow_execution_parallelism_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -206,7 +239,10 @@ app.post("/run/workflow_execution_parallelism", function (req, res) {
         RAM_REQUIRED,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -223,14 +259,15 @@ app.post("/run/workflow_execution_parallelism", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR),
         })
     }
-});
+}));
 
 // execute activity multi core dependent tasks simulation route
-app.post("/run/multi_core_dependent_tasks", function (req, res) {
+app.post("/run/multi_core_dependent_tasks", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("multi_core_computing_dependent_tasks")
     const SIMULATOR = "multi_core_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -251,7 +288,10 @@ app.post("/run/multi_core_dependent_tasks", function (req, res) {
 
     const SIMULATION_ARGS = [NUM_CORES, ANALYZE_WORK, SCHEDULING_SCHEME].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -266,14 +306,15 @@ app.post("/run/multi_core_dependent_tasks", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR),
         })
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/multi_core_independent_tasks", function (req, res) {
+app.post("/run/multi_core_independent_tasks", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("multi_core_computing_independent_tasks")
     const SIMULATOR = "multi_core_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -297,7 +338,10 @@ app.post("/run/multi_core_independent_tasks", function (req, res) {
         LOGGING
     );
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -313,14 +357,15 @@ app.post("/run/multi_core_independent_tasks", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR),
         })
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/multi_core_independent_tasks_io", function (req, res) {
+app.post("/run/multi_core_independent_tasks_io", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("multi_core_computing_two_tasks_with_io")
     const SIMULATOR = "multi_core_io_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -353,7 +398,10 @@ app.post("/run/multi_core_independent_tasks_io", function (req, res) {
         TASK1_BEFORE_TASK2,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -369,14 +417,15 @@ app.post("/run/multi_core_independent_tasks_io", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/multi_core_data_parallelism", function (req, res) {
+app.post("/run/multi_core_data_parallelism", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("multi_core_computing_data_parallelism")
     const SIMULATOR = "multi_core_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -396,7 +445,10 @@ app.post("/run/multi_core_data_parallelism", function (req, res) {
 
     const SIMULATION_ARGS = [NUM_CORES, OIL_RADIUS].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -410,14 +462,15 @@ app.post("/run/multi_core_data_parallelism", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/multi_core_independent_tasks_ram", function (req, res) {
+app.post("/run/multi_core_independent_tasks_ram", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("multi_core_computing_independent_tasks")
     const SIMULATOR = "multi_core_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -441,7 +494,10 @@ app.post("/run/multi_core_independent_tasks_ram", function (req, res) {
         LOGGING
     );
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -457,14 +513,15 @@ app.post("/run/multi_core_independent_tasks_ram", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute activity io operations simulation route
-app.post("/run/io_operations", function (req, res) {
+app.post("/run/io_operations", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("io_operations")
     const SIMULATOR = "io_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -493,7 +550,10 @@ app.post("/run/io_operations", function (req, res) {
         IO_OVERLAP,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -510,14 +570,15 @@ app.post("/run/io_operations", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // SIMPLIFIED (NO DISK) CLIENT SERVER SIMULATOR
-app.post("/run/client_server", function (req, res) {
+app.post("/run/client_server", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("client_server")
     const SIMULATOR = "client_server_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -555,7 +616,10 @@ app.post("/run/client_server", function (req, res) {
         FILE_SIZE,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -575,14 +639,15 @@ app.post("/run/client_server", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // FULL CLIENT SERVER (NOT SIMPLIFIED)
-app.post("/run/client_server_disk", function (req, res) {
+app.post("/run/client_server_disk", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("client_server")
     const SIMULATOR = "client_server_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -621,7 +686,10 @@ app.post("/run/client_server_disk", function (req, res) {
         FILE_SIZE,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -641,14 +709,15 @@ app.post("/run/client_server_disk", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute activity client server simulation route
-app.post("/run/coordinator_worker", function (req, res) {
+app.post("/run/coordinator_worker", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("master_worker")
     const SIMULATOR = "master_worker_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -732,7 +801,10 @@ app.post("/run/coordinator_worker", function (req, res) {
             .concat(ABBREV_LOGGING);
     }
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS, NUM_INVOCATION !== 1)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS, NUM_INVOCATION !== 1)
 
     if (simulation_output !== null) {
 
@@ -758,8 +830,9 @@ app.post("/run/coordinator_worker", function (req, res) {
                 }
             })
             res.json({
-                simulation_output: ansiUpSimulationOutput(simulation_output),
-                task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+                simulation_output: renderSimulationOutput(req, simulation_output),
+                event_log: readEventLog(OUTPUT_DIR),
+                task_data: await readTaskData(req, OUTPUT_DIR)
             })
 
         } else {
@@ -790,13 +863,14 @@ app.post("/run/coordinator_worker", function (req, res) {
             res.json({
                 simulation_output:
                     "<h5>" + simulation_output.replace(/[\n\r]/g, "<br>\n") + "</h5>",
+                event_log: readEventLog(OUTPUT_DIR)
             })
         }
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/workflow_fundamentals", function (req, res) {
+app.post("/run/workflow_fundamentals", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("workflow_fundamentals")
     const SIMULATOR = "workflow_fundamentals_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -816,7 +890,10 @@ app.post("/run/workflow_fundamentals", function (req, res) {
 
     const SIMULATION_ARGS = [NUM_CORES, DISK_BANDWIDTH].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -830,14 +907,15 @@ app.post("/run/workflow_fundamentals", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/workflow_distributed", function (req, res) {
+app.post("/run/workflow_distributed", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("workflow_distributed")
     const SIMULATOR = "workflow_distributed_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -865,7 +943,10 @@ app.post("/run/workflow_distributed", function (req, res) {
         USE_LOCAL_STORAGE,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -881,14 +962,15 @@ app.post("/run/workflow_distributed", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute activity multi core simulation route
-app.post("/run/workflow_task_data_parallelism", function (req, res) {
+app.post("/run/workflow_task_data_parallelism", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("workflow_task_data_parallelism")
     const SIMULATOR = "workflow_task_data_parallelism_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -914,7 +996,10 @@ app.post("/run/workflow_task_data_parallelism", function (req, res) {
         NUM_CORES_PURPLE,
     ].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -929,14 +1014,15 @@ app.post("/run/workflow_task_data_parallelism", function (req, res) {
         })
 
         res.json({
-            simulation_output: ansiUpSimulationOutput(simulation_output),
-            task_data: JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            simulation_output: renderSimulationOutput(req, simulation_output),
+            event_log: readEventLog(OUTPUT_DIR),
+            task_data: await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // SIMPLIFIED (NO DISK) CLIENT SERVER SIMULATOR
-app.post("/run/ci_overhead", function (req, res) {
+app.post("/run/ci_overhead", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("ci_overhead")
     const SIMULATOR = "ci_overhead_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -968,7 +1054,10 @@ app.post("/run/ci_overhead", function (req, res) {
 
     const SIMULATION_ARGS = [SERVER_1_LINK_LATENCY, SERVER_1_LINK_BANDWIDTH, SERVER_2_LINK_BANDWIDTH, BUFFER_SIZE, HOST_SELECT, DISK_TOGGLE, DISK_SPEED, FILE_SIZE, COMPUTE_1_STARTUP, COMPUTE_2_STARTUP, TASK_WORK].concat(LOGGING);
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -991,14 +1080,15 @@ app.post("/run/ci_overhead", function (req, res) {
         })
 
         res.json({
-            "simulation_output": ansiUpSimulationOutput(simulation_output),
-            "task_data": JSON.parse(fs.readFileSync("/tmp/workflow_data.json"))
+            "simulation_output": renderSimulationOutput(req, simulation_output),
+            "event_log": readEventLog(OUTPUT_DIR),
+            "task_data": await readTaskData(req, OUTPUT_DIR)
         })
     }
-});
+}));
 
 // execute thrust d simulator
-app.post("/run/thrustd", function (req, res) {
+app.post("/run/thrustd", asyncHandler(async function (req, res) {
     const PATH_PREFIX = __dirname.replace(
         "server",
         "simulators/thrustd/"
@@ -1049,15 +1139,17 @@ app.post("/run/thrustd", function (req, res) {
     console.log(args_json);
     const fs = require('fs');
 
-    fs.writeFileSync("/tmp/args.json", JSON.stringify(json_data, null, 2).concat("\n"), (err) => {
+    const OUTPUT_DIR = createOutputDirectory(res);
+    fs.writeFileSync(OUTPUT_DIR + "/args.json", JSON.stringify(json_data, null, 2).concat("\n"), (err) => {
         if (err) console.log('error', err);
     });
 
     const SIMULATION_ARGS = [
-        "/tmp/args.json"
+        OUTPUT_DIR + "/args.json",
+        ...outputArgs(req, OUTPUT_DIR)
     ].concat(LOGGING);
 
-    var simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS);
+    var simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS);
 
     let sim_output_start = simulation_output.indexOf("Total");
     let trimmed_sim_output = simulation_output.substring(sim_output_start);
@@ -1085,13 +1177,13 @@ app.post("/run/thrustd", function (req, res) {
 
         res.json({
             "simulation_output": printed_sim_output,
-            "task_data": JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            "task_data": await readTaskData(req, OUTPUT_DIR),
         })
     }
-});
+}));
 
 // execute thrust d cloud simulator
-app.post("/run/thrustd_cloud", function (req, res) {
+app.post("/run/thrustd_cloud", asyncHandler(async function (req, res) {
     const PATH_PREFIX = __dirname.replace(
         "server",
         "simulators/thrustd/"
@@ -1216,15 +1308,17 @@ app.post("/run/thrustd_cloud", function (req, res) {
     let args_json = JSON.stringify(json_data);
     console.log(args_json);
     const fs = require('fs');
-    fs.writeFileSync("/tmp/args.json", JSON.stringify(json_data, null, 2).concat("\n"), (err) => {
+    const OUTPUT_DIR = createOutputDirectory(res);
+    fs.writeFileSync(OUTPUT_DIR + "/args.json", JSON.stringify(json_data, null, 2).concat("\n"), (err) => {
         if (err) console.log('error', err);
     });
 
     const SIMULATION_ARGS = [
-        "/tmp/args.json"
+        OUTPUT_DIR + "/args.json",
+        ...outputArgs(req, OUTPUT_DIR)
     ].concat(LOGGING);
 
-    var simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS);
+    var simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS);
 
     let sim_output_start = simulation_output.indexOf("Total");
     let trimmed_sim_output = simulation_output.substring(sim_output_start);
@@ -1250,13 +1344,13 @@ app.post("/run/thrustd_cloud", function (req, res) {
 
         res.json({
             "simulation_output": printed_sim_output,
-            "task_data": JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            "task_data": await readTaskData(req, OUTPUT_DIR),
         })
     }
-});
+}));
 
 // execute activity storage service simulation route
-app.post("/run/storage_service", function (req, res) {
+app.post("/run/storage_service", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("storage_interaction_data_movement")
     const SIMULATOR = "storage_simulator"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -1279,7 +1373,10 @@ app.post("/run/storage_service", function (req, res) {
 
     const SIMULATION_ARGS = [BANDWIDTH, FILE_SIZE, REGISTRATION_OVERHEAD].concat(LOGGING)
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -1293,14 +1390,15 @@ app.post("/run/storage_service", function (req, res) {
         })
 
         res.json({
-            "simulation_output": ansiUpSimulationOutput(simulation_output),
-            "task_data": JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            "simulation_output": renderSimulationOutput(req, simulation_output),
+            "event_log": readEventLog(OUTPUT_DIR),
+            "task_data": await readTaskData(req, OUTPUT_DIR),
         })
     }
-})
+}));
 
 // execute activity storage network proximity simulation route
-app.post("/run/storage_network_proximity", function (req, res) {
+app.post("/run/storage_network_proximity", asyncHandler(async function (req, res) {
     const PATH_PREFIX = getPathPrefix("storage_network_proximity")
     const SIMULATOR = "storage_network_proximity"
     const EXECUTABLE = PATH_PREFIX + SIMULATOR
@@ -1326,7 +1424,10 @@ app.post("/run/storage_network_proximity", function (req, res) {
     const SIMULATION_ARGS = [FILE_SIZE, SERVER1_BANDWIDTH, SERVER1_LATENCY, SERVER2_BANDWIDTH, SERVER2_LATENCY,
         SERVER3_BANDWIDTH, SERVER3_LATENCY].concat(LOGGING)
 
-    let simulation_output = launchSimulation(EXECUTABLE, SIMULATION_ARGS)
+    const OUTPUT_DIR = createOutputDirectory(res)
+    SIMULATION_ARGS.push(...outputArgs(req, OUTPUT_DIR))
+
+    let simulation_output = await launchSimulation(EXECUTABLE, SIMULATION_ARGS)
 
     if (simulation_output !== null) {
         logData({
@@ -1345,11 +1446,12 @@ app.post("/run/storage_network_proximity", function (req, res) {
         })
 
         res.json({
-            "simulation_output": ansiUpSimulationOutput(simulation_output),
-            "task_data": JSON.parse(fs.readFileSync("/tmp/workflow_data.json")),
+            "simulation_output": renderSimulationOutput(req, simulation_output),
+            "event_log": readEventLog(OUTPUT_DIR),
+            "task_data": await readTaskData(req, OUTPUT_DIR),
         })
     }
-})
+}));
 
 // get usage statistics
 app.post("/get/usage_statistics", function (req, res) {
@@ -1375,25 +1477,196 @@ function getPathPrefix(simulatorFolder) {
 }
 
 /**
+ * Wrap an async route handler so that errors are passed on to Express instead of being lost
+ * as unhandled promise rejections.
+ *
+ * @param handler
+ * @returns {function(*, *, *): Promise}
+ */
+function asyncHandler(handler) {
+    return (req, res, next) => handler(req, res).catch(next)
+}
+
+/**
+ * Create a fresh directory for the temporary and result files of one simulation run (passed to
+ * the simulator with --output-dir), so that concurrent requests do not overwrite each other's
+ * files. The directory is removed once the response has been sent.
+ *
+ * @param res
+ * @returns {string}
+ */
+function createOutputDirectory(res) {
+    const outputDir = fs.mkdtempSync(path.join(os.tmpdir(), "eduwrench_"))
+    res.on("close", () => {
+        fs.rmSync(outputDir, {recursive: true, force: true})
+    })
+    return outputDir
+}
+
+/**
+ * The arguments that tell a simulator where to write its files, whether to write an event log
+ * (when the client asked for one with event_log: true), and whether to write the columnar
+ * output instead of the unified JSON output (see readTaskData).
+ *
+ * @param req
+ * @param outputDir
+ * @returns {string[]}
+ */
+function outputArgs(req, outputDir) {
+    const args = ["--output-dir=" + outputDir]
+    if (req.body.event_log === true) {
+        args.push("--event-log")
+    }
+    if (req.body.columnar_output !== undefined) {
+        args.push("--columnar-output=" + [].concat(req.body.columnar_output).join(","))
+        if (req.body.columnar_compress === true) {
+            args.push("--columnar-compress")
+        }
+    }
+    return args
+}
+
+/**
+ * Read the simulation output data: the unified JSON output by default, or, when the client asked
+ * for the columnar output (columnar_output: a list of groups among "tasks", "file_transfers",
+ * "disk" and "links"), an object mapping each group to its columns.
+ *
+ * @param req
+ * @param outputDir
+ * @returns {Promise<Object>}
+ */
+async function readTaskData(req, outputDir) {
+    if (req.body.columnar_output === undefined) {
+        return JSON.parse(fs.readFileSync(path.join(outputDir, "workflow_data.json")))
+    }
+    // typed arrays would serialize as objects, so the columns are decoded into plain arrays
+    const groups = await readColumnarOutput(path.join(outputDir, "workflow_data.ewc"), undefined, true)
+    return {format: "columnar", groups: groups}
+}
+
+/**
+ * Read the event log (one JSON object per line) written by a simulator run with --event-log.
+ *
+ * @param outputDir
+ * @returns {Object[]|undefined} the events, or undefined if there is no event log
+ */
+function readEventLog(outputDir) {
+    let content
+    try {
+        content = fs.readFileSync(path.join(outputDir, "events.jsonl"), "utf8")
+    } catch (err) {
+        return undefined
+    }
+    return content.split("\n").filter(line => line.length > 0).map(line => JSON.parse(line))
+}
+
+/**
+ * Run a simulator through the launcher daemon (simulators/launcher), which streams back the
+ * simulator's output as JSON lines. Rejects if the launcher cannot be reached.
+ *
+ * @param executable
+ * @param args
+ * @param cacheable whether the launcher may answer from (and store the results in) its result cache
+ * @returns {Promise<{status: number, stdout: string, stderr: string}>}
+ */
+function runWithLauncher(executable, args, cacheable) {
+    return new Promise((resolve, reject) => {
+        const socket = net.createConnection(LAUNCHER_SOCKET)
+        let connected = false
+        let pending = ""
+        let result = {status: null, stdout: "", stderr: ""}
+
+        socket.setEncoding("utf8")
+        socket.on("connect", () => {
+            connected = true
+            socket.write(JSON.stringify({executable: executable, args: args, cache: cacheable}) + "\n")
+        })
+        socket.on("data", (data) => {
+            pending += data
+            let lines = pending.split("\n")
+            pending = lines.pop()
+            for (const line of lines) {
+                const message = JSON.parse(line)
+                if (message.stream !== undefined) {
+                    result[message.stream] += message.data
+                } else if (message.exit_status !== undefined) {
+                    result.status = message.exit_status
+                    result.cached = message.cached === true
+                } else if (message.error !== undefined) {
+                    result.stderr += message.error + "\n"
+                }
+            }
+        })
+        socket.on("error", (err) => {
+            if (!connected) {
+                reject(err)
+            } else {
+                result.stderr += err.toString() + "\n"
+            }
+        })
+        socket.on("close", () => {
+            if (connected) {
+                resolve(result)
+            }
+        })
+    })
+}
+
+/**
+ * Run a simulator as a child process of the server (used when the launcher is not running).
+ *
+ * @param executable
+ * @param args
+ * @returns {Promise<{status: number, stdout: string, stderr: string}>}
+ */
+function runWithSpawn(executable, args) {
+    return new Promise((resolve) => {
+        const simulation_process = spawn(executable, args)
+        let stdout = [], stderr = []
+        simulation_process.stdout.on("data", (data) => stdout.push(data))
+        simulation_process.stderr.on("data", (data) => stderr.push(data))
+        simulation_process.on("error", (err) => stderr.push(Buffer.from(err.toString() + "\n")))
+        simulation_process.on("close", (status) => {
+            resolve({
+                status: status,
+                stdout: Buffer.concat(stdout).toString(),
+                stderr: Buffer.concat(stderr).toString()
+            })
+        })
+    })
+}
+
+/**
+ * Run a simulator without blocking the event loop, preferably through the launcher daemon.
  *
  * @param executable
  * @param args
  * @param stdout
+ * @returns {Promise<string|null>} the simulator's stdout (or stderr), or null if the simulation failed
  */
-function launchSimulation(executable, args, stdout = false) {
+async function launchSimulation(executable, args, stdout = false) {
     const simulationCommand = [executable].concat(args).join(" ")
     console.log("\nRunning Simulation")
     console.log("===================")
     console.log("Executing command: " + simulationCommand)
-    let simulation_process = spawnSync(executable, args)
+    let simulation_process
+    try {
+        simulation_process = await runWithLauncher(executable, args,
+            CACHEABLE_SIMULATORS.has(path.basename(executable)))
+        if (simulation_process.cached) {
+            console.log("(cached result)")
+        }
+    } catch (err) {
+        simulation_process = await runWithSpawn(executable, args)
+    }
 
     if (simulation_process.status !== 0) {
         console.log("Something went wrong with the simulation. Possibly check arguments.")
-        console.log(simulation_process.stderr.toString())
+        console.log(simulation_process.stderr)
         return null
     }
 
-    let simulation_output = stdout ? simulation_process.stdout.toString() : simulation_process.stderr.toString()
+    let simulation_output = stdout ? simulation_process.stdout : simulation_process.stderr
     console.log(simulation_output)
     return simulation_output
 }
@@ -1410,8 +1683,24 @@ function launchSimulation(executable, args, stdout = false) {
 function ansiUpSimulationOutput(simulationOutput) {
     let find = "</span>"
     let re = new RegExp(find, "g")
-    console.log(ansiUp.ansi_to_html(simulationOutput).replace(re, "<br>" + find))
-    return ansiUp.ansi_to_html(simulationOutput).replace(re, "<br>" + find)
+    const html = ansiUp.ansi_to_html(simulationOutput).replace(re, "<br>" + find)
+    console.log(html)
+    return html
+}
+
+/**
+ * Render the simulation output as HTML, unless the client asked for the event log
+ * (event_log: true) without also asking for the text output (text_output: true).
+ *
+ * @param req
+ * @param simulationOutput
+ * @returns {string|undefined}
+ */
+function renderSimulationOutput(req, simulationOutput) {
+    if (req.body.event_log === true && req.body.text_output !== true) {
+        return undefined
+    }
+    return ansiUpSimulationOutput(simulationOutput)
 }
 
 /**
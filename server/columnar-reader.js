@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2019-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * Streaming reader of the columnar simulation output written by simulators run with
+ * --columnar-output (see simulators/common/include/ColumnarOutput.h for the file layout).
+ * The file is decoded while it is read (and inflated, if compressed), one column at a time,
+ * so that the whole (inflated) file is never held in memory at once.
+ */
+
+const fs = require("fs"),
+    zlib = require("zlib")
+
+const MAGIC = "EWCOL"
+const VERSION = 1
+const HEADER_SIZE = 8
+const FLAG_ZLIB = 0x01
+const TYPE_REAL = 0,
+    TYPE_COUNT = 1,
+    TYPE_STRING = 2
+
+/**
+ * Pulls exact numbers of bytes out of a readable stream.
+ */
+class StreamCursor {
+    constructor(stream) {
+        this.iterator = stream[Symbol.asyncIterator]()
+        this.chunks = []
+        this.length = 0
+    }
+
+    /**
+     * @param n
+     * @returns {Promise<Buffer>} the next n bytes
+     */
+    async take(n) {
+        while (this.length < n) {
+            const {value, done} = await this.iterator.next()
+            if (done) {
+                throw new Error("truncated columnar output file")
+            }
+            this.chunks.push(value)
+            this.length += value.length
+        }
+        const data = this.chunks.length === 1 ? this.chunks[0] : Buffer.concat(this.chunks, this.length)
+        const rest = data.subarray(n)
+        this.chunks = rest.length > 0 ? [rest] : []
+        this.length = rest.length
+        return data.subarray(0, n)
+    }
+
+    async u8() {
+        return (await this.take(1)).readUInt8(0)
+    }
+
+    async u32() {
+        return (await this.take(4)).readUInt32LE(0)
+    }
+
+    async string() {
+        return (await this.take(await this.u32())).toString("utf8")
+    }
+}
+
+/**
+ * Read one column, or skip it (keep = false).
+ *
+ * @param cursor
+ * @param numRows
+ * @param keep
+ * @param plainArrays whether to decode numbers into plain arrays rather than typed arrays
+ * @returns {Promise<{name: string, values: (Float64Array|Uint32Array|number[]|string[]|undefined)}>}
+ */
+async function readColumn(cursor, numRows, keep, plainArrays) {
+    const name = await cursor.string()
+    const type = await cursor.u8()
+    if (type === TYPE_REAL) {
+        const data = await cursor.take(8 * numRows)
+        if (!keep) {
+            return {name: name, values: undefined}
+        }
+        const values = plainArrays ? new Array(numRows) : new Float64Array(numRows)
+        for (let i = 0; i < numRows; i++) {
+            values[i] = data.readDoubleLE(8 * i)
+        }
+        return {name: name, values: values}
+    }
+    if (type === TYPE_COUNT || type === TYPE_STRING) {
+        let dictionary = []
+        if (type === TYPE_STRING) {
+            const dictionarySize = await cursor.u32()
+            for (let i = 0; i < dictionarySize; i++) {
+                dictionary.push(await cursor.string())
+            }
+        }
+        const data = await cursor.take(4 * numRows)
+        if (!keep) {
+            return {name: name, values: undefined}
+        }
+        const values = type === TYPE_COUNT && !plainArrays ? new Uint32Array(numRows) : new Array(numRows)
+        for (let i = 0; i < numRows; i++) {
+            const value = data.readUInt32LE(4 * i)
+            values[i] = type === TYPE_COUNT ? value : dictionary[value]
+        }
+        return {name: name, values: values}
+    }
+    throw new Error("unknown column type " + type + " in columnar output file")
+}
+
+/**
+ * Read a columnar output file.
+ *
+ * @param filePath
+ * @param groups the names of the groups to decode (all groups if omitted), others are skipped
+ * @param plainArrays whether to decode numbers into plain arrays (e.g., to serialize them as JSON
+ *        without a copy) rather than typed arrays
+ * @returns {Promise<Object>} an object mapping each group name to an object that maps each
+ *          column name to its values (a Float64Array, a Uint32Array, or an array of strings; or
+ *          plain arrays of numbers with plainArrays)
+ */
+async function readColumnarOutput(filePath, groups, plainArrays = false) {
+    const header = Buffer.alloc(HEADER_SIZE)
+    const fd = fs.openSync(filePath, "r")
+    try {
+        if (fs.readSync(fd, header, 0, HEADER_SIZE, 0) !== HEADER_SIZE ||
+            header.toString("latin1", 0, MAGIC.length) !== MAGIC) {
+            throw new Error(filePath + " is not a columnar output file")
+        }
+    } finally {
+        fs.closeSync(fd)
+    }
+    if (header.readUInt8(MAGIC.length) !== VERSION) {
+        throw new Error("unsupported columnar output version " + header.readUInt8(MAGIC.length))
+    }
+
+    const file = fs.createReadStream(filePath, {start: HEADER_SIZE})
+    let stream = file
+    if (header.readUInt8(MAGIC.length + 1) & FLAG_ZLIB) {
+        stream = file.pipe(zlib.createInflate())
+        file.on("error", err => stream.destroy(err))
+    }
+    const cursor = new StreamCursor(stream)
+
+    try {
+        const result = {}
+        const numGroups = await cursor.u32()
+        for (let g = 0; g < numGroups; g++) {
+            const groupName = await cursor.string()
+            const numRows = await cursor.u32()
+            const numColumns = await cursor.u32()
+            const keep = groups === undefined || groups.includes(groupName)
+            const columns = {}
+            for (let c = 0; c < numColumns; c++) {
+                const column = await readColumn(cursor, numRows, keep, plainArrays)
+                columns[column.name] = column.values
+            }
+            if (keep) {
+                result[groupName] = columns
+            }
+        }
+        return result
+    } finally {
+        stream.destroy()
+        file.destroy()
+    }
+}
+
+module.exports = {
+    readColumnarOutput
+}
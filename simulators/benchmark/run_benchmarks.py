@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020. The WRENCH Team.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Scaling benchmark of the simulators: runs each simulator over a ladder of values of its
+# natural size parameter, and records the wall time, the peak RSS and the number of simulated
+# events per second of each run (the latter from the EDUWRENCH_PROFILE summary line printed by
+# the simulators). The results can be saved as a baseline, and compared to a baseline.
+#
+# Usage:
+#   ./run_benchmarks.py                                   # run everything, write benchmark_results.json
+#   ./run_benchmarks.py --only io_operations thrustd      # run some simulators only
+#   ./run_benchmarks.py --save-baseline baseline.json     # run, and store the results as the baseline
+#   ./run_benchmarks.py --baseline baseline.json          # run, and report regressions (exit status 1)
+#   ./run_benchmarks.py --concurrency 32                  # run 32 copies of each point at the same time
+#
+
+import argparse
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+PROFILE_PREFIX = "EDUWRENCH_PROFILE "
+
+SIMULATORS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def thrustd_args(num_hosts, output_dir):
+    """thrustd takes a JSON file, with the hosts of a single group (pstate 0 only)"""
+    args = {
+        "num_hosts": num_hosts,
+        "cores": 8,
+        "workflow_file": os.path.join(SIMULATORS_DIR, "thrustd", "workflows", "bigger-montage-workflow.json"),
+        "speed": "43Gf",
+        "value": "98:98:190",
+        "pstate": 0,
+        "min_cores_per_task": 4,
+        "max_cores_per_task": 4,
+        "energy_cost_per_mwh": 1000,
+        "energy_co2_per_mwh": 291000,
+        "use_cloud": False,
+        "num_cloud_hosts": 0,
+        "cloud_cores": 0,
+        "cloud_bandwidth": "15MBps",
+        "cloud_pstate": 0,
+        "cloud_speed": "",
+        "cloud_value": "",
+        "cloud_cost_per_mwh": 0,
+        "num_vm_instances": 0,
+        "vm_usage_duration": 0,
+        "cloud_tasks": ""
+    }
+    args_file = os.path.join(output_dir, "args.json")
+    with open(args_file, "w") as f:
+        json.dump(args, f, indent=2)
+    return [args_file]
+
+
+# simulator name -> (executable, size parameter, scale ladder, function(value, output_dir) -> arguments)
+BENCHMARKS = {
+    "networking_fundamentals": (
+        "networking_fundamentals/networking_fundamentals_simulator", "num_files", [1, 10, 50, 100],
+        lambda n, _: ["100"] * n),
+    "io_operations": (
+        "io_operations/io_simulator", "num_tasks", [1, 10, 100, 1000],
+        lambda n, _: ["100", "100", str(n), "100", "true"]),
+    "multi_core_computing_independent_tasks": (
+        "multi_core_computing_independent_tasks/multi_core_simulator", "num_tasks", [10, 100, 1000, 10000],
+        lambda n, _: ["100", str(n), "100", "0"]),
+    "multi_core_computing_data_parallelism": (
+        "multi_core_computing_data_parallelism/multi_core_simulator", "num_cores", [1, 10, 100, 1000],
+        lambda n, _: [str(n), "100"]),
+    "multi_core_computing_dependent_tasks": (
+        "multi_core_computing_dependent_tasks/multi_core_simulator", "num_cores", [1, 10, 100, 1000],
+        lambda n, _: [str(n), "100", "stats"]),
+    "multi_core_computing_two_tasks_with_io": (
+        "multi_core_computing_two_tasks_with_io/multi_core_io_simulator", "task_gflop", [10, 100, 1000],
+        lambda n, _: ["100", "100", str(n), "100", "100", str(n), "true"]),
+    "client_server": (
+        "client_server/client_server_simulator", "file_size", [1, 100, 10000],
+        lambda n, _: ["10", "100", "100", "100000", "1", "0", "50", str(n)]),
+    "ci_overhead": (
+        "ci_overhead/ci_overhead_simulator", "file_size", [1, 100, 10000],
+        lambda n, _: ["10", "100", "100", "100000", "1", "0", "50", str(n), "5", "5", "100"]),
+    "storage_interaction_data_movement": (
+        "storage_interaction_data_movement/storage_simulator", "file_size", [1, 100, 10000],
+        lambda n, _: ["100", str(n), "0"]),
+    "storage_network_proximity": (
+        "storage_network_proximity/storage_network_proximity", "file_size", [1, 100, 10000],
+        lambda n, _: [str(n), "100", "10", "100", "10", "100", "10"]),
+    "workflow_fundamentals": (
+        "workflow_fundamentals/workflow_fundamentals_simulator", "num_cores", [1, 10, 100],
+        lambda n, _: [str(n), "100"]),
+    "workflow_distributed": (
+        "workflow_distributed/workflow_distributed_simulator", "num_hosts", [1, 4, 16, 64, 256],
+        lambda n, _: [str(n), "4", "100", "0"]),
+    "workflow_task_data_parallelism": (
+        "workflow_task_data_parallelism/workflow_task_data_parallelism_simulator", "num_cores", [1, 10, 100],
+        lambda n, _: [str(n), str(n), str(n)]),
+    "master_worker": (
+        "master_worker/master_worker_simulator", "num_invocations", [1, 5, 10, 30],
+        lambda n, _: ["--generate", "20", "100", "1000", "100", "1000", "80", "100", "10000", "100", "10000", "0", "0",
+                      "--ts", "0", "--cs", "0", "--inv", str(n), "--seed", "12345"]),
+    "thrustd": (
+        "thrustd/thrustd", "num_hosts", [1, 4, 16, 64],
+        thrustd_args),
+}
+
+
+def parse_profile_lines(stderr):
+    """Extract the EDUWRENCH_PROFILE summaries (one per process, e.g., several for master_worker)"""
+    summaries = []
+    for line in stderr.splitlines():
+        if line.startswith(PROFILE_PREFIX):
+            summaries.append(json.loads(line[len(PROFILE_PREFIX):]))
+    return summaries
+
+
+def run_once(executable, make_args, value, concurrency, timeout):
+    """Run `concurrency` copies of one point at the same time, return the measurements"""
+    env = dict(os.environ, EDUWRENCH_PROFILE="1")
+    runs = []
+    start = time.monotonic()
+    for _ in range(concurrency):
+        output_dir = tempfile.mkdtemp(prefix="eduwrench_benchmark_")
+        command = [executable] + make_args(value, output_dir) + ["--output-dir=" + output_dir]
+        stderr_file = tempfile.TemporaryFile(mode="w+")
+        process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=stderr_file, env=env)
+        runs.append({"process": process, "output_dir": output_dir, "stderr": stderr_file, "start": time.monotonic()})
+
+    # wait for all the copies, noting when each one ends
+    deadline = start + timeout
+    pending = list(runs)
+    while pending:
+        for run in list(pending):
+            pid, wait_status, rusage = os.wait4(run["process"].pid, os.WNOHANG)
+            if pid != 0:
+                run["status"] = os.waitstatus_to_exitcode(wait_status)
+            elif time.monotonic() > deadline:
+                run["process"].kill()
+                pid, wait_status, rusage = os.wait4(run["process"].pid, 0)
+                run["status"] = "timeout"
+            else:
+                continue
+            run["process"].returncode = run["status"]
+            run["rusage"] = rusage
+            run["wall_time"] = time.monotonic() - run["start"]
+            pending.remove(run)
+        if pending:
+            time.sleep(0.01)
+    makespan = time.monotonic() - start
+
+    results = []
+    for run in runs:
+        run["stderr"].seek(0)
+        summaries = parse_profile_lines(run["stderr"].read())
+        run["stderr"].close()
+        shutil.rmtree(run["output_dir"], ignore_errors=True)
+
+        simulated_events = sum(s["simulated_events"] for s in summaries)
+        simulation_time = sum(p["wall_time"] for s in summaries for p in s["phases"] if p["name"] == "simulation")
+        results.append({
+            "exit_status": run["status"],
+            "wall_time": run["wall_time"],
+            # ru_maxrss covers the process and its waited-for children, in KB on Linux
+            "peak_rss_kb": max([run["rusage"].ru_maxrss] + [p["peak_rss_kb"] for s in summaries for p in s["phases"]]),
+            "simulated_events": simulated_events,
+            "events_per_second": simulated_events / simulation_time if simulation_time > 0 else None,
+            "phases": summaries[-1]["phases"] if summaries else [],
+        })
+
+    failed = [r["exit_status"] for r in results if r["exit_status"] != 0]
+    return {
+        "exit_status": failed[0] if failed else 0,
+        "wall_time": sum(r["wall_time"] for r in results) / len(results),
+        "max_wall_time": max(r["wall_time"] for r in results),
+        "makespan": makespan,
+        "peak_rss_kb": max(r["peak_rss_kb"] for r in results),
+        "total_peak_rss_kb": sum(r["peak_rss_kb"] for r in results),
+        "simulated_events": results[0]["simulated_events"],
+        "events_per_second": results[0]["events_per_second"],
+        "phases": results[0]["phases"],
+    }
+
+
+def run_benchmarks(names, repeat, concurrency, timeout):
+    results = []
+    for name in names:
+        executable, parameter, ladder, make_args = BENCHMARKS[name]
+        executable = os.path.join(SIMULATORS_DIR, executable)
+        if not os.access(executable, os.X_OK):
+            print("{:<45} skipped (no executable {})".format(name, executable), file=sys.stderr)
+            continue
+        for value in ladder:
+            # keep the fastest of the repetitions, to filter out noise
+            best = None
+            for _ in range(repeat):
+                measurement = run_once(executable, make_args, value, concurrency, timeout)
+                if best is None or measurement["wall_time"] < best["wall_time"]:
+                    best = measurement
+            result = {"simulator": name, "parameter": parameter, "value": value, "concurrency": concurrency}
+            result.update(best)
+            results.append(result)
+            print("{:<45} {:>16}={:<8} {:>10.3f} s {:>10d} KB {:>14} events/s{}".format(
+                name, parameter, value, result["wall_time"], result["peak_rss_kb"],
+                "-" if result["events_per_second"] is None else "{:.0f}".format(result["events_per_second"]),
+                "" if result["exit_status"] == 0 else "  FAILED ({})".format(result["exit_status"])),
+                file=sys.stderr)
+    return results
+
+
+def compare(results, baseline, tolerance):
+    """Return the list of regressions (wall time or peak RSS above the baseline by more than the tolerance)"""
+    reference = {(r["simulator"], r["value"], r["concurrency"]): r for r in baseline["results"]}
+    regressions = []
+    for result in results:
+        base = reference.get((result["simulator"], result["value"], result["concurrency"]))
+        if base is None:
+            continue
+        if result["exit_status"] != 0 and base["exit_status"] == 0:
+            regressions.append((result, "exit_status", base["exit_status"], result["exit_status"]))
+            continue
+        for metric in ("wall_time", "peak_rss_kb"):
+            if result[metric] > base[metric] * (1 + tolerance):
+                regressions.append((result, metric, base[metric], result[metric]))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Scaling benchmark of the eduWRENCH simulators")
+    parser.add_argument("--only", nargs="+", choices=sorted(BENCHMARKS), help="the simulators to benchmark")
+    parser.add_argument("--output", default="benchmark_results.json", help="the results file")
+    parser.add_argument("--baseline", help="a baseline results file to compare against")
+    parser.add_argument("--save-baseline", help="also write the results to this baseline file")
+    parser.add_argument("--tolerance", type=float, default=0.2,
+                        help="the relative increase over the baseline that is reported as a regression")
+    parser.add_argument("--repeat", type=int, default=3, help="the number of repetitions of each point")
+    parser.add_argument("--concurrency", type=int, default=1,
+                        help="the number of copies of each point run at the same time")
+    parser.add_argument("--timeout", type=float, default=600, help="the time limit of each point, in seconds")
+    args = parser.parse_args()
+
+    if args.repeat < 1 or args.concurrency < 1:
+        parser.error("--repeat and --concurrency must be at least 1")
+
+    results = run_benchmarks(args.only or list(BENCHMARKS), args.repeat, args.concurrency, args.timeout)
+    document = {
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "host": platform.node(),
+        "cpu_count": os.cpu_count(),
+        "results": results,
+    }
+    for path in filter(None, [args.output, args.save_baseline]):
+        with open(path, "w") as f:
+            json.dump(document, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(results, baseline, args.tolerance)
+        for result, metric, before, after in regressions:
+            print("REGRESSION {} {}={}: {} {} -> {}".format(
+                result["simulator"], result["parameter"], result["value"], metric, before, after), file=sys.stderr)
+        if regressions:
+            sys.exit(1)
+        print("No regression against " + args.baseline, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
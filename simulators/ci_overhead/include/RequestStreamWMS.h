@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef REQUEST_STREAM_WMS_H
+#define REQUEST_STREAM_WMS_H
+
+#include <deque>
+#include <wrench-dev.h>
+
+namespace wrench {
+
+    class Simulation;
+
+    /**
+     * @brief A request of the stream: a task that reads its input file from the client, arriving at a given date
+     *        (its completion date is that of its failure if it failed)
+     */
+    struct Request {
+        WorkflowTask *task;
+        WorkflowFile *file;
+        double arrival_date;
+        double completion_date;
+        bool cold_start;
+        bool failed;
+    };
+
+    class RequestStreamWMS : public WMS {
+    public:
+        RequestStreamWMS(const std::shared_ptr<ComputeService> &cold_compute_service,
+                         const std::shared_ptr<ComputeService> &warm_compute_service,
+                         const std::shared_ptr<StorageService> &client_storage_service,
+                         const std::string &hostname, const std::vector<Request> &requests,
+                         unsigned long max_num_containers, double keep_alive);
+
+        const std::vector<Request> &getRequests();
+        unsigned long getNumContainers();
+
+    private:
+        /** @brief A container: busy running a request, or idle (warm) since a date */
+        struct Container {
+            bool busy;
+            double idle_date;
+        };
+
+        int main() override;
+
+        void processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) override;
+        void processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> event) override;
+        void processEventTimer(std::shared_ptr<TimerEvent> event) override;
+
+        void startRequests();
+
+        std::shared_ptr<JobManager> job_manager;
+        std::shared_ptr<ComputeService> cold_compute_service;
+        std::shared_ptr<ComputeService> warm_compute_service;
+        std::shared_ptr<StorageService> client_storage_service;
+
+        /** @brief The requests, in arrival order, the number of those that have arrived and completed, and
+         *         those waiting for a container */
+        std::vector<Request> requests;
+        unsigned long num_arrived;
+        unsigned long num_completed;
+        std::deque<unsigned long> queue;
+        /** @brief The date of the last timer set (-1 if none), so that each arrival date gets a single timer */
+        double timer_date;
+
+        /** @brief The containers alive (busy, or idle for at most the keep-alive), by ID */
+        std::map<unsigned long, Container> containers;
+        std::map<WorkflowTask *, std::pair<unsigned long, unsigned long>> task_requests;
+        unsigned long max_num_containers;
+        double keep_alive;
+        unsigned long num_containers;
+    };
+};
+
+#endif
@@ -8,6 +8,7 @@
  */
 
 #include "ActivityWMS.h"
+#include "EventLog.h"
 #include <memory>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms, "Log category for Simple WMS");
@@ -41,6 +42,8 @@ namespace wrench {
     int ActivityWMS::main() {
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_MAGENTA);
 
+        EventLog::record("wms_start");
+
         // Create a job manager
         auto job_manager = this->createJobManager();
         auto data_manager = this->createDataMovementManager();
@@ -63,16 +66,22 @@ namespace wrench {
         //  Copy the file over to the server
         WRENCH_INFO("Sending the image file over to the server running on host %s",
                     server_storage_service->getHostname().c_str());
+        EventLog::record("file_copy_start", {{"file", file->getID()},
+                                             {"src",  client_storage_service->getHostname()},
+                                             {"dst",  server_storage_service->getHostname()}});
         data_manager->doSynchronousFileCopy(file,
                                             FileLocation::LOCATION(client_storage_service),
-                                            FileLocation::LOCATION(server_storage_service));WRENCH_INFO(
-                "File sent, server can start computing");
+                                            FileLocation::LOCATION(server_storage_service));
+        EventLog::record("file_copy_completion", {{"file", file->getID()}});
+        WRENCH_INFO("File sent, server can start computing");
 
         // Run the task
         std::map<WorkflowFile *, std::shared_ptr<FileLocation>> file_locations;
         file_locations[file] = FileLocation::LOCATION(server_storage_service);
         auto job = job_manager->createStandardJob(task, file_locations);
         job_manager->submitJob(job, compute_service, {});
+        EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                            {"compute_service", compute_service->getHostname()}});
 
         // Wait for a workflow execution event, and process it
         try {
@@ -82,6 +91,8 @@ namespace wrench {
                     (e.getCause()->toString().c_str()));
         }
 
+        EventLog::record("wms_end");
+
         return 0;
     }
 
@@ -91,6 +102,7 @@ namespace wrench {
      */
     void ActivityWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) {
         auto standard_job = event->standard_job;
+        EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(standard_job->getTasks())}});
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);WRENCH_INFO(
                 "Server has completed the task!");
     }
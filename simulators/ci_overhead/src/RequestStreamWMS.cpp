@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "RequestStreamWMS.h"
+#include "EventLog.h"
+#include <memory>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(request_stream_wms, "Log category for Request Stream WMS");
+
+namespace wrench {
+
+    /**
+     * @brief WMS constructor
+     * @param cold_compute_service: the compute service that runs the requests of new containers (with the
+     *        startup overhead)
+     * @param warm_compute_service: the compute service that runs the requests of warm containers (without the
+     *        startup overhead), on the same server
+     * @param client_storage_service: the storage service that holds the input files of the requests
+     * @param hostname: the host on which the WMS runs
+     * @param requests: the requests, in arrival order
+     * @param max_num_containers: the maximum number of containers alive at a time (at most the server's cores)
+     * @param keep_alive: the time an idle container stays warm, in seconds
+     */
+    RequestStreamWMS::RequestStreamWMS(
+            const std::shared_ptr<ComputeService> &cold_compute_service,
+            const std::shared_ptr<ComputeService> &warm_compute_service,
+            const std::shared_ptr<StorageService> &client_storage_service,
+            const std::string &hostname, const std::vector<Request> &requests,
+            unsigned long max_num_containers, double keep_alive) : WMS(
+            nullptr,
+            nullptr,
+            {cold_compute_service, warm_compute_service},
+            {client_storage_service},
+            {}, nullptr,
+            hostname,
+            "ci_overhead"
+    ), cold_compute_service(cold_compute_service), warm_compute_service(warm_compute_service),
+       client_storage_service(client_storage_service), requests(requests), num_arrived(0), num_completed(0),
+       timer_date(-1), max_num_containers(max_num_containers), keep_alive(keep_alive), num_containers(0) {}
+
+    /**
+     * @brief Get the requests, with their completion dates and start types once the simulation has completed
+     * @return the requests
+     */
+    const std::vector<Request> &RequestStreamWMS::getRequests() {
+        return this->requests;
+    }
+
+    /**
+     * @brief Get the number of containers started (cold starts)
+     * @return a number of containers
+     */
+    unsigned long RequestStreamWMS::getNumContainers() {
+        return this->num_containers;
+    }
+
+    /**
+     * @brief WMS main method: start the requests as they arrive, until they have all completed
+     * @return 0
+     */
+    int RequestStreamWMS::main() {
+        TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_MAGENTA);
+
+        EventLog::record("wms_start");
+
+        this->job_manager = this->createJobManager();
+
+        startRequests();
+        while (this->num_completed < this->requests.size()) {
+            try {
+                this->waitForAndProcessNextEvent();
+            } catch (WorkflowExecutionException &e) {
+                WRENCH_INFO("Error while getting next execution event (%s)... ignoring and trying again",
+                            (e.getCause()->toString().c_str()));
+            }
+        }
+
+        EventLog::record("wms_end");
+
+        return 0;
+    }
+
+    /**
+     * @brief Queue the requests that have arrived, start the queued requests in the most recently used warm
+     *        containers, or in new containers while there is room for them, and set a timer for the arrival of
+     *        the next request
+     */
+    void RequestStreamWMS::startRequests() {
+        double now = Simulation::getCurrentSimulatedDate();
+        while ((this->num_arrived < this->requests.size()) and
+               (this->requests[this->num_arrived].arrival_date <= now)) {
+            this->queue.push_back(this->num_arrived++);
+        }
+
+        // idle containers past their keep-alive are gone
+        for (auto it = this->containers.begin(); it != this->containers.end();) {
+            if ((not it->second.busy) and (now - it->second.idle_date > this->keep_alive)) {
+                it = this->containers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        while (not this->queue.empty()) {
+            long selected = -1;
+            for (auto const &container : this->containers) {
+                if ((not container.second.busy) and
+                    ((selected == -1) or (container.second.idle_date > this->containers[selected].idle_date))) {
+                    selected = (long) container.first;
+                }
+            }
+            bool cold_start = (selected == -1);
+            if (cold_start) {
+                if (this->containers.size() >= this->max_num_containers) {
+                    break;
+                }
+                selected = (long) this->num_containers++;
+            }
+            this->containers[selected].busy = true;
+
+            auto &request = this->requests[this->queue.front()];
+            request.cold_start = cold_start;
+            auto compute_service = cold_start ? this->cold_compute_service : this->warm_compute_service;
+            std::map<WorkflowFile *, std::shared_ptr<FileLocation>> file_locations;
+            file_locations[request.file] = FileLocation::LOCATION(this->client_storage_service);
+            auto job = this->job_manager->createStandardJob(request.task, file_locations);
+            this->job_manager->submitJob(job, compute_service, {});
+            this->task_requests[request.task] = {this->queue.front(), selected};
+            EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                {"compute_service", compute_service->getHostname()},
+                                                {"cold_start",      cold_start}});
+            this->queue.pop_front();
+        }
+
+        // a timer already set for the next arrival date is still pending (completions and failures also
+        // get here), whereas one set for an earlier date has gone off, since all requests up to it arrived
+        if ((this->num_arrived < this->requests.size()) and
+            (this->requests[this->num_arrived].arrival_date != this->timer_date)) {
+            this->timer_date = this->requests[this->num_arrived].arrival_date;
+            this->setTimer(this->timer_date, "start_requests");
+        }
+    }
+
+    /**
+     * @brief Record the completion of a request, whose container becomes idle (warm)
+     * @param event: the job completion event
+     */
+    void RequestStreamWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) {
+        auto standard_job = event->standard_job;
+        EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(standard_job->getTasks())}});
+        for (auto const &task : standard_job->getTasks()) {
+            auto request_container = this->task_requests[task];
+            this->requests[request_container.first].completion_date = Simulation::getCurrentSimulatedDate();
+            this->containers[request_container.second] = {false, Simulation::getCurrentSimulatedDate()};
+            this->num_completed++;
+        }
+        startRequests();
+    }
+
+    /**
+     * @brief Record the failure of a request, whose container is discarded (the next request it would have
+     *        run starts in another container)
+     * @param event: the job failure event
+     */
+    void RequestStreamWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> event) {
+        auto standard_job = event->standard_job;
+        EventLog::record("job_failure", {{"tasks", EventLog::taskIDs(standard_job->getTasks())},
+                                         {"cause", event->failure_cause->toString()}});
+        for (auto const &task : standard_job->getTasks()) {
+            WRENCH_INFO("Request %s failed (%s)", task->getID().c_str(), event->failure_cause->toString().c_str());
+            auto request_container = this->task_requests[task];
+            this->requests[request_container.first].completion_date = Simulation::getCurrentSimulatedDate();
+            this->requests[request_container.first].failed = true;
+            this->containers.erase(request_container.second);
+            this->num_completed++;
+        }
+        startRequests();
+    }
+
+    /**
+     * @brief Start the requests that have arrived
+     * @param event: the timer event
+     */
+    void RequestStreamWMS::processEventTimer(std::shared_ptr<TimerEvent> event) {
+        startRequests();
+    }
+}
@@ -11,12 +11,23 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
 
 #include <simgrid/s4u.hpp>
 #include <wrench.h>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
+#include "AnalyticalEstimator.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
+#include "Statistics.h"
+#include "RequestStreamWMS.h"
 
 /**
  * @brief Generates an independent-task Workflow
@@ -46,19 +57,19 @@ void generateWorkflow(wrench::Workflow *workflow,
 }
 
 /**
- * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
+ * @brief Generates a platform with a client and two servers
+ * @param link_1_latency: latency of the link to server 1 in us
+ * @param link_1_bandwidth: effective bandwidth of the link to server 1 in MBps
+ * @param link_2_bandwidth: effective bandwidth of the link to server 2 in MBps
+ * @param disk_toggle: whether the client disk speed is bounded (1) or not (0)
+ * @param disk_speed: client disk speed in MBps
+ * @param server_cores: number of cores of each server
+ * @return the platform description
  *
  * @throws std::invalid_argumemnt
  */
-void generatePlatform(const std::string &platform_file_path,
-                      int link_1_latency,
-                      int link_1_bandwidth,
-                      int link_2_bandwidth,
-                      int disk_toggle, int disk_speed) {
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
+PlatformBuilder::Zone generatePlatform(int link_1_latency, int link_1_bandwidth, int link_2_bandwidth,
+                                       int disk_toggle, int disk_speed, int server_cores = 1) {
     if (link_1_bandwidth < 1) {
         throw std::invalid_argument("generatePlatform() bandwidth must be greater than 1");
     }
@@ -69,80 +80,292 @@ void generatePlatform(const std::string &platform_file_path,
         throw std::invalid_argument("generatePlatform() disk_speed must be greater than 0");
     }
 
-    // Create a the platform file
-    std::string xml_string = "<?xml version='1.0'?>\n"
-                             "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                             "<platform version=\"4.1\">\n"
-                             "   <zone id=\"AS0\" routing=\"Full\">\n"
-                             "       <host id=\"client\" speed=\"100Gf\" core=\"1000\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <host id=\"server2\" speed=\"60Gf\" core=\"1\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk1\" read_bw=\"100000TBps\" write_bw=\"100000TBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <host id=\"server1\" speed=\"100Gf\" core=\"1\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk2\" read_bw=\"100000TBps\" write_bw=\"100000TBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <!-- effective bandwidth = 10 MBps-->"
-                             "       <link id=\"link1\" bandwidth=\"10.309MBps\" latency=\"10us\"/>\n"
-                             "       <link id=\"link2\" bandwidth=\"103.09MBps\" latency=\"10us\"/>\n"
-                             "       <link id=\"loopback\" bandwidth=\"100000TBps\" latency=\"0us\"/>\n"
-                             "       <route src=\"client\" dst=\"server1\">"
-                             "           <link_ctn id=\"link1\"/>"
-                             "       </route>"
-                             "       <route src=\"client\" dst=\"server2\">"
-                             "           <link_ctn id=\"link2\"/>"
-                             "       </route>"
-                             "       <route src=\"server1\" dst=\"server1\">"
-                             "           <link_ctn id=\"loopback\"/>"
-                             "       </route>"
-                             "       <route src=\"server2\" dst=\"server2\">"
-                             "           <link_ctn id=\"loopback\"/>"
-                             "       </route>"
-                             "   </zone>\n"
-                             "</platform>\n";
-
-    pugi::xml_document xml_doc;
-
-    if (xml_doc.load_string(xml_string.c_str(), pugi::parse_doctype)) {
-        pugi::xml_node link1 = xml_doc.child("platform").child("zone").child("link");
-        pugi::xml_node link2 = xml_doc.child("platform").child("zone").child("link").next_sibling("link");
-        pugi::xml_node disk0 = xml_doc.child("platform").child("zone").child("host").child("disk");
-
-        // entering (effective_bandwidth / 0.97) as bandwidth into the simulation
-        // so that the max bandwidth we can achieve is the effective_bandwidth
-        double link_1_real_bandwidth = link_1_bandwidth / 0.97;
-        double link_2_real_bandwidth = link_2_bandwidth / 0.97;
-
-        link1.attribute("bandwidth").set_value(std::string(std::to_string(link_1_real_bandwidth) + "MBps").c_str());
-        link1.attribute("latency").set_value(std::string(std::to_string(link_1_latency) + "us").c_str());
-        link2.attribute("bandwidth").set_value(std::string(std::to_string(link_2_real_bandwidth) + "MBps").c_str());
-
-        if (disk_toggle == 0) {
-            disk0.attribute("read_bw").set_value(std::string(std::to_string(999999999999999999) + "MBps").c_str());
-            disk0.attribute("write_bw").set_value(std::string(std::to_string(999999999999999999) + "MBps").c_str());
-        } else {
-            disk0.attribute("read_bw").set_value(std::string(std::to_string(disk_speed) + "MBps").c_str());
-            disk0.attribute("write_bw").set_value(std::string(std::to_string(disk_speed) + "MBps").c_str());
+    std::string client_disk_bw = (disk_toggle == 0) ? std::to_string(999999999999999999) + "MBps"
+                                                    : std::to_string(disk_speed) + "MBps";
+
+    // entering (effective_bandwidth / 0.97) as bandwidth into the simulation
+    // so that the max bandwidth we can achieve is the effective_bandwidth
+    double link_1_real_bandwidth = link_1_bandwidth / 0.97;
+    double link_2_real_bandwidth = link_2_bandwidth / 0.97;
+
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("client", "100Gf", 1000)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk", client_disk_bw, client_disk_bw);
+    platform.addHost("server2", "60Gf", server_cores)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk1", "100000TBps", "100000TBps");
+    platform.addHost("server1", "100Gf", server_cores)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk2", "100000TBps", "100000TBps");
+    platform.addLink("link1", std::to_string(link_1_real_bandwidth) + "MBps", std::to_string(link_1_latency) + "us");
+    platform.addLink("link2", std::to_string(link_2_real_bandwidth) + "MBps", "10us");
+    platform.addLink("loopback", "100000TBps", "0us");
+    platform.addRoute("client", "server1", {"link1"});
+    platform.addRoute("client", "server2", {"link2"});
+    platform.addRoute("server1", "server1", {"loopback"});
+    platform.addRoute("server2", "server2", {"loopback"});
+    return platform;
+}
+
+/**
+ * @brief Closed-form estimate of the simulation (see AnalyticalEstimator): the file copy from the
+ *        client to the selected server, then the task, with the control messages over the link
+ *        to that server
+ *
+ * @param args: the positional command-line arguments
+ * @param estimate: the estimated dates of the end of the file copy, of the task and of the simulation
+ * @return false if the arguments are outside the range the estimate covers
+ */
+bool estimateSimulation(const std::vector<std::string> &args, nlohmann::json &estimate) {
+
+    const double MB = 1000.0 * 1000.0;
+    const double GFLOP = 1000.0 * 1000.0 * 1000.0;
+    const double SERVER_DISK_BANDWIDTH = 100000.0 * MB * MB; // 100000TBps
+    // file copy request and answer, and file read request and answer between the storage services
+    const int FILE_COPY_CONTROL_MESSAGES = 4;
+    // task completion notification from the server to the compute service on the client
+    const int TASK_CONTROL_MESSAGES = 1;
+
+    if (args.size() != 11) {
+        return false;
+    }
+    int link_1_latency = std::stoi(args[0]);
+    int link_1_bandwidth = std::stoi(args[1]);
+    int link_2_bandwidth = std::stoi(args[2]);
+    int buffer_size = std::stoi(args[3]);
+    int host_select = std::stoi(args[4]);
+    int disk_toggle = std::stoi(args[5]);
+    int disk_speed = std::stoi(args[6]);
+    int file_size = std::stoi(args[7]);
+    double server_1_overhead = std::stod(args[8]);
+    double server_2_overhead = std::stod(args[9]);
+    int task_work = std::stoi(args[10]);
+
+    if ((link_1_latency < 1) || (link_1_latency > 1000000) ||
+        (link_1_bandwidth < 1) || (link_1_bandwidth > 10000) ||
+        (link_2_bandwidth < 1) || (link_2_bandwidth > 10000) ||
+        (buffer_size < 1) || (buffer_size > 1000000000) ||
+        ((host_select != 1) && (host_select != 2)) ||
+        ((disk_toggle != 0) && (disk_toggle != 1)) ||
+        (disk_speed < 1) || (disk_speed > 100000) ||
+        (file_size < 1) || (file_size > 10000) ||
+        (server_1_overhead < 0) || (server_2_overhead < 0) || (task_work < 0)) {
+        return false;
+    }
+
+    // the platform of generatePlatform()
+    double latency = ((host_select == 1) ? link_1_latency : 10) / (1000.0 * 1000.0);
+    double bandwidth = ((host_select == 1) ? link_1_bandwidth : link_2_bandwidth) / 0.97 * MB;
+    double client_disk_bandwidth = (disk_toggle == 0) ? 999999999999999999.0 * MB : disk_speed * MB;
+    double server_speed = ((host_select == 1) ? 100 : 60) * GFLOP;
+    double buffer = (disk_toggle == 0) ? std::numeric_limits<double>::infinity() : buffer_size;
+
+    double copy_time;
+    if (not AnalyticalEstimator::fileCopyTime(file_size * MB, buffer, client_disk_bandwidth, bandwidth, latency,
+                                              SERVER_DISK_BANDWIDTH, copy_time)) {
+        return false;
+    }
+    double control_message_time = AnalyticalEstimator::messageTime(AnalyticalEstimator::CONTROL_MESSAGE_SIZE,
+                                                                   bandwidth, latency);
+
+    double file_copy_end = FILE_COPY_CONTROL_MESSAGES * control_message_time + copy_time;
+    double task_end = file_copy_end + ((host_select == 1) ? server_1_overhead : server_2_overhead) + task_work * GFLOP / server_speed;
+    estimate["file_copy_end"] = file_copy_end;
+    estimate["task_end"] = task_end;
+    estimate["makespan"] = task_end + TASK_CONTROL_MESSAGES * control_message_time;
+    return true;
+}
+
+/**
+ * @brief The parameter sets on which the estimate is checked against the simulation (--self-check)
+ * @return a list of positional command-line arguments
+ */
+std::vector<std::vector<std::string>> selfCheckGrid() {
+    // latency (us), link bandwidth (MBps), buffer size (bytes), file size (MB)
+    const std::vector<std::vector<std::string>> LINKS = {{"10",     "100",  "1000000000", "100"},
+                                                         {"1000",   "10",   "1000000",    "10"},
+                                                         {"100000", "1000", "10000000",   "1000"}};
+    std::vector<std::vector<std::string>> grid;
+    for (auto const &link : LINKS) {
+        for (auto const &host_select : {"1", "2"}) {
+            for (auto const &disk_toggle : {"0", "1"}) {
+                grid.push_back({link[0], link[1], link[1], link[2], host_select, disk_toggle, "50", link[3], "1", "5", "100"});
+            }
         }
+    }
+    return grid;
+}
 
-        xml_doc.save_file(platform_file_path.c_str());
+/**
+ * @brief Read request arrival dates, one date (in seconds) per line, in increasing order (empty lines and lines
+ *        starting with # are ignored)
+ * @param path: the file path
+ * @return the arrival dates
+ *
+ * @throws std::invalid_argument
+ */
+std::vector<double> readArrivalTrace(const std::string &path) {
+    std::ifstream file(path);
+    if (not file) {
+        throw std::invalid_argument("cannot read arrival trace " + path);
+    }
+    std::vector<double> arrival_dates;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() or (line[0] == '#')) {
+            continue;
+        }
+        double arrival_date = std::stod(line);
+        if ((arrival_date < 0) or (not arrival_dates.empty() and (arrival_date < arrival_dates.back()))) {
+            throw std::invalid_argument("invalid arrival date in arrival trace " + path + ": " + line);
+        }
+        arrival_dates.push_back(arrival_date);
+    }
+    return arrival_dates;
+}
 
-    } else {
-        throw std::runtime_error("something went wrong with parsing xml string");
+/**
+ * @brief Simulate a stream of requests to the selected server, each running the task on its input file (read from
+ *        the client) in a container: a new container pays the startup overhead of the server (cold start), and an
+ *        idle container stays warm for the keep-alive. Report the throughput, the latency percentiles and the
+ *        fraction of cold starts (also written to request_stream.json in the output directory).
+ * @param simulation: the simulation (initialized)
+ * @param platform: the platform (with servers of max_num_containers cores)
+ * @param server: the selected server
+ * @param startup_overhead: the startup overhead of the selected server, in seconds
+ * @param buffer_string: the buffer size of the client storage service
+ * @param file_size: the input file size of each request, in MB
+ * @param task_work: the task work of each request, in GFlop
+ * @param arrival_dates: the arrival dates of the requests, in increasing order
+ * @param max_num_containers: the maximum number of containers alive at a time
+ * @param keep_alive: the keep-alive of idle containers, in seconds
+ * @return the exit status
+ */
+int simulateRequestStream(wrench::Simulation &simulation, const PlatformBuilder::Zone &platform,
+                          const std::string &server, const std::string &startup_overhead,
+                          const std::string &buffer_string, int file_size, int task_work,
+                          const std::vector<double> &arrival_dates, int max_num_containers, double keep_alive) {
+
+    const double MB = 1000.0 * 1000.0;
+    const double GFLOP = 1000.0 * 1000.0 * 1000.0;
+    const std::string CLIENT("client");
+
+    wrench::Workflow workflow;
+    std::vector<wrench::Request> requests(arrival_dates.size());
+    for (unsigned long i = 0; i < arrival_dates.size(); i++) {
+        requests[i].task = workflow.addTask("request_" + std::to_string(i), task_work * GFLOP, 1, 1, 0);
+        requests[i].file = workflow.addFile("request_file_" + std::to_string(i), file_size * MB);
+        requests[i].task->addInputFile(requests[i].file);
+        requests[i].arrival_date = arrival_dates[i];
+        requests[i].completion_date = -1;
+        requests[i].cold_start = false;
+        requests[i].failed = false;
     }
+
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(platform);
+    PhaseTimer::start("platform_instantiation");
+    simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
+
+    auto client_storage_service = simulation.add(
+            new wrench::SimpleStorageService(CLIENT, {"/"},
+                                             {{wrench::SimpleStorageServiceProperty::BUFFER_SIZE, buffer_string}}));
+
+    // the cold and warm compute services share the cores of the server: the WMS never runs more requests
+    // than it has cores
+    std::shared_ptr<wrench::ComputeService> compute_services[2];
+    for (int warm = 0; warm < 2; warm++) {
+        compute_services[warm] = simulation.add(
+                new wrench::BareMetalComputeService(
+                        CLIENT,
+                        {{server, std::make_tuple(wrench::ComputeService::ALL_CORES,
+                                                  wrench::ComputeService::ALL_RAM)}},
+                        "",
+                        {
+                                {wrench::BareMetalComputeServiceProperty::TASK_STARTUP_OVERHEAD,
+                                 warm ? "0" : startup_overhead},
+                        },
+                        {}
+                )
+        );
+    }
+
+    auto wms = simulation.add(new wrench::RequestStreamWMS(compute_services[0], compute_services[1],
+                                                           client_storage_service, CLIENT, requests,
+                                                           max_num_containers, keep_alive));
+    wms->addWorkflow(&workflow);
+
+    for (auto const &request : requests) {
+        simulation.stageFile(request.file, client_storage_service);
+    }
+
+    PhaseTimer::start("simulation");
+
+    simulation.launch();
+
+    PhaseTimer::start("output");
+
+    // the latencies of the requests that did not fail
+    std::vector<double> latencies;
+    double last_completion_date = 0;
+    unsigned long num_cold_starts = 0;
+    unsigned long num_failed = 0;
+    for (auto const &request : wms->getRequests()) {
+        last_completion_date = std::max(last_completion_date, request.completion_date);
+        num_cold_starts += request.cold_start ? 1 : 0;
+        if (request.failed) {
+            num_failed++;
+        } else {
+            latencies.push_back(request.completion_date - request.arrival_date);
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double mean = 0;
+    for (auto const &latency : latencies) {
+        mean += latency / latencies.size();
+    }
+    double duration = last_completion_date - arrival_dates.front();
+    double throughput = (duration > 0) ? latencies.size() / duration : 0;
+    double cold_start_fraction = (double) num_cold_starts / requests.size();
+
+    nlohmann::json report = {{"server",              server},
+                             {"num_requests",        requests.size()},
+                             {"num_failed",          num_failed},
+                             {"max_num_containers",  max_num_containers},
+                             {"keep_alive",          keep_alive},
+                             {"num_containers",      wms->getNumContainers()},
+                             {"throughput",          throughput},
+                             {"cold_start_fraction", cold_start_fraction}};
+    if (not latencies.empty()) {
+        report["latency"] = {{"mean", mean},
+                             {"p50",  Statistics::percentile(latencies, 50)},
+                             {"p99",  Statistics::percentile(latencies, 99)},
+                             {"max",  latencies.back()}};
+    }
+    std::ofstream report_file(OutputDirectory::path("request_stream.json"));
+    report_file << report.dump() << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout.precision(4);
+    std::cout << requests.size() << " requests to " << server << " completed at time " << last_completion_date
+              << " (" << throughput << " requests/sec)" << std::endl;
+    if (num_failed > 0) {
+        std::cout << num_failed << " requests failed" << std::endl;
+    }
+    if (not latencies.empty()) {
+        std::cout << "Request latency: mean " << mean
+                  << ", p50 " << Statistics::percentile(latencies, 50)
+                  << ", p99 " << Statistics::percentile(latencies, 99)
+                  << ", max " << latencies.back() << std::endl;
+    }
+    std::cout << "Cold starts: " << num_cold_starts << " (" << (100.0 * cold_start_fraction) << "%), "
+              << "with a keep-alive of " << keep_alive << " sec and at most " << max_num_containers
+              << " containers" << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+
+    return 0;
 }
 
 /**
@@ -152,8 +375,17 @@ void generatePlatform(const std::string &platform_file_path,
  * @return
  */
 int main(int argc, char **argv) {
+    BatchMode::init(&argc, &argv, "ci_overhead");
+    // the estimate only covers a single request
+    AnalyticalEstimator::init(&argc, argv, "ci_overhead", estimateSimulation, selfCheckGrid(),
+                              {"--arrival-rate=", "--arrival-trace="});
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "ci_overhead");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "ci_overhead");
 
     const int MAX_CORES = 1000;
     int HOST_SELECT;
@@ -169,32 +401,97 @@ int main(int argc, char **argv) {
     std::string COMPUTE_2_OVERHEAD;
     int TASK_WORK_GF;
 
+    // request stream mode
+    const int MAX_NUM_REQUESTS = 100000;
+    const int MAX_NUM_CONTAINERS = 1000;
+    int NUM_REQUESTS = 100;
+    double ARRIVAL_RATE = 0;
+    std::string ARRIVAL_TRACE;
+    double KEEP_ALIVE = 60;
+    int NUM_CONTAINERS = 1;
+    unsigned long SEED = std::random_device{}();
+    std::vector<double> ARRIVAL_DATES;
+
     try {
-        if (argc != 12) {
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--arrival-rate=", 0) == 0) {
+                ARRIVAL_RATE = std::stod(arg.substr(strlen("--arrival-rate=")));
+                if (ARRIVAL_RATE <= 0) {
+                    std::cerr << "Invalid arrival rate. Rate must be positive" << std::endl;
+                    throw std::invalid_argument("invalid arrival rate");
+                }
+            } else if (arg.rfind("--arrival-trace=", 0) == 0) {
+                ARRIVAL_TRACE = arg.substr(strlen("--arrival-trace="));
+            } else if (arg.rfind("--requests=", 0) == 0) {
+                NUM_REQUESTS = std::stoi(arg.substr(strlen("--requests=")));
+            } else if (arg.rfind("--keep-alive=", 0) == 0) {
+                KEEP_ALIVE = std::stod(arg.substr(strlen("--keep-alive=")));
+            } else if (arg.rfind("--containers=", 0) == 0) {
+                NUM_CONTAINERS = std::stoi(arg.substr(strlen("--containers=")));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                SEED = std::stoul(arg.substr(strlen("--seed=")));
+            } else {
+                arguments.push_back(arg);
+            }
+        }
+
+        if (arguments.size() != 11) {
             throw std::invalid_argument("invalid number of arguments");
         }
 
-        SERVER_1_LINK_LATENCY = std::stoi(std::string(argv[1]));
+        if ((ARRIVAL_RATE > 0) and not ARRIVAL_TRACE.empty()) {
+            throw std::invalid_argument("--arrival-rate and --arrival-trace are mutually exclusive");
+        }
+        if (ARRIVAL_RATE > 0) {
+            if ((NUM_REQUESTS < 1) or (NUM_REQUESTS > MAX_NUM_REQUESTS)) {
+                std::cerr << "Invalid number of requests. Number must be in range [1," << MAX_NUM_REQUESTS << "]"
+                          << std::endl;
+                throw std::invalid_argument("invalid number of requests");
+            }
+            std::mt19937 generator(SEED);
+            std::exponential_distribution<double> interarrival_dist(ARRIVAL_RATE);
+            double arrival_date = 0;
+            for (int i = 0; i < NUM_REQUESTS; i++) {
+                arrival_date += interarrival_dist(generator);
+                ARRIVAL_DATES.push_back(arrival_date);
+            }
+        } else if (not ARRIVAL_TRACE.empty()) {
+            ARRIVAL_DATES = readArrivalTrace(ARRIVAL_TRACE);
+            if (ARRIVAL_DATES.empty() or (ARRIVAL_DATES.size() > MAX_NUM_REQUESTS)) {
+                std::cerr << "Invalid number of requests. Number must be in range [1," << MAX_NUM_REQUESTS << "]"
+                          << std::endl;
+                throw std::invalid_argument("invalid number of requests");
+            }
+        }
+        if ((KEEP_ALIVE < 0) or (NUM_CONTAINERS < 1) or (NUM_CONTAINERS > MAX_NUM_CONTAINERS)) {
+            std::cerr << "Invalid keep-alive or number of containers. Keep-alive must be positive, and the number of"
+                         " containers in range [1," << MAX_NUM_CONTAINERS << "]" << std::endl;
+            throw std::invalid_argument("invalid keep-alive or number of containers");
+        }
+
+        SERVER_1_LINK_LATENCY = std::stoi(arguments[0]);
         if (SERVER_1_LINK_LATENCY < 1 || SERVER_1_LINK_LATENCY > 1000000) {
             std::cerr << "Invalid server1 link latency. latency must be in range [1,1000000] us" << std::endl;
             throw std::invalid_argument("invalid server1 link latency");
         }
 
-        SERVER_1_LINK_BANDWIDTH = std::stoi(std::string(argv[2]));
+        SERVER_1_LINK_BANDWIDTH = std::stoi(arguments[1]);
 
         if (SERVER_1_LINK_BANDWIDTH < 1 || SERVER_1_LINK_BANDWIDTH > 10000) {
             std::cerr << "Invalid server1 link speed. Speed must be in range [1,10000] MBps" << std::endl;
             throw std::invalid_argument("invalid server1 link speed");
         }
 
-        SERVER_2_LINK_BANDWIDTH = std::stoi(std::string(argv[3]));
+        SERVER_2_LINK_BANDWIDTH = std::stoi(arguments[2]);
 
         if (SERVER_2_LINK_BANDWIDTH < 1 || SERVER_2_LINK_BANDWIDTH > 10000) {
             std::cerr << "Invalid server2 link speed. Speed must be in range [1,10000] MBps" << std::endl;
             throw std::invalid_argument("invalid server2 link speed");
         }
 
-        BUFFER_STRING = std::string(argv[4]);
+        BUFFER_STRING = arguments[3];
         BUFFER_SIZE = std::stoi(BUFFER_STRING);
 
         if (BUFFER_SIZE < 1 || BUFFER_SIZE > 1000000000) {
@@ -202,14 +499,14 @@ int main(int argc, char **argv) {
             throw std::invalid_argument("invalid buffer size");
         }
 
-        HOST_SELECT = std::stoi(std::string(argv[5]));
+        HOST_SELECT = std::stoi(arguments[4]);
 
         if (HOST_SELECT != 1 && HOST_SELECT != 2) {
             std::cerr << "Invalid host selection. Host must be either 1 or 2" << std::endl;
             throw std::invalid_argument("invalid host selection");
         }
 
-        DISK_TOGGLE = std::stoi(std::string(argv[6]));
+        DISK_TOGGLE = std::stoi(arguments[5]);
 
         if (DISK_TOGGLE != 0 && DISK_TOGGLE != 1) {
             std::cerr << "Invalid disk toggle value, should be binary." << std::endl;
@@ -220,25 +517,25 @@ int main(int argc, char **argv) {
             BUFFER_STRING = std::string("infinity");
         }
 
-        DISK_SPEED = std::stoi(std::string(argv[7]));
+        DISK_SPEED = std::stoi(arguments[6]);
 
         if (DISK_SPEED < 1 || DISK_SPEED > 100000) {
             std::cerr << "Invalid disk speed. Speed must be in range [1,10000] MBps" << std::endl;
             throw std::invalid_argument("invalid link speed");
         }
 
-        FILE_SIZE = std::stoi(std::string(argv[8]));
+        FILE_SIZE = std::stoi(arguments[7]);
 
         if (FILE_SIZE < 1 || FILE_SIZE > 10000) {
             std::cerr << "Invalid file size. Speed must be in range [1,10000] MB" << std::endl;
             throw std::invalid_argument("invalid link speed");
         }
 
-        COMPUTE_1_OVERHEAD = std::string(argv[9]);
+        COMPUTE_1_OVERHEAD = arguments[8];
 
-        COMPUTE_2_OVERHEAD = std::string(argv[10]);
+        COMPUTE_2_OVERHEAD = arguments[9];
 
-        TASK_WORK_GF = std::stoi(std::string(argv[11]));
+        TASK_WORK_GF = std::stoi(arguments[10]);
 
     } catch (std::invalid_argument &e) {
         std::cerr << e.what() << std::endl;
@@ -256,19 +553,38 @@ int main(int argc, char **argv) {
         std::cerr << "   server1_overhead: overhead in seconds " << std::endl;
         std::cerr << "   server2_overhead: overhead in seconds " << std::endl;
         std::cerr << "   task_work: task work in GFlop " << std::endl;
+        std::cerr << "   --arrival-rate=<requests/sec> [--requests=<n>] [--seed=<seed>] or --arrival-trace=<path>:"
+                     " run a stream of requests (Poisson arrivals, or one arrival date per line) on the selected server,"
+                     " in containers that only pay the server overhead when started (default: 100 requests)"
+                  << std::endl;
+        std::cerr << "   --keep-alive=<sec>: time an idle container stays warm (default: 60)" << std::endl;
+        std::cerr << "   --containers=<n>: maximum number of containers at a time, i.e., server cores (default: 1)"
+                  << std::endl;
         std::cerr << "" << std::endl;
         return 1;
     }
 
+    if (not ARRIVAL_DATES.empty()) {
+        return simulateRequestStream(simulation,
+                                     generatePlatform(SERVER_1_LINK_LATENCY, SERVER_1_LINK_BANDWIDTH,
+                                                      SERVER_2_LINK_BANDWIDTH, DISK_TOGGLE, DISK_SPEED, NUM_CONTAINERS),
+                                     (HOST_SELECT == 1) ? "server1" : "server2",
+                                     (HOST_SELECT == 1) ? COMPUTE_1_OVERHEAD : COMPUTE_2_OVERHEAD,
+                                     BUFFER_STRING, FILE_SIZE, TASK_WORK_GF, ARRIVAL_DATES, NUM_CONTAINERS, KEEP_ALIVE);
+    }
+
     // create workflow
     wrench::Workflow workflow;
     generateWorkflow(&workflow, FILE_SIZE, TASK_WORK_GF);
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, SERVER_1_LINK_LATENCY, SERVER_1_LINK_BANDWIDTH, SERVER_2_LINK_BANDWIDTH,
-                     DISK_TOGGLE, DISK_SPEED);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(
+            generatePlatform(SERVER_1_LINK_LATENCY, SERVER_1_LINK_BANDWIDTH, SERVER_2_LINK_BANDWIDTH,
+                             DISK_TOGGLE, DISK_SPEED));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     const std::string CLIENT("client");
     const std::string SERVER1("server1");
@@ -340,9 +656,21 @@ int main(int argc, char **argv) {
 
     simulation.getOutput().enableDiskTimestamps(true);
 
+    PhaseTimer::start("simulation");
+
     simulation.launch();
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", false, true, true, false, true, true);
+    PhaseTimer::start("output");
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), false, true, true, false, true, true);
+
+    }
 
     return 0;
 }
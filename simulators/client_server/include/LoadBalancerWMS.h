@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2020-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef LOAD_BALANCER_WMS_H
+#define LOAD_BALANCER_WMS_H
+
+#include <random>
+#include <wrench-dev.h>
+
+namespace wrench {
+
+    class Simulation;
+
+    /**
+     * @brief A server of the pool: its speed, link and startup overhead, its compute service, and the
+     *        load balancer's view of its load
+     */
+    struct Server {
+        std::string hostname;
+        double speed;
+        double bandwidth;
+        double latency;
+        double startup_overhead;
+        std::shared_ptr<ComputeService> compute_service;
+
+        unsigned long num_outstanding;
+        double estimated_free_date;
+        unsigned long num_requests;
+        unsigned long num_failed;
+        double busy_time;
+    };
+
+    /**
+     * @brief A client request: a task that reads its input file from the client, arriving at a given date
+     *        (its completion date is that of its failure if it failed)
+     */
+    struct Request {
+        WorkflowTask *task;
+        WorkflowFile *file;
+        double arrival_date;
+        long server;
+        double completion_date;
+        bool failed;
+    };
+
+    class LoadBalancerWMS : public WMS {
+    public:
+        LoadBalancerWMS(const std::vector<Server> &servers,
+                        const std::shared_ptr<StorageService> &client_storage_service,
+                        const std::string &hostname, const std::vector<Request> &requests,
+                        const std::string &policy, unsigned long seed);
+
+        const std::vector<Server> &getServers();
+        const std::vector<Request> &getRequests();
+
+    private:
+        int main() override;
+
+        void processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) override;
+        void processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> event) override;
+        void processEventTimer(std::shared_ptr<TimerEvent> event) override;
+
+        void dispatchRequests();
+        unsigned long selectServer(const Request &request);
+        double estimateCompletionDate(const Server &server, const Request &request);
+
+        std::shared_ptr<JobManager> job_manager;
+        std::shared_ptr<StorageService> client_storage_service;
+
+        std::vector<Server> servers;
+        /** @brief The requests, in arrival order, and the number of those already dispatched and completed */
+        std::vector<Request> requests;
+        unsigned long num_dispatched;
+        unsigned long num_completed;
+        std::map<WorkflowTask *, unsigned long> task_requests;
+
+        std::string policy;
+        unsigned long next_server;
+        std::mt19937 generator;
+    };
+};
+
+#endif
@@ -1,5 +1,7 @@
 
 #include "ActivityWMS.h"
+#include "AdaptiveBandwidthMeter.h"
+#include "EventLog.h"
 #include <algorithm>
 #include <memory>
 
@@ -36,6 +38,8 @@ namespace wrench {
     int ActivityWMS::main() {
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_MAGENTA);
 
+        EventLog::record("wms_start");
+
         // Create a job manager
         auto job_manager = this->createJobManager();
         auto data_manager = this->createDataMovementManager();
@@ -44,12 +48,13 @@ namespace wrench {
         // Get the compute service
         const auto compute_service = *(this->getAvailableComputeServices<ComputeService>().begin());
 
-        // Start bandwidth meters
+        // Start bandwidth meters (recording link usage only when it changes)
         const double BANDWIDTH_METER_PERIOD = 0.01;
         std::vector<std::string> linknames;
         linknames.emplace_back("link1");
         linknames.emplace_back("link2");
-        auto em = this->createBandwidthMeter(linknames, BANDWIDTH_METER_PERIOD);
+        auto bandwidth_meter = AdaptiveBandwidthMeter::start(this->simulation, this->getHostname(), linknames,
+                                                             BANDWIDTH_METER_PERIOD);
 
         std::shared_ptr<StorageService> client_storage_service, server_storage_service;
         for (const auto &ss : this->getAvailableStorageServices()) {
@@ -65,9 +70,13 @@ namespace wrench {
 
         //  Copy the file over to the server
         WRENCH_INFO("Sending the image file over to the server running on host %s", server_storage_service->getHostname().c_str());
+        EventLog::record("file_copy_start", {{"file", file->getID()},
+                                             {"src",  client_storage_service->getHostname()},
+                                             {"dst",  server_storage_service->getHostname()}});
         data_manager->doSynchronousFileCopy(file,
                                             FileLocation::LOCATION(client_storage_service),
                                             FileLocation::LOCATION(server_storage_service));
+        EventLog::record("file_copy_completion", {{"file", file->getID()}});
         WRENCH_INFO("File sent, server can start computing");
 
         // Run the task
@@ -75,6 +84,8 @@ namespace wrench {
         file_locations[file] = FileLocation::LOCATION(server_storage_service);
         auto job = job_manager->createStandardJob(task, file_locations);
         job_manager->submitJob(job, compute_service, {});
+        EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                            {"compute_service", compute_service->getHostname()}});
 
         // Wait for a workflow execution event, and process it
         try {
@@ -85,6 +96,10 @@ namespace wrench {
         }
 
 
+        bandwidth_meter->flush();
+
+        EventLog::record("wms_end");
+
         return 0;
     }
 
@@ -94,6 +109,7 @@ namespace wrench {
      */
     void ActivityWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) {
         auto standard_job = event->standard_job;
+        EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(standard_job->getTasks())}});
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);
         WRENCH_INFO("Server has completed the task!");
     }
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2020-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "LoadBalancerWMS.h"
+#include "EventLog.h"
+#include <algorithm>
+#include <memory>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(load_balancer_wms, "Log category for Load Balancer WMS");
+
+namespace wrench {
+
+    /**
+     * @brief The compute services of a pool of servers
+     * @param servers: the servers
+     * @return the compute services
+     */
+    static std::set<std::shared_ptr<ComputeService>> getComputeServices(const std::vector<Server> &servers) {
+        std::set<std::shared_ptr<ComputeService>> compute_services;
+        for (auto const &server : servers) {
+            compute_services.insert(server.compute_service);
+        }
+        return compute_services;
+    }
+
+    /**
+     * @brief WMS constructor
+     * @param servers: the servers (with their compute services)
+     * @param client_storage_service: the storage service that holds the input files of the requests
+     * @param hostname: the host on which the WMS (the load balancer) runs
+     * @param requests: the requests, in arrival order
+     * @param policy: the dispatch policy ("round-robin", "least-loaded", "earliest-completion" or "power-of-two")
+     * @param seed: the seed of the random choices of the power-of-two policy
+     */
+    LoadBalancerWMS::LoadBalancerWMS(
+            const std::vector<Server> &servers,
+            const std::shared_ptr<StorageService> &client_storage_service,
+            const std::string &hostname, const std::vector<Request> &requests,
+            const std::string &policy, unsigned long seed) : WMS(
+            nullptr,
+            nullptr,
+            getComputeServices(servers),
+            {client_storage_service},
+            {}, nullptr,
+            hostname,
+            "client_server"
+    ), client_storage_service(client_storage_service), servers(servers), requests(requests),
+       num_dispatched(0), num_completed(0), policy(policy), next_server(0), generator(seed) {}
+
+    /**
+     * @brief Get the servers, with their number of requests and busy time once the simulation has completed
+     * @return the servers
+     */
+    const std::vector<Server> &LoadBalancerWMS::getServers() {
+        return this->servers;
+    }
+
+    /**
+     * @brief Get the requests, with their servers and completion dates once the simulation has completed
+     * @return the requests
+     */
+    const std::vector<Request> &LoadBalancerWMS::getRequests() {
+        return this->requests;
+    }
+
+    /**
+     * @brief WMS main method: dispatch the requests as they arrive, until they have all completed
+     * @return 0
+     */
+    int LoadBalancerWMS::main() {
+        TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_MAGENTA);
+
+        EventLog::record("wms_start");
+
+        this->job_manager = this->createJobManager();
+
+        for (auto &server : this->servers) {
+            server.num_outstanding = 0;
+            server.estimated_free_date = 0;
+            server.num_requests = 0;
+            server.num_failed = 0;
+            server.busy_time = 0;
+        }
+
+        dispatchRequests();
+        while (this->num_completed < this->requests.size()) {
+            try {
+                this->waitForAndProcessNextEvent();
+            } catch (WorkflowExecutionException &e) {
+                WRENCH_INFO("Error while getting next execution event (%s)... ignoring and trying again",
+                            (e.getCause()->toString().c_str()));
+            }
+        }
+
+        EventLog::record("wms_end");
+
+        return 0;
+    }
+
+    /**
+     * @brief Dispatch the requests that have arrived, and set a timer for the arrival of the next one
+     */
+    void LoadBalancerWMS::dispatchRequests() {
+        double now = Simulation::getCurrentSimulatedDate();
+        while ((this->num_dispatched < this->requests.size()) and
+               (this->requests[this->num_dispatched].arrival_date <= now)) {
+            auto &request = this->requests[this->num_dispatched];
+            auto &server = this->servers[selectServer(request)];
+            request.server = &server - &this->servers[0];
+            server.estimated_free_date = estimateCompletionDate(server, request);
+            server.num_outstanding++;
+            server.num_requests++;
+
+            std::map<WorkflowFile *, std::shared_ptr<FileLocation>> file_locations;
+            file_locations[request.file] = FileLocation::LOCATION(this->client_storage_service);
+            auto job = this->job_manager->createStandardJob(request.task, file_locations);
+            this->job_manager->submitJob(job, server.compute_service, {});
+            this->task_requests[request.task] = this->num_dispatched;
+            EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                {"compute_service", server.hostname}});
+            this->num_dispatched++;
+        }
+        if (this->num_dispatched < this->requests.size()) {
+            this->setTimer(this->requests[this->num_dispatched].arrival_date, "dispatch_requests");
+        }
+    }
+
+    /**
+     * @brief Select the server of a request according to the dispatch policy
+     * @param request: the request
+     * @return the server index
+     */
+    unsigned long LoadBalancerWMS::selectServer(const Request &request) {
+        unsigned long selected = 0;
+        if (this->policy == "round-robin") {
+            selected = this->next_server;
+            this->next_server = (this->next_server + 1) % this->servers.size();
+        } else if (this->policy == "least-loaded") {
+            for (unsigned long i = 1; i < this->servers.size(); i++) {
+                if (this->servers[i].num_outstanding < this->servers[selected].num_outstanding) {
+                    selected = i;
+                }
+            }
+        } else if (this->policy == "earliest-completion") {
+            double earliest = estimateCompletionDate(this->servers[0], request);
+            for (unsigned long i = 1; i < this->servers.size(); i++) {
+                double completion_date = estimateCompletionDate(this->servers[i], request);
+                if (completion_date < earliest) {
+                    earliest = completion_date;
+                    selected = i;
+                }
+            }
+        } else {
+            // power of two choices: the least loaded of two distinct random servers
+            std::uniform_int_distribution<unsigned long> first_dist(0, this->servers.size() - 1);
+            std::uniform_int_distribution<unsigned long> second_dist(0, this->servers.size() - 2);
+            unsigned long first = first_dist(this->generator);
+            unsigned long second = second_dist(this->generator);
+            if (second >= first) {
+                second++;
+            }
+            selected = (this->servers[second].num_outstanding < this->servers[first].num_outstanding) ? second : first;
+        }
+        return selected;
+    }
+
+    /**
+     * @brief Estimate the completion date of a request on a server, from the nominal speed, link and startup
+     *        overhead of the server, once the requests dispatched to it have completed
+     * @param server: the server
+     * @param request: the request
+     * @return a date
+     */
+    double LoadBalancerWMS::estimateCompletionDate(const Server &server, const Request &request) {
+        double start_date = std::max(Simulation::getCurrentSimulatedDate(), server.estimated_free_date);
+        return start_date + server.startup_overhead + server.latency + request.file->getSize() / server.bandwidth +
+               request.task->getFlops() / server.speed;
+    }
+
+    /**
+     * @brief Record the completion of a request
+     * @param event: the job completion event
+     */
+    void LoadBalancerWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) {
+        auto standard_job = event->standard_job;
+        EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(standard_job->getTasks())}});
+        for (auto const &task : standard_job->getTasks()) {
+            auto &request = this->requests[this->task_requests[task]];
+            auto &server = this->servers[request.server];
+            request.completion_date = Simulation::getCurrentSimulatedDate();
+            server.busy_time += task->getEndDate() - task->getStartDate();
+            if (--server.num_outstanding == 0) {
+                server.estimated_free_date = request.completion_date;
+            }
+            this->num_completed++;
+        }
+    }
+
+    /**
+     * @brief Record the failure of a request, which no longer loads its server
+     * @param event: the job failure event
+     */
+    void LoadBalancerWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> event) {
+        auto standard_job = event->standard_job;
+        EventLog::record("job_failure", {{"tasks", EventLog::taskIDs(standard_job->getTasks())},
+                                         {"cause", event->failure_cause->toString()}});
+        for (auto const &task : standard_job->getTasks()) {
+            auto &request = this->requests[this->task_requests[task]];
+            auto &server = this->servers[request.server];
+            WRENCH_INFO("Request %s failed on %s (%s)", task->getID().c_str(), server.hostname.c_str(),
+                        event->failure_cause->toString().c_str());
+            request.completion_date = Simulation::getCurrentSimulatedDate();
+            request.failed = true;
+            server.num_failed++;
+            if (--server.num_outstanding == 0) {
+                server.estimated_free_date = request.completion_date;
+            }
+            this->num_completed++;
+        }
+    }
+
+    /**
+     * @brief Dispatch the requests that have arrived
+     * @param event: the timer event
+     */
+    void LoadBalancerWMS::processEventTimer(std::shared_ptr<TimerEvent> event) {
+        dispatchRequests();
+    }
+}
@@ -3,13 +3,30 @@
 #include <iomanip>
 #include <string>
 #include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <random>
+#include <set>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <simgrid/s4u.hpp>
 #include <wrench.h>
 #include <nlohmann/json.hpp>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
+#include "AnalyticalEstimator.h"
+#include "BatchMode.h"
+#include "ChildProcess.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "LoadBalancerWMS.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
+#include "Statistics.h"
 
 /**
  * @brief Generates an independent-task Workflow
@@ -39,104 +56,535 @@ void generateWorkflow(wrench::Workflow *workflow, int file_size_in_mb) {
 }
 
 /**
- * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
+ * @brief Generates a platform with a client and two servers
+ * @param link_1_latency: latency of the link to server 1 in us
+ * @param link_1_bandwidth: effective bandwidth of the link to server 1 in MBps
+ * @param link_2_bandwidth: effective bandwidth of the link to server 2 in MBps
+ * @param disk_toggle: whether the client disk speed is bounded (1) or not (0)
+ * @param disk_speed: client disk speed in MBps
+ * @return the platform description
  *
  * @throws std::invalid_argumemnt
  */
-void generatePlatform(std::string platform_file_path, int link_1_latency, int link_1_bandwidth, int  link_2_bandwidth, int disk_toggle, int disk_speed) {
-
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
-    if (link_1_bandwidth < 1 ) {
+PlatformBuilder::Zone generatePlatform(int link_1_latency, int link_1_bandwidth, int link_2_bandwidth,
+                                       int disk_toggle, int disk_speed) {
+    if (link_1_bandwidth < 1) {
         throw std::invalid_argument("generatePlatform() bandwidth must be greater than 1");
     }
-    if (disk_toggle != 0 && disk_toggle != 1 ) {
+    if (disk_toggle != 0 && disk_toggle != 1) {
         throw std::invalid_argument("generatePlatform() disk_toggle must be 1 or 0");
     }
     if (disk_speed <= 0) {
         throw std::invalid_argument("generatePlatform() disk_speed must be greater than 0");
     }
 
+    std::string client_disk_bw = (disk_toggle == 0) ? std::to_string(999999999999999999) + "MBps"
+                                                    : std::to_string(disk_speed) + "MBps";
+
+    // entering (effective_bandwidth / 0.97) as bandwidth into the simulation
+    // so that the max bandwidth we can achieve is the effective_bandwidth
+    double link_1_real_bandwidth = link_1_bandwidth / 0.97;
+    double link_2_real_bandwidth = link_2_bandwidth / 0.97;
+
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("client", "100Gf", 1000)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk", client_disk_bw, client_disk_bw);
+    platform.addHost("server2", "60Gf", 1)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk1", "100000TBps", "100000TBps");
+    platform.addHost("server1", "100Gf", 1)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk2", "100000TBps", "100000TBps");
+    platform.addLink("link1", std::to_string(link_1_real_bandwidth) + "MBps", std::to_string(link_1_latency) + "us");
+    platform.addLink("link2", std::to_string(link_2_real_bandwidth) + "MBps", "10us");
+    platform.addLink("loopback", "100000TBps", "0us");
+    platform.addRoute("client", "server1", {"link1"});
+    platform.addRoute("client", "server2", {"link2"});
+    platform.addRoute("server1", "server1", {"loopback"});
+    platform.addRoute("server2", "server2", {"loopback"});
+    return platform;
+}
+
+/**
+ * @brief Closed-form estimate of the simulation (see AnalyticalEstimator): the file copy from the
+ *        client to the selected server, then the task, with the control messages over the link
+ *        to that server
+ *
+ * @param args: the positional command-line arguments
+ * @param estimate: the estimated dates of the end of the file copy, of the task and of the simulation
+ * @return false if the arguments are outside the range the estimate covers
+ */
+bool estimateSimulation(const std::vector<std::string> &args, nlohmann::json &estimate) {
+
+    const double MB = 1000.0 * 1000.0;
+    const double GFLOP = 1000.0 * 1000.0 * 1000.0;
+    const double SERVER_DISK_BANDWIDTH = 100000.0 * MB * MB; // 100000TBps
+    // file copy request and answer, and file read request and answer between the storage services
+    const int FILE_COPY_CONTROL_MESSAGES = 4;
+    // task completion notification from the server to the compute service on the client
+    const int TASK_CONTROL_MESSAGES = 1;
+
+    if (args.size() != 8) {
+        return false;
+    }
+    int link_1_latency = std::stoi(args[0]);
+    int link_1_bandwidth = std::stoi(args[1]);
+    int link_2_bandwidth = std::stoi(args[2]);
+    int buffer_size = std::stoi(args[3]);
+    int host_select = std::stoi(args[4]);
+    int disk_toggle = std::stoi(args[5]);
+    int disk_speed = std::stoi(args[6]);
+    int file_size = std::stoi(args[7]);
+
+    if ((link_1_latency < 1) || (link_1_latency > 1000000) ||
+        (link_1_bandwidth < 1) || (link_1_bandwidth > 10000) ||
+        (link_2_bandwidth < 1) || (link_2_bandwidth > 10000) ||
+        (buffer_size < 1) || (buffer_size > 1000000000) ||
+        ((host_select != 1) && (host_select != 2)) ||
+        ((disk_toggle != 0) && (disk_toggle != 1)) ||
+        (disk_speed < 1) || (disk_speed > 100000) ||
+        (file_size < 1) || (file_size > 10000)) {
+        return false;
+    }
+
+    // the platform of generatePlatform()
+    double latency = ((host_select == 1) ? link_1_latency : 10) / (1000.0 * 1000.0);
+    double bandwidth = ((host_select == 1) ? link_1_bandwidth : link_2_bandwidth) / 0.97 * MB;
+    double client_disk_bandwidth = (disk_toggle == 0) ? 999999999999999999.0 * MB : disk_speed * MB;
+    double server_speed = ((host_select == 1) ? 100 : 60) * GFLOP;
+    double buffer = (disk_toggle == 0) ? std::numeric_limits<double>::infinity() : buffer_size;
+
+    double copy_time;
+    if (not AnalyticalEstimator::fileCopyTime(file_size * MB, buffer, client_disk_bandwidth, bandwidth, latency,
+                                              SERVER_DISK_BANDWIDTH, copy_time)) {
+        return false;
+    }
+    double control_message_time = AnalyticalEstimator::messageTime(AnalyticalEstimator::CONTROL_MESSAGE_SIZE,
+                                                                   bandwidth, latency);
+
+    double file_copy_end = FILE_COPY_CONTROL_MESSAGES * control_message_time + copy_time;
+    double task_end = file_copy_end + 1000 * GFLOP / server_speed;
+    estimate["file_copy_end"] = file_copy_end;
+    estimate["task_end"] = task_end;
+    estimate["makespan"] = task_end + TASK_CONTROL_MESSAGES * control_message_time;
+    return true;
+}
+
+/**
+ * @brief The parameter sets on which the estimate is checked against the simulation (--self-check)
+ * @return a list of positional command-line arguments
+ */
+std::vector<std::vector<std::string>> selfCheckGrid() {
+    // latency (us), link bandwidth (MBps), buffer size (bytes), file size (MB)
+    const std::vector<std::vector<std::string>> LINKS = {{"10",     "100",  "1000000000", "100"},
+                                                         {"1000",   "10",   "1000000",    "10"},
+                                                         {"100000", "1000", "10000000",   "1000"}};
+    std::vector<std::vector<std::string>> grid;
+    for (auto const &link : LINKS) {
+        for (auto const &host_select : {"1", "2"}) {
+            for (auto const &disk_toggle : {"0", "1"}) {
+                grid.push_back({link[0], link[1], link[1], link[2], host_select, disk_toggle, "50", link[3]});
+            }
+        }
+    }
+    return grid;
+}
+
+/**
+ * @brief Run the simulation for a geometric range of buffer sizes (in forked children, each with its own
+ *        output directory <output directory>/buffer_<size>), print the file copy time for each buffer size,
+ *        and the smallest buffer size whose file copy time is within a tolerance of the best one (the curve
+ *        is also written to buffer_sweep.json in the output directory)
+ *
+ *        The arguments are those of a simulation (the buffer size is ignored), with --buffer-sweep=<min>,<max>
+ *        and optionally --sweep-factor=<factor> (default: 2), --sweep-tolerance=<percent> (default: 5) and
+ *        --sweep-jobs=<n> (the number of simultaneous children, by default one per core)
+ *
+ * @param argc: the argument count
+ * @param argv: the arguments
+ * @return the exit status
+ */
+int sweepBufferSizes(int argc, char **argv) {
+
+    const int MAX_NUM_BUFFER_SIZES = 100;
+
+    std::string program(argv[0]);
+    OutputDirectory::init(&argc, argv, "client_server");
+
+    std::vector<std::string> args;
+    std::vector<std::string> extra_args;
+    std::vector<long> buffer_sizes;
+    double tolerance = 5;
+    long num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    try {
+        long min_buffer_size = 0, max_buffer_size = 0;
+        double factor = 2;
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--buffer-sweep=", 0) == 0) {
+                std::string range = arg.substr(strlen("--buffer-sweep="));
+                if (range.find(',') == std::string::npos) {
+                    throw std::invalid_argument("invalid buffer size range " + range);
+                }
+                min_buffer_size = std::stol(range.substr(0, range.find(',')));
+                max_buffer_size = std::stol(range.substr(range.find(',') + 1));
+            } else if (arg.rfind("--sweep-factor=", 0) == 0) {
+                factor = std::stod(arg.substr(strlen("--sweep-factor=")));
+            } else if (arg.rfind("--sweep-tolerance=", 0) == 0) {
+                tolerance = std::stod(arg.substr(strlen("--sweep-tolerance=")));
+            } else if (arg.rfind("--sweep-jobs=", 0) == 0) {
+                num_jobs = std::stol(arg.substr(strlen("--sweep-jobs=")));
+            } else if (arg.rfind("--", 0) == 0) {
+                extra_args.push_back(arg);
+            } else {
+                args.push_back(arg);
+            }
+        }
+
+        if (args.size() != 8) {
+            throw std::invalid_argument("invalid number of arguments");
+        }
+        if (args[5] != "1") {
+            throw std::invalid_argument("the buffer size is only used when the disk is simulated (disk toggle 1)");
+        }
+        if ((min_buffer_size < 1) or (max_buffer_size > 1000000000) or (min_buffer_size > max_buffer_size)) {
+            throw std::invalid_argument("invalid buffer size range (must be in range [1,1000000000] bytes)");
+        }
+        if ((factor <= 1) or (tolerance < 0) or (num_jobs < 1)) {
+            throw std::invalid_argument("invalid sweep factor, tolerance or number of jobs");
+        }
+        for (double buffer_size = min_buffer_size;
+             (buffer_size < max_buffer_size) and (buffer_sizes.size() <= MAX_NUM_BUFFER_SIZES);
+             buffer_size *= factor) {
+            if (buffer_sizes.empty() or ((long) buffer_size != buffer_sizes.back())) {
+                buffer_sizes.push_back((long) buffer_size);
+            }
+        }
+        buffer_sizes.push_back(max_buffer_size);
+        if (buffer_sizes.size() > MAX_NUM_BUFFER_SIZES) {
+            throw std::invalid_argument("too many buffer sizes (at most " + std::to_string(MAX_NUM_BUFFER_SIZES) + ")");
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << program << " <simulation arguments> --buffer-sweep=<min>,<max>"
+                     " [--sweep-factor=<factor>] [--sweep-tolerance=<percent>] [--sweep-jobs=<n>]" << std::endl;
+        return 1;
+    }
+
+    // run the children, num_jobs at a time
+    std::map<pid_t, unsigned long> running;
+    std::vector<int> statuses(buffer_sizes.size(), -1);
+    unsigned long next = 0;
+    auto start_next = [&]() -> pid_t {
+        if (next == buffer_sizes.size()) {
+            return -1;
+        }
+        std::vector<std::string> child_args(args);
+        child_args[3] = std::to_string(buffer_sizes[next]);
+        child_args.insert(child_args.end(), extra_args.begin(), extra_args.end());
+        child_args.emplace_back("--event-log");
+        std::string run_directory = OutputDirectory::path("buffer_" + std::to_string(buffer_sizes[next]));
+        if ((mkdir(run_directory.c_str(), 0700) != 0) and (errno != EEXIST)) {
+            throw std::runtime_error("sweepBufferSizes(): cannot create directory " + run_directory);
+        }
+        child_args.emplace_back("--output-dir=" + run_directory);
+
+        pid_t pid = ChildProcess::start(program, child_args);
+        running[pid] = next++;
+        return pid;
+    };
+    ChildProcess::runJobs(num_jobs, start_next, [&](pid_t pid, int wait_status) {
+        statuses[running.at(pid)] = ChildProcess::exitStatus(wait_status);
+    });
+
+    // the file copy time of each buffer size, from the event logs
+    nlohmann::json curve = nlohmann::json::array();
+    int status = 0;
+    long best = -1;
+    std::vector<double> copy_times(buffer_sizes.size(), -1);
+    for (unsigned long i = 0; i < buffer_sizes.size(); i++) {
+        double start = -1, end = -1;
+        std::ifstream event_log(OutputDirectory::path("buffer_" + std::to_string(buffer_sizes[i])) + "/events.jsonl");
+        std::string line;
+        while (std::getline(event_log, line)) {
+            auto event = nlohmann::json::parse(line);
+            if (event.at("event") == "file_copy_start") {
+                start = event.at("time").get<double>();
+            } else if (event.at("event") == "file_copy_completion") {
+                end = event.at("time").get<double>();
+            }
+        }
+        if ((statuses[i] != 0) or (start < 0) or (end < 0)) {
+            std::cerr << "The simulation with buffer size " << buffer_sizes[i] << " failed" << std::endl;
+            curve.push_back({{"buffer_size", buffer_sizes[i]}, {"error", "the simulation failed"}});
+            status = 1;
+            continue;
+        }
+        copy_times[i] = end - start;
+        curve.push_back({{"buffer_size", buffer_sizes[i]}, {"file_copy_time", copy_times[i]}});
+        if ((best == -1) or (copy_times[i] < copy_times[best])) {
+            best = (long) i;
+        }
+    }
 
-    // Create a the platform file
-    std::string xml_string = "<?xml version='1.0'?>\n"
-                             "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                             "<platform version=\"4.1\">\n"
-                             "   <zone id=\"AS0\" routing=\"Full\">\n"
-                             "       <host id=\"client\" speed=\"100Gf\" core=\"1000\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <host id=\"server2\" speed=\"60Gf\" core=\"1\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk1\" read_bw=\"100000TBps\" write_bw=\"100000TBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <host id=\"server1\" speed=\"100Gf\" core=\"1\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk2\" read_bw=\"100000TBps\" write_bw=\"100000TBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <!-- effective bandwidth = 10 MBps-->"
-                             "       <link id=\"link1\" bandwidth=\"10.309MBps\" latency=\"10us\"/>\n"
-                             "       <link id=\"link2\" bandwidth=\"103.09MBps\" latency=\"10us\"/>\n"
-                             "       <link id=\"loopback\" bandwidth=\"100000TBps\" latency=\"0us\"/>\n"
-                             "       <route src=\"client\" dst=\"server1\">"
-                             "           <link_ctn id=\"link1\"/>"
-                             "       </route>"
-                             "       <route src=\"client\" dst=\"server2\">"
-                             "           <link_ctn id=\"link2\"/>"
-                             "       </route>"
-                             "       <route src=\"server1\" dst=\"server1\">"
-                             "           <link_ctn id=\"loopback\"/>"
-                             "       </route>"
-                             "       <route src=\"server2\" dst=\"server2\">"
-                             "           <link_ctn id=\"loopback\"/>"
-                             "       </route>"
-                             "   </zone>\n"
-                             "</platform>\n";
-
-
-    pugi::xml_document xml_doc;
-
-    if (xml_doc.load_string(xml_string.c_str(), pugi::parse_doctype)) {
-
-        pugi::xml_node link1 = xml_doc.child("platform").child("zone").child("link");
-        pugi::xml_node link2 = xml_doc.child("platform").child("zone").child("link").next_sibling("link");
-        pugi::xml_node disk0 = xml_doc.child("platform").child("zone").child("host").child("disk");
-
-
-        // entering (effective_bandwidth / 0.97) as bandwidth into the simulation
-        // so that the max bandwidth we can achieve is the effective_bandwidth
-        double link_1_real_bandwidth = link_1_bandwidth / 0.97;
-        double link_2_real_bandwidth = link_2_bandwidth / 0.97;
-
-        link1.attribute("bandwidth").set_value(std::string(std::to_string(link_1_real_bandwidth) + "MBps").c_str());
-        link1.attribute("latency").set_value(std::string(std::to_string(link_1_latency) + "us").c_str());
-        link2.attribute("bandwidth").set_value(std::string(std::to_string(link_2_real_bandwidth) + "MBps").c_str());
-
-        if (disk_toggle == 0) {
-            disk0.attribute("read_bw").set_value(std::string(std::to_string(999999999999999999) + "MBps").c_str());
-            disk0.attribute("write_bw").set_value(std::string(std::to_string(999999999999999999) + "MBps").c_str());
+    std::cout << "----------------------------------------" << std::endl;
+    for (unsigned long i = 0; i < buffer_sizes.size(); i++) {
+        std::cout << std::setw(12) << buffer_sizes[i] << " bytes: ";
+        if (copy_times[i] < 0) {
+            std::cout << "failed" << std::endl;
         } else {
-            disk0.attribute("read_bw").set_value(std::string(std::to_string(disk_speed) + "MBps").c_str());
-            disk0.attribute("write_bw").set_value(std::string(std::to_string(disk_speed) + "MBps").c_str());
+            std::cout << std::setprecision(6) << copy_times[i] << " sec" << std::endl;
+        }
+    }
+    nlohmann::json sweep = {{"tolerance", tolerance}, {"curve", curve}};
+    if (best != -1) {
+        // the smallest buffer size within the tolerance of the best file copy time
+        unsigned long recommended = 0;
+        while ((copy_times[recommended] < 0) or
+               (copy_times[recommended] > copy_times[best] * (1 + tolerance / 100.0))) {
+            recommended++;
         }
+        sweep["best"] = curve[best];
+        sweep["recommended"] = curve[recommended];
+        std::cout << "Best buffer size: " << buffer_sizes[best] << " bytes (" << copy_times[best] << " sec)" << std::endl;
+        std::cout << "Smallest buffer size within " << tolerance << "% of the best: " << buffer_sizes[recommended]
+                  << " bytes (" << copy_times[recommended] << " sec)" << std::endl;
+    }
+    std::cout << "----------------------------------------" << std::endl;
 
-        xml_doc.save_file(platform_file_path.c_str());
+    std::ofstream sweep_file(OutputDirectory::path("buffer_sweep.json"));
+    sweep_file << sweep.dump() << std::endl;
 
-    } else {
-        throw std::runtime_error("something went wrong with parsing xml string");
+    return status;
+}
+
+/**
+ * @brief Generates a platform with a client and a pool of servers, each with its own link to the client
+ * @param servers: the servers (their hostnames, speeds, bandwidths and latencies)
+ * @return the platform description
+ */
+PlatformBuilder::Zone generatePoolPlatform(const std::vector<wrench::Server> &servers) {
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("client", "100Gf", 1)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk", "100000TBps", "100000TBps");
+    for (auto const &server : servers) {
+        platform.addHost(server.hostname, std::to_string(server.speed) + "f", 1)
+                .setProperty("ram", "32GB")
+                .addDisk("large_disk", "100000TBps", "100000TBps");
+        std::string link = "link_" + server.hostname;
+        platform.addLink(link, std::to_string(server.bandwidth) + "Bps", std::to_string(server.latency * 1000.0 * 1000.0) + "us");
+        platform.addRoute("client", server.hostname, {link});
+    }
+    return platform;
+}
+
+/**
+ * @brief Simulate a stream of client requests (Poisson arrivals), dispatched by a load balancer to a pool of
+ *        generated servers of varying speed, link and startup overhead, and report the request latency
+ *        percentiles and the utilization of the servers (also written to load_balancing.json in the output
+ *        directory)
+ * @param simulation: the simulation (initialized)
+ * @param argc: the argument count
+ * @param argv: the arguments
+ * @return the exit status
+ */
+int simulateServerPool(wrench::Simulation &simulation, int argc, char **argv) {
+
+    const double MB = 1000.0 * 1000.0;
+    const double GFLOP = 1000.0 * 1000.0 * 1000.0;
+    const int MAX_NUM_SERVERS = 1000;
+    const int MAX_NUM_REQUESTS = 100000;
+    const std::set<std::string> POLICIES = {"round-robin", "least-loaded", "earliest-completion", "power-of-two"};
+
+    int NUM_SERVERS = 0;
+    int NUM_REQUESTS = 1000;
+    double ARRIVAL_RATE = 10;
+    double REQUEST_SIZE = 10;
+    double REQUEST_WORK = 100;
+    std::string POLICY = "round-robin";
+    unsigned long SEED = std::random_device{}();
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--servers=", 0) == 0) {
+                NUM_SERVERS = std::stoi(arg.substr(strlen("--servers=")));
+            } else if (arg.rfind("--requests=", 0) == 0) {
+                NUM_REQUESTS = std::stoi(arg.substr(strlen("--requests=")));
+            } else if (arg.rfind("--arrival-rate=", 0) == 0) {
+                ARRIVAL_RATE = std::stod(arg.substr(strlen("--arrival-rate=")));
+            } else if (arg.rfind("--request-size=", 0) == 0) {
+                REQUEST_SIZE = std::stod(arg.substr(strlen("--request-size=")));
+            } else if (arg.rfind("--request-work=", 0) == 0) {
+                REQUEST_WORK = std::stod(arg.substr(strlen("--request-work=")));
+            } else if (arg.rfind("--policy=", 0) == 0) {
+                POLICY = arg.substr(strlen("--policy="));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                SEED = std::stoul(arg.substr(strlen("--seed=")));
+            } else {
+                throw std::invalid_argument("unexpected argument " + arg);
+            }
+        }
+        if ((NUM_SERVERS < 2) or (NUM_SERVERS > MAX_NUM_SERVERS)) {
+            throw std::invalid_argument("Invalid number of servers (must be in range [2," +
+                                        std::to_string(MAX_NUM_SERVERS) + "])");
+        }
+        if ((NUM_REQUESTS < 1) or (NUM_REQUESTS > MAX_NUM_REQUESTS)) {
+            throw std::invalid_argument("Invalid number of requests (must be in range [1," +
+                                        std::to_string(MAX_NUM_REQUESTS) + "])");
+        }
+        if ((ARRIVAL_RATE <= 0) or (REQUEST_SIZE < 0) or (REQUEST_WORK <= 0)) {
+            throw std::invalid_argument("Invalid arrival rate, request size or request work");
+        }
+        if (POLICIES.find(POLICY) == POLICIES.end()) {
+            throw std::invalid_argument("Invalid policy " + POLICY);
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << argv[0] << " --servers=<n> [--requests=<n>] [--arrival-rate=<requests/sec>]"
+                     " [--request-size=<MB>] [--request-work=<Gflop>] [--policy=<policy>] [--seed=<seed>]" << std::endl;
+        std::cerr << "   servers: the number of servers, with speeds in [50,150] Gflop/sec, links in [100,1000] MBps"
+                     " and [10,1000] us, and startup overheads in [0,0.5] sec (default: 1000 requests, 10 requests/sec,"
+                     " of 10 MB and 100 Gflop)" << std::endl;
+        std::cerr << "   policy: round-robin (default), least-loaded, earliest-completion or power-of-two" << std::endl;
+        return 1;
+    }
+
+    // servers and requests
+    std::mt19937 generator(SEED);
+    std::uniform_real_distribution<double> speed_dist(50, 150);
+    std::uniform_real_distribution<double> bandwidth_dist(100, 1000);
+    std::uniform_real_distribution<double> latency_dist(10, 1000);
+    std::uniform_real_distribution<double> startup_overhead_dist(0, 0.5);
+    std::exponential_distribution<double> interarrival_dist(ARRIVAL_RATE);
+
+    std::vector<wrench::Server> servers(NUM_SERVERS);
+    for (int i = 0; i < NUM_SERVERS; i++) {
+        servers[i].hostname = "server" + std::to_string(i + 1);
+        servers[i].speed = speed_dist(generator) * GFLOP;
+        servers[i].bandwidth = bandwidth_dist(generator) * MB;
+        servers[i].latency = latency_dist(generator) / (1000.0 * 1000.0);
+        servers[i].startup_overhead = startup_overhead_dist(generator);
+    }
+
+    wrench::Workflow workflow;
+    std::vector<wrench::Request> requests(NUM_REQUESTS);
+    double arrival_date = 0;
+    for (int i = 0; i < NUM_REQUESTS; i++) {
+        arrival_date += interarrival_dist(generator);
+        requests[i].task = workflow.addTask("request_" + std::to_string(i), REQUEST_WORK * GFLOP, 1, 1, 0);
+        requests[i].file = workflow.addFile("request_file_" + std::to_string(i), REQUEST_SIZE * MB);
+        requests[i].task->addInputFile(requests[i].file);
+        requests[i].arrival_date = arrival_date;
+        requests[i].server = -1;
+        requests[i].completion_date = -1;
+        requests[i].failed = false;
+    }
+
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePoolPlatform(servers));
+    PhaseTimer::start("platform_instantiation");
+    simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
+
+    const std::string CLIENT("client");
+
+    auto client_storage_service = simulation.add(new wrench::SimpleStorageService(
+            CLIENT, {"/"}, {{wrench::SimpleStorageServiceProperty::BUFFER_SIZE, "infinity"}}));
+    for (auto &server : servers) {
+        server.compute_service = simulation.add(
+                new wrench::BareMetalComputeService(
+                        server.hostname,
+                        {{server.hostname, std::make_tuple(wrench::ComputeService::ALL_CORES, wrench::ComputeService::ALL_RAM)}},
+                        "",
+                        {
+                                {wrench::BareMetalComputeServiceProperty::TASK_STARTUP_OVERHEAD,
+                                 std::to_string(server.startup_overhead)},
+                        },
+                        {}
+                )
+        );
+    }
+
+    auto wms = simulation.add(new wrench::LoadBalancerWMS(servers, client_storage_service, CLIENT, requests,
+                                                          POLICY, SEED));
+    wms->addWorkflow(&workflow);
+
+    for (auto const &request : requests) {
+        simulation.stageFile(request.file, client_storage_service);
     }
+
+    PhaseTimer::start("simulation");
+
+    simulation.launch();
+
+    PhaseTimer::start("output");
+
+    // the latencies of the requests that did not fail
+    std::vector<double> latencies;
+    double makespan = 0;
+    unsigned long num_failed = 0;
+    for (auto const &request : wms->getRequests()) {
+        makespan = std::max(makespan, request.completion_date);
+        if (request.failed) {
+            num_failed++;
+        } else {
+            latencies.push_back(request.completion_date - request.arrival_date);
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double mean = 0;
+    for (auto const &latency : latencies) {
+        mean += latency / latencies.size();
+    }
+
+    nlohmann::json report = {{"policy",       POLICY},
+                             {"seed",         SEED},
+                             {"arrival_rate", ARRIVAL_RATE},
+                             {"num_requests", NUM_REQUESTS},
+                             {"num_failed",   num_failed},
+                             {"makespan",     makespan}};
+
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout.precision(4);
+    std::cout << NUM_REQUESTS << " requests dispatched to " << NUM_SERVERS << " servers (" << POLICY
+              << ") completed at time " << makespan << std::endl;
+    if (num_failed > 0) {
+        std::cout << num_failed << " requests failed" << std::endl;
+    }
+    if (not latencies.empty()) {
+        report["latency"] = {{"mean", mean},
+                             {"p50",  Statistics::percentile(latencies, 50)},
+                             {"p90",  Statistics::percentile(latencies, 90)},
+                             {"p99",  Statistics::percentile(latencies, 99)},
+                             {"max",  latencies.back()}};
+        std::cout << "Request latency: mean " << mean
+                  << ", p50 " << Statistics::percentile(latencies, 50)
+                  << ", p90 " << Statistics::percentile(latencies, 90)
+                  << ", p99 " << Statistics::percentile(latencies, 99)
+                  << ", max " << latencies.back() << std::endl;
+    }
+    for (auto const &server : wms->getServers()) {
+        double utilization = server.busy_time / makespan;
+        report["servers"].push_back({{"hostname",         server.hostname},
+                                     {"speed",            server.speed},
+                                     {"bandwidth",        server.bandwidth},
+                                     {"latency",          server.latency},
+                                     {"startup_overhead", server.startup_overhead},
+                                     {"num_requests",     server.num_requests},
+                                     {"num_failed",       server.num_failed},
+                                     {"utilization",      utilization}});
+        std::cout << "  " << server.hostname << " (" << server.speed / GFLOP << " Gflop/sec): "
+                  << server.num_requests << " requests, " << (100.0 * utilization) << "% utilization" << std::endl;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::ofstream report_file(OutputDirectory::path("load_balancing.json"));
+    report_file << report.dump() << std::endl;
+
+    return 0;
 }
 
 /**
@@ -147,8 +595,30 @@ void generatePlatform(std::string platform_file_path, int link_1_latency, int li
  */
 int main(int argc, char** argv) {
 
+    BatchMode::init(&argc, &argv, "client_server");
+    // the estimate only covers a single simulation, with one client and one of the two servers
+    AnalyticalEstimator::init(&argc, argv, "client_server", estimateSimulation, selfCheckGrid(),
+                              {"--buffer-sweep=", "--servers="});
+
+    // the buffer size sweep forks its simulations, so it must start before the simulation is created
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]).rfind("--buffer-sweep=", 0) == 0) {
+            return sweepBufferSizes(argc, argv);
+        }
+    }
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "client_server");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "client_server");
+
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]).rfind("--servers=", 0) == 0) {
+            return simulateServerPool(simulation, argc, argv);
+        }
+    }
 
     const int MAX_CORES         = 1000;
     int HOST_SELECT;
@@ -248,9 +718,13 @@ int main(int argc, char** argv) {
     generateWorkflow(&workflow, FILE_SIZE);
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, SERVER_1_LINK_LATENCY, SERVER_1_LINK_BANDWIDTH, SERVER_2_LINK_BANDWIDTH, DISK_TOGGLE, DISK_SPEED);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(
+            generatePlatform(SERVER_1_LINK_LATENCY, SERVER_1_LINK_BANDWIDTH, SERVER_2_LINK_BANDWIDTH,
+                             DISK_TOGGLE, DISK_SPEED));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
 
     const std::string CLIENT("client");
@@ -318,9 +792,21 @@ int main(int argc, char** argv) {
 
     simulation.getOutput().enableDiskTimestamps(true);
 
+    PhaseTimer::start("simulation");
+
     simulation.launch();
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", false, true, true, false, true, true, true);
+    PhaseTimer::start("output");
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), false, true, true, false, true, true, true);
+
+    }
 
     return 0;
 }
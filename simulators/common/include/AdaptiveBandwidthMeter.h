@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_ADAPTIVE_BANDWIDTH_METER_H
+#define EDUWRENCH_ADAPTIVE_BANDWIDTH_METER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wrench-dev.h>
+
+/**
+ *  @brief A replacement for WRENCH's bandwidth meter that records link usage samples (the
+ *         link_usage section of the JSON output) only when the usage of a link changes.
+ *
+ *         The links are polled every min_period seconds while their usage changes, and less
+ *         and less often while it is steady (every RELATIVE_RESOLUTION times the time since the
+ *         last change, so that a change is never recorded later than that fraction of the
+ *         preceding steady period). When the usage of a link has changed by more than
+ *         CHANGE_THRESHOLD times its bandwidth, two samples are recorded: the previous usage
+ *         and the new one, so that the plots still show steps. At most MAX_SAMPLES samples are
+ *         recorded per link (the following changes are dropped).
+ *
+ *         The meter runs as a daemon on the WMS host; flush() records the final usage of the
+ *         links, e.g., before the WMS returns.
+ */
+class AdaptiveBandwidthMeter : public wrench::Service {
+public:
+    static constexpr double RELATIVE_RESOLUTION = 0.05;
+    static constexpr double CHANGE_THRESHOLD = 0.01;
+    static constexpr unsigned long MAX_SAMPLES = 10000;
+
+    static std::shared_ptr<AdaptiveBandwidthMeter> start(wrench::Simulation *simulation, const std::string &hostname,
+                                                         const std::vector<std::string> &linknames,
+                                                         double min_period);
+
+    void flush();
+
+private:
+    AdaptiveBandwidthMeter(wrench::Simulation *simulation, const std::string &hostname,
+                           const std::vector<std::string> &linknames, double min_period);
+
+    int main() override;
+
+    bool poll();
+    void record(const std::string &linkname, double usage);
+
+    std::vector<std::string> linknames;
+    double min_period;
+
+    /** @brief The last recorded usage of each link, and its number of samples */
+    std::map<std::string, double> recorded_usage;
+    std::map<std::string, unsigned long> num_samples;
+};
+
+#endif //EDUWRENCH_ADAPTIVE_BANDWIDTH_METER_H
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_ANALYTICAL_ESTIMATOR_H
+#define EDUWRENCH_ANALYTICAL_ESTIMATOR_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ *  @brief Closed-form estimates of the simulated times of simulators that only copy a file and
+ *         run at most one task on a fixed platform, so that they can answer without starting
+ *         SimGrid.
+ *
+ *         A simulator provides a model, which computes from its (positional) command-line
+ *         arguments the simulated dates of its "file_copy_completion" and "wms_end" events
+ *         (keys "file_copy_end" and "makespan", plus any other key, e.g., "task_end"), and
+ *         returns false if the arguments are outside the range the model covers. The model only
+ *         sees the positional arguments, so the simulator also lists the prefixes of the options
+ *         that select another mode (e.g., "--servers="), which the model does not cover. Then:
+ *
+ *         - with --estimate, the estimate is printed as one JSON line on stdout, e.g.,
+ *           {"estimate":{"file_copy_end":10.3,"makespan":20.3}}, and the process exits without
+ *           simulating. Outside the range the model covers, or with a mode option, the
+ *           simulation runs as usual. So does every run until ESTIMATES_VALIDATED is set, which
+ *           must only be done once --self-check passes with the supported WRENCH and SimGrid
+ *           versions and its results are committed.
+ *
+ *         - with --self-check, the simulator is run (with --event-log) for each parameter set of
+ *           a grid, the dates of its events are compared with the estimate, one JSON line is
+ *           printed per parameter set, and the process exits with status 1 if any relative error
+ *           exceeds SELF_CHECK_TOLERANCE or if an estimated event is missing from the event log.
+ *
+ *         init() must be called in main() before the simulation is created, after BatchMode::init().
+ */
+class AnalyticalEstimator {
+public:
+    typedef std::function<bool(const std::vector<std::string> &args, nlohmann::json &estimate)> Model;
+
+    static constexpr double SELF_CHECK_TOLERANCE = 0.01;
+
+    /** @brief Whether --estimate answers from the models (otherwise, it simulates) */
+    static constexpr bool ESTIMATES_VALIDATED = false;
+
+    static void init(int *argc, char **argv, const std::string &simulator_name, const Model &model,
+                     const std::vector<std::vector<std::string>> &self_check_grid,
+                     const std::vector<std::string> &mode_flags = {});
+
+    /** @brief SimGrid's default (LV08) network model parameters */
+    static constexpr double LATENCY_FACTOR = 13.01;
+    static constexpr double BANDWIDTH_FACTOR = 0.97;
+    static constexpr double TCP_GAMMA = 4194304;
+
+    /** @brief The size of WRENCH control messages (its default message payload), in bytes */
+    static constexpr double CONTROL_MESSAGE_SIZE = 1024;
+
+    /** @brief Beyond this number of buffer-sized chunks, a file copy is not estimated */
+    static constexpr double MAX_CHUNKS = 100000;
+
+    static double messageTime(double bytes, double bandwidth, double latency);
+    static bool fileCopyTime(double file_size, double buffer_size, double read_bandwidth,
+                             double bandwidth, double latency, double write_bandwidth, double &time);
+
+private:
+    static int selfCheck(const std::string &program, const std::vector<std::string> &extra_args,
+                         const std::string &simulator_name, const Model &model,
+                         const std::vector<std::vector<std::string>> &grid);
+};
+
+#endif //EDUWRENCH_ANALYTICAL_ESTIMATOR_H
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_BATCH_MODE_H
+#define EDUWRENCH_BATCH_MODE_H
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ *  @brief Batch mode: when a simulator is run with --batch, it reads one parameter set per line
+ *         on stdin, either as a JSON array of command-line arguments or as a JSON object with
+ *         an "args" array and an optional "id", e.g.:
+ *
+ *         {"id":"small","args":["10","100",...]}
+ *
+ *         Each parameter set is run by the simulator in a child process (see ChildProcess; SimGrid
+ *         only supports one simulation per process), at most --batch-jobs=<n> at a time (by
+ *         default, one per core), with its own output directory <output directory>/run_<index>,
+ *         which also holds its stdout.txt and stderr.txt. One JSON line is
+ *         written to stdout per parameter set, as runs complete:
+ *
+ *         {"index":0,"id":"small","output_dir":"...","exit_status":0,"wall_time":0.52,"stdout":"..."}
+ *
+ *         (with "signal" instead of "exit_status" if the run was killed, and "stderr" if it
+ *         failed). The batch exits with status 1 if any run failed. The other arguments of the
+ *         batch invocation (e.g., --event-log) are appended to the arguments of every parameter
+ *         set.
+ *
+ *         init() must be called first thing in main(). It returns right away when not in batch
+ *         mode, and never returns otherwise.
+ */
+class BatchMode {
+public:
+    static void init(int *argc, char ***argv, const std::string &simulator_name);
+
+private:
+    struct Run {
+        unsigned long index;
+        nlohmann::json id;
+        std::string output_dir;
+        double start_time;
+    };
+
+    static int runBatch(const std::string &program, const std::vector<std::string> &extra_args,
+                        const std::string &batch_directory, long num_jobs);
+    static bool reportRun(const Run &run, int status);
+};
+
+#endif //EDUWRENCH_BATCH_MODE_H
@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_CHILD_PROCESS_H
+#define EDUWRENCH_CHILD_PROCESS_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+/**
+ *  @brief Runs of a program (typically, the simulator itself with other arguments) in child
+ *         processes, for the modes that run several simulations (--batch, --self-check, and
+ *         the client_server buffer size sweep). Each child is forked, gets /dev/null as stdin
+ *         and its stdout and stderr redirected to files, and executes the program, so that every
+ *         simulation starts from a fresh process. runJobs() keeps a number of such children
+ *         running at once.
+ */
+class ChildProcess {
+public:
+    static pid_t start(const std::string &program, const std::vector<std::string> &args,
+                       const std::string &stdout_path = "/dev/null",
+                       const std::string &stderr_path = "/dev/null");
+    static pid_t wait(int &status, pid_t pid = -1);
+    static int run(const std::string &program, const std::vector<std::string> &args,
+                   const std::string &stdout_path = "/dev/null",
+                   const std::string &stderr_path = "/dev/null");
+    static int exitStatus(int status);
+    static void runJobs(long num_jobs, const std::function<pid_t()> &start_next,
+                        const std::function<void(pid_t pid, int status)> &completed);
+};
+
+#endif //EDUWRENCH_CHILD_PROCESS_H
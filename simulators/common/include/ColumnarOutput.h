@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_COLUMNAR_OUTPUT_H
+#define EDUWRENCH_COLUMNAR_OUTPUT_H
+
+#include <set>
+#include <string>
+#include <wrench-dev.h>
+
+/**
+ *  @brief A compact alternative to SimulationOutput::dumpUnifiedJSON(). When a simulator is run
+ *         with --columnar-output=<groups> (a comma-separated subset of "tasks", "file_transfers",
+ *         "disk" and "links"), only the requested groups are written, as flat typed columns, to
+ *         workflow_data.ewc in the output directory. With --columnar-compress the body of the
+ *         file is zlib-compressed (if the library was built with zlib).
+ *
+ *  File layout (all integers are unsigned little-endian, all reals are IEEE 754 doubles):
+ *
+ *      header:  "EWCOL" | u8 version (1) | u8 flags (bit 0: zlib-compressed body) | u8 reserved
+ *      body:    u32 number of groups, then for each group:
+ *                   string name | u32 number of rows | u32 number of columns, then for each column:
+ *                       string name | u8 type | data
+ *      data:    type 0 (real):   one f64 per row
+ *               type 1 (count):  one u32 per row
+ *               type 2 (string): u32 dictionary size, the dictionary strings, then one u32
+ *                                dictionary index per row
+ *      string:  u32 length | bytes
+ *
+ *  Dates that are not known (e.g., the end of a failed task) are -1, as in WRENCH.
+ */
+class ColumnarOutput {
+public:
+    static void init(int *argc, char **argv);
+    static bool isEnabled();
+    static void dump(wrench::Simulation &simulation, wrench::Workflow *workflow, const std::string &file_path);
+
+private:
+    static std::set<std::string> groups;
+    static bool compress;
+};
+
+#endif //EDUWRENCH_COLUMNAR_OUTPUT_H
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_EVENT_LOG_H
+#define EDUWRENCH_EVENT_LOG_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <wrench-dev.h>
+
+/**
+ *  @brief An opt-in, machine-readable log of the simulated execution. When a simulator is
+ *         run with --event-log, each recorded event is written as one compact JSON object per
+ *         line to events.jsonl in the output directory, e.g.:
+ *
+ *         {"time":12.5,"host":"WMSHost","actor":"io_operations","event":"job_completion","tasks":["task0"]}
+ *
+ *         Recording is a no-op when the log is not enabled.
+ */
+class EventLog {
+public:
+    static void init(int *argc, char **argv);
+    static bool isEnabled();
+    static void record(const std::string &event, const nlohmann::json &fields = nlohmann::json::object());
+
+    static nlohmann::json taskIDs(const std::vector<wrench::WorkflowTask *> &tasks);
+
+private:
+    static void close();
+
+    static FILE *file;
+};
+
+#endif //EDUWRENCH_EVENT_LOG_H
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_OUTPUT_DIRECTORY_H
+#define EDUWRENCH_OUTPUT_DIRECTORY_H
+
+#include <string>
+
+/**
+ *  @brief The directory in which a simulator writes all its temporary and result files
+ *         (platform description, workflow_data.json, ...), so that concurrent runs do not
+ *         clobber each other's files
+ */
+class OutputDirectory {
+public:
+    static std::string init(int *argc, char **argv, const std::string &simulator_name);
+    static std::string get();
+    static std::string path(const std::string &file_name);
+
+private:
+    static void removeIfEmpty();
+
+    static std::string directory;
+    static bool created;
+};
+
+#endif //EDUWRENCH_OUTPUT_DIRECTORY_H
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_PHASE_TIMER_H
+#define EDUWRENCH_PHASE_TIMER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief Lightweight instrumentation of the phases of a simulator run (e.g., platform
+ *         generation, platform instantiation, simulation, output). When a simulator is run
+ *         with --profile, or with the EDUWRENCH_PROFILE environment variable set (to anything
+ *         but "" or "0"), a summary is printed to stderr when the process exits, as one line:
+ *
+ *         EDUWRENCH_PROFILE {"simulator":"io_operations","pid":1234,"phases":[{"name":"arguments",
+ *         "wall_time":0.0012,"peak_rss_kb":10240},...],"simulated_events":42,"actors":7,
+ *         "simulated_time":120.5}
+ *
+ *         The wall time of a phase is in seconds. The peak RSS of a phase is the peak resident
+ *         set size of the process at the end of the phase (so it never decreases from one phase
+ *         to the next). The simulated events are the number of times the simulated clock
+ *         advanced, and the actors are the number of SimGrid actors created.
+ *
+ *         Starting phases is a no-op when profiling is not enabled.
+ */
+class PhaseTimer {
+public:
+    static void init(int *argc, char **argv, const std::string &simulator_name);
+    static void start(const std::string &phase);
+
+private:
+    struct Phase {
+        std::string name;
+        double wall_time;
+        long peak_rss_kb;
+    };
+
+    static void endPhase();
+    static void report();
+
+    static bool enabled;
+    static std::string simulator_name;
+    static std::string current_phase;
+    static std::chrono::steady_clock::time_point current_phase_start;
+    static std::vector<Phase> phases;
+    static unsigned long num_simulated_events;
+    static unsigned long num_actors;
+    static double simulated_time;
+};
+
+#endif //EDUWRENCH_PHASE_TIMER_H
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_PLATFORM_BUILDER_H
+#define EDUWRENCH_PLATFORM_BUILDER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief An in-memory description of a simulated platform (zones, hosts, disks, links and
+ *         routes), built by the simulators instead of hand-written XML strings.
+ *
+ *         Speeds, bandwidths, latencies and sizes are strings with their SimGrid units (e.g.,
+ *         "100Gf", "50MBps", "10us", "5000GiB"). A description is serialized deterministically
+ *         to SimGrid XML, and cache() stores that serialization under a content-addressed name
+ *         in a directory shared by all runs (EDUWRENCH_PLATFORM_CACHE, or
+ *         $TMPDIR/eduwrench_platforms), so that the platform file is only written by the first
+ *         run that needs it. The cache is bounded in size and age, with LRU eviction. For instance:
+ *
+ *         PlatformBuilder::Zone platform("AS0");
+ *         platform.addHost("the_host", "100Gf", 4).setProperty("ram", "32GB");
+ *         platform.addLink("link", "100000TBps", "0us");
+ *         platform.addRoute("the_host", "the_host", {"link"});
+ *         simulation.instantiatePlatform(PlatformBuilder::cache(platform));
+ */
+class PlatformBuilder {
+public:
+    struct Disk {
+        std::string id;
+        std::string read_bw;
+        std::string write_bw;
+        std::string size;
+        std::string mount;
+    };
+
+    struct Host {
+        std::string id;
+        std::string speed;
+        int cores;
+        int pstate;  // -1: no pstate attribute
+        std::map<std::string, std::string> properties;
+        std::vector<Disk> disks;
+
+        Host &setProperty(const std::string &name, const std::string &value);
+        Host &setPState(int pstate);
+        Host &addDisk(const std::string &id, const std::string &read_bw, const std::string &write_bw,
+                      const std::string &size = "5000GiB", const std::string &mount = "/");
+    };
+
+    struct Link {
+        std::string id;
+        std::string bandwidth;
+        std::string latency;
+    };
+
+    struct Route {
+        std::string src;
+        std::string dst;
+        std::vector<std::string> links;
+    };
+
+    struct ZoneRoute {
+        std::string src;
+        std::string dst;
+        std::string gw_src;
+        std::string gw_dst;
+        std::vector<std::string> links;
+    };
+
+    struct Zone {
+        std::string id;
+        std::string routing;
+        std::vector<Host> hosts;
+        std::vector<std::string> routers;
+        std::vector<Zone> zones;
+        std::vector<Link> links;
+        std::vector<Route> routes;
+        std::vector<ZoneRoute> zone_routes;
+
+        explicit Zone(const std::string &id, const std::string &routing = "Full");
+
+        Host &addHost(const std::string &id, const std::string &speed, int cores = 1);
+        void addRouter(const std::string &id);
+        Zone &addZone(const std::string &id, const std::string &routing = "Full");
+        Link &addLink(const std::string &id, const std::string &bandwidth, const std::string &latency);
+        Route &addRoute(const std::string &src, const std::string &dst, const std::vector<std::string> &links);
+        ZoneRoute &addZoneRoute(const std::string &src, const std::string &dst,
+                                const std::string &gw_src, const std::string &gw_dst,
+                                const std::vector<std::string> &links);
+    };
+
+    static std::string toXML(const Zone &platform);
+    static std::string cache(const Zone &platform);
+
+private:
+    static void zoneToXML(const Zone &zone, const std::string &indent, std::string &xml);
+    static std::string cacheDirectory();
+    static void evict(const std::string &directory);
+    static bool writeFile(const std::string &path, const std::string &content);
+};
+
+#endif //EDUWRENCH_PLATFORM_BUILDER_H
@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_STATISTICS_H
+#define EDUWRENCH_STATISTICS_H
+
+#include <vector>
+
+/**
+ *  @brief Summary statistics of the simulation results (e.g., request latency or flow completion
+ *         time percentiles) reported by the simulators.
+ */
+class Statistics {
+public:
+    static double percentile(const std::vector<double> &sorted_values, double percentile);
+};
+
+#endif //EDUWRENCH_STATISTICS_H
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "AdaptiveBandwidthMeter.h"
+
+constexpr double AdaptiveBandwidthMeter::RELATIVE_RESOLUTION;
+constexpr double AdaptiveBandwidthMeter::CHANGE_THRESHOLD;
+constexpr unsigned long AdaptiveBandwidthMeter::MAX_SAMPLES;
+
+/**
+ * @brief Create and start a meter (as a daemon)
+ *
+ * @param simulation: the simulation
+ * @param hostname: the host on which the meter runs
+ * @param linknames: the links to measure
+ * @param min_period: the shortest time between two measurements, in seconds
+ * @return the meter
+ *
+ * @throws std::invalid_argument
+ */
+std::shared_ptr<AdaptiveBandwidthMeter> AdaptiveBandwidthMeter::start(wrench::Simulation *simulation,
+                                                                      const std::string &hostname,
+                                                                      const std::vector<std::string> &linknames,
+                                                                      double min_period) {
+    if (linknames.empty() or (min_period <= 0)) {
+        throw std::invalid_argument("AdaptiveBandwidthMeter::start(): invalid links or period");
+    }
+    auto meter = std::shared_ptr<AdaptiveBandwidthMeter>(
+            new AdaptiveBandwidthMeter(simulation, hostname, linknames, min_period));
+    meter->wrench::Service::start(meter, true, false);
+    return meter;
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param simulation: the simulation
+ * @param hostname: the host on which the meter runs
+ * @param linknames: the links to measure
+ * @param min_period: the shortest time between two measurements, in seconds
+ */
+AdaptiveBandwidthMeter::AdaptiveBandwidthMeter(wrench::Simulation *simulation, const std::string &hostname,
+                                               const std::vector<std::string> &linknames, double min_period) :
+        wrench::Service(hostname, "adaptive_bandwidth_meter", "adaptive_bandwidth_meter"),
+        linknames(linknames), min_period(min_period) {
+    this->simulation = simulation;
+}
+
+/**
+ * @brief Record the current usage of every link (preceded, for a link whose usage has changed
+ *        since its last sample, by the previous usage, so that the change is a step)
+ */
+void AdaptiveBandwidthMeter::flush() {
+    for (auto const &linkname : this->linknames) {
+        double usage = this->simulation->getLinkUsage(linkname, false);
+        auto previous_usage = this->recorded_usage.find(linkname);
+        if ((previous_usage != this->recorded_usage.end()) and (previous_usage->second != usage)) {
+            record(linkname, previous_usage->second);
+        }
+        record(linkname, usage);
+    }
+}
+
+/**
+ * @brief The meter's main method: poll the links, more often while their usage changes
+ * @return 0 (never returns, the meter is killed with the simulation)
+ */
+int AdaptiveBandwidthMeter::main() {
+
+    flush();
+
+    double last_change = wrench::Simulation::getCurrentSimulatedDate();
+    while (true) {
+        double now = wrench::Simulation::getCurrentSimulatedDate();
+        wrench::Simulation::sleep(std::max(this->min_period, RELATIVE_RESOLUTION * (now - last_change)));
+        if (poll()) {
+            last_change = wrench::Simulation::getCurrentSimulatedDate();
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Measure the links, and record those whose usage has changed
+ * @return true if the usage of a link has changed
+ */
+bool AdaptiveBandwidthMeter::poll() {
+    bool changed = false;
+    for (auto const &linkname : this->linknames) {
+        double usage = this->simulation->getLinkUsage(linkname, false);
+        double previous_usage = this->recorded_usage[linkname];
+        double threshold = CHANGE_THRESHOLD * wrench::S4U_Simulation::getLinkBandwidth(linkname);
+        if (std::fabs(usage - previous_usage) > threshold) {
+            // the previous usage lasted until now: record it again, so that the change is a step
+            record(linkname, previous_usage);
+            record(linkname, usage);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief Record a usage sample of a link (as a link usage timestamp of the simulation output)
+ *
+ * @param linkname: the link name
+ * @param usage: the usage of the link (only used to compare with the next measurements)
+ */
+void AdaptiveBandwidthMeter::record(const std::string &linkname, double usage) {
+    this->recorded_usage[linkname] = usage;
+    if (this->num_samples[linkname] >= MAX_SAMPLES) {
+        return;
+    }
+    this->num_samples[linkname]++;
+    this->simulation->getOutput().addTimestampLinkUsage(linkname, usage);
+}
@@ -0,0 +1,277 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "AnalyticalEstimator.h"
+#include "ChildProcess.h"
+#include "OutputDirectory.h"
+
+#define ESTIMATE_FLAG "--estimate"
+#define SELF_CHECK_FLAG "--self-check"
+
+constexpr double AnalyticalEstimator::SELF_CHECK_TOLERANCE;
+constexpr bool AnalyticalEstimator::ESTIMATES_VALIDATED;
+constexpr double AnalyticalEstimator::LATENCY_FACTOR;
+constexpr double AnalyticalEstimator::BANDWIDTH_FACTOR;
+constexpr double AnalyticalEstimator::TCP_GAMMA;
+constexpr double AnalyticalEstimator::CONTROL_MESSAGE_SIZE;
+constexpr double AnalyticalEstimator::MAX_CHUNKS;
+
+/**
+ * @brief Handle the --estimate and --self-check arguments (they are removed from argv). Returns
+ *        if neither is present, or with --estimate if the estimates are not validated yet, or if
+ *        the arguments are outside the range the model covers or select a mode the model does not
+ *        cover. Otherwise, exits.
+ *
+ * @param argc: pointer to the argument count (updated if a flag is removed)
+ * @param argv: the arguments
+ * @param simulator_name: the simulator name
+ * @param model: the closed-form model of the simulator
+ * @param self_check_grid: the parameter sets (positional arguments) used by --self-check
+ * @param mode_flags: the prefixes of the options that select a mode the model does not cover
+ *
+ * @throws std::runtime_error
+ */
+void AnalyticalEstimator::init(int *argc, char **argv, const std::string &simulator_name, const Model &model,
+                               const std::vector<std::vector<std::string>> &self_check_grid,
+                               const std::vector<std::string> &mode_flags) {
+
+    bool estimate_requested = false;
+    bool self_check_requested = false;
+    int j = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (not strcmp(argv[i], ESTIMATE_FLAG)) {
+            estimate_requested = true;
+        } else if (not strcmp(argv[i], SELF_CHECK_FLAG)) {
+            self_check_requested = true;
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    *argc = j;
+    argv[j] = nullptr;
+
+    if ((not estimate_requested) and (not self_check_requested)) {
+        return;
+    }
+
+    std::string mode_flag;
+    for (int i = 1; (i < *argc) and mode_flag.empty(); i++) {
+        for (auto const &flag : mode_flags) {
+            if (not strncmp(argv[i], flag.c_str(), flag.size())) {
+                mode_flag = flag;
+                break;
+            }
+        }
+    }
+
+    if (self_check_requested) {
+        if (not mode_flag.empty()) {
+            std::cerr << "The model does not cover " << mode_flag << ", cannot self-check" << std::endl;
+            exit(1);
+        }
+        std::vector<std::string> extra_args;
+        for (int i = 1; i < *argc; i++) {
+            if (strncmp(argv[i], "--output-dir=", strlen("--output-dir="))) {
+                extra_args.emplace_back(argv[i]);
+            }
+        }
+        OutputDirectory::init(argc, argv, simulator_name);
+        exit(selfCheck(argv[0], extra_args, simulator_name, model, self_check_grid));
+    }
+
+    if (not ESTIMATES_VALIDATED) {
+        std::cerr << "The estimator has not been validated with " SELF_CHECK_FLAG ", simulating" << std::endl;
+        return;
+    }
+
+    if (not mode_flag.empty()) {
+        std::cerr << "The estimator does not cover " << mode_flag << ", simulating" << std::endl;
+        return;
+    }
+
+    // the positional arguments (the others are WRENCH, SimGrid or eduWRENCH options)
+    std::vector<std::string> args;
+    for (int i = 1; i < *argc; i++) {
+        if (strncmp(argv[i], "--", 2)) {
+            args.emplace_back(argv[i]);
+        }
+    }
+
+    nlohmann::json estimate;
+    bool in_range;
+    try {
+        in_range = model(args, estimate);
+    } catch (std::exception &e) {
+        in_range = false;
+    }
+    if (not in_range) {
+        std::cerr << "The arguments are outside the range the estimator covers, simulating" << std::endl;
+        return;
+    }
+    std::cout << nlohmann::json({{"estimate", estimate}}).dump() << std::endl;
+    exit(0);
+}
+
+/**
+ * @brief Estimate the time of a message over a route
+ *
+ * @param bytes: the message size in bytes
+ * @param bandwidth: the (nominal) bandwidth of the route in bytes/sec
+ * @param latency: the latency of the route in seconds
+ * @return a time in seconds
+ */
+double AnalyticalEstimator::messageTime(double bytes, double bandwidth, double latency) {
+    double rate = BANDWIDTH_FACTOR * bandwidth;
+    if (latency > 0) {
+        rate = std::min(rate, TCP_GAMMA / (2.0 * latency));
+    }
+    return LATENCY_FACTOR * latency + bytes / rate;
+}
+
+/**
+ * @brief Estimate the time of a file copy between two storage services, which read, send and
+ *        write a file in buffer-sized chunks, with each stage working on one chunk while the
+ *        next stage works on the previous one (with an infinite buffer size, the whole file is
+ *        read, then sent, then written)
+ *
+ * @param file_size: the file size in bytes
+ * @param buffer_size: the buffer size in bytes (possibly infinity)
+ * @param read_bandwidth: the source disk bandwidth in bytes/sec
+ * @param bandwidth: the (nominal) bandwidth of the route in bytes/sec
+ * @param latency: the latency of the route in seconds
+ * @param write_bandwidth: the destination disk bandwidth in bytes/sec
+ * @param time: the estimated time in seconds
+ * @return false if there are too many chunks to estimate the copy, true otherwise
+ */
+bool AnalyticalEstimator::fileCopyTime(double file_size, double buffer_size, double read_bandwidth,
+                                       double bandwidth, double latency, double write_bandwidth, double &time) {
+
+    double num_chunks = std::isinf(buffer_size) ? 1 : std::max(1.0, std::ceil(file_size / buffer_size));
+    if (num_chunks > MAX_CHUNKS) {
+        return false;
+    }
+
+    // the date at which each stage completed the last two chunks
+    double read_end = 0, send_end[2] = {0, 0}, write_end[2] = {0, 0};
+    double remaining = file_size;
+    for (long i = 0; i < (long) num_chunks; i++) {
+        double chunk = std::isinf(buffer_size) ? file_size : std::min(buffer_size, remaining);
+        remaining -= chunk;
+
+        // the sender reads chunk i while chunk i-1 is being sent
+        read_end = std::max(read_end, send_end[1]) + chunk / read_bandwidth;
+        // the receiver receives chunk i while chunk i-1 is being written
+        double send_start = std::max({read_end, send_end[0], write_end[1]});
+        send_end[1] = send_end[0];
+        send_end[0] = send_start + messageTime(chunk, bandwidth, latency);
+        double write_start = std::max(send_end[0], write_end[0]);
+        write_end[1] = write_end[0];
+        write_end[0] = write_start + chunk / write_bandwidth;
+    }
+
+    time = write_end[0];
+    return true;
+}
+
+/**
+ * @brief Compare the model with the simulation over a grid of parameter sets
+ *
+ * @param program: the simulator executable
+ * @param extra_args: arguments appended to those of every parameter set
+ * @param simulator_name: the simulator name
+ * @param model: the model
+ * @param grid: the parameter sets
+ * @return 0 if all estimated events were logged with relative errors below SELF_CHECK_TOLERANCE,
+ *         1 otherwise
+ */
+int AnalyticalEstimator::selfCheck(const std::string &program, const std::vector<std::string> &extra_args,
+                                   const std::string &simulator_name, const Model &model,
+                                   const std::vector<std::vector<std::string>> &grid) {
+
+    // the estimates and the events they are compared to
+    const std::map<std::string, std::string> compared_events = {{"file_copy_end", "file_copy_completion"},
+                                                                {"makespan",      "wms_end"}};
+
+    int status = 0;
+    double max_error = 0;
+    for (unsigned long index = 0; index < grid.size(); index++) {
+        auto const &args = grid[index];
+        nlohmann::json result = {{"index", index}, {"args", args}};
+
+        nlohmann::json estimate;
+        if (not model(args, estimate)) {
+            result["error"] = "outside the range the model covers";
+            std::cout << result.dump() << std::endl;
+            status = 1;
+            continue;
+        }
+        result["estimate"] = estimate;
+
+        std::string run_directory = OutputDirectory::path("self_check_" + std::to_string(index));
+        if ((mkdir(run_directory.c_str(), 0700) != 0) and (errno != EEXIST)) {
+            throw std::runtime_error("AnalyticalEstimator::selfCheck(): cannot create directory " + run_directory);
+        }
+
+        std::vector<std::string> child_args(args);
+        child_args.insert(child_args.end(), extra_args.begin(), extra_args.end());
+        child_args.emplace_back("--event-log");
+        child_args.emplace_back("--output-dir=" + run_directory);
+        int wait_status = ChildProcess::run(program, child_args);
+        if ((not WIFEXITED(wait_status)) or (WEXITSTATUS(wait_status) != 0)) {
+            result["error"] = "the simulation failed";
+            std::cout << result.dump() << std::endl;
+            status = 1;
+            continue;
+        }
+
+        // the date of the last occurrence of each event
+        std::map<std::string, double> event_dates;
+        std::ifstream event_log(run_directory + "/events.jsonl");
+        std::string line;
+        while (std::getline(event_log, line)) {
+            auto event = nlohmann::json::parse(line);
+            event_dates[event.at("event").get<std::string>()] = event.at("time").get<double>();
+        }
+
+        for (auto const &compared : compared_events) {
+            if (not estimate.contains(compared.first)) {
+                continue;
+            }
+            if (event_dates.find(compared.second) == event_dates.end()) {
+                result["error"] = "no " + compared.second + " event in the event log";
+                status = 1;
+                continue;
+            }
+            double estimated = estimate.at(compared.first).get<double>();
+            double simulated = event_dates[compared.second];
+            double error = std::fabs(estimated - simulated) / std::max(simulated, std::numeric_limits<double>::min());
+            result["simulated"][compared.first] = simulated;
+            result["relative_error"][compared.first] = error;
+            max_error = std::max(max_error, error);
+            if (error > SELF_CHECK_TOLERANCE) {
+                status = 1;
+            }
+        }
+        std::cout << result.dump() << std::endl;
+    }
+
+    std::cerr << simulator_name << ": maximum relative error " << max_error
+              << " over " << grid.size() << " parameter sets (tolerance " << SELF_CHECK_TOLERANCE << ")" << std::endl;
+    return status;
+}
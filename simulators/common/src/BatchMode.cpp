@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BatchMode.h"
+#include "ChildProcess.h"
+#include "OutputDirectory.h"
+
+#define BATCH_FLAG "--batch"
+#define BATCH_JOBS_FLAG "--batch-jobs="
+
+/**
+ * @brief Get the current time in seconds (for wall time measurements)
+ * @return a number of seconds
+ */
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Read a whole file
+ * @param path: the file path
+ * @return the file content (empty if the file cannot be read)
+ */
+static std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * @brief Enter batch mode if a --batch argument is present (it is removed from argv, as is
+ *        --batch-jobs=<n>). Must be called before anything else in main().
+ *
+ * @param argc: pointer to the argument count
+ * @param argv: pointer to the arguments
+ * @param simulator_name: the simulator name, used to name the batch output directory
+ *
+ * @throws std::invalid_argument
+ * @throws std::runtime_error
+ */
+void BatchMode::init(int *argc, char ***argv, const std::string &simulator_name) {
+
+    bool enabled = false;
+    long num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int j = 1;
+    for (int i = 1; i < *argc; i++) {
+        char *arg = (*argv)[i];
+        if (not strcmp(arg, BATCH_FLAG)) {
+            enabled = true;
+        } else if (not strncmp(arg, BATCH_JOBS_FLAG, strlen(BATCH_JOBS_FLAG))) {
+            char *end;
+            num_jobs = strtol(arg + strlen(BATCH_JOBS_FLAG), &end, 10);
+            if ((*end != '\0') or (num_jobs < 1)) {
+                throw std::invalid_argument("BatchMode::init(): invalid " BATCH_JOBS_FLAG " argument");
+            }
+        } else {
+            (*argv)[j++] = arg;
+        }
+    }
+    *argc = j;
+    (*argv)[j] = nullptr;
+
+    if (not enabled) {
+        return;
+    }
+
+    // the output directory of the batch, in which each run gets its own directory
+    std::string batch_directory = OutputDirectory::init(argc, *argv, simulator_name);
+
+    std::vector<std::string> extra_args((*argv) + 1, (*argv) + *argc);
+
+    exit(runBatch((*argv)[0], extra_args, batch_directory, std::max(num_jobs, 1L)));
+}
+
+/**
+ * @brief Run the parameter sets read on stdin, in child processes
+ *
+ * @param program: the simulator executable
+ * @param extra_args: arguments appended to those of every parameter set
+ * @param batch_directory: the output directory of the batch
+ * @param num_jobs: the maximum number of concurrent runs
+ * @return 0 once all runs have completed, 1 if any of them failed
+ */
+int BatchMode::runBatch(const std::string &program, const std::vector<std::string> &extra_args,
+                        const std::string &batch_directory, long num_jobs) {
+
+    std::map<pid_t, Run> running;
+    unsigned long next_index = 0;
+    unsigned long num_failed = 0;
+
+    // start the run of the next valid parameter set
+    auto start_next = [&]() -> pid_t {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            Run run;
+            run.index = next_index++;
+            run.output_dir = batch_directory + "/run_" + std::to_string(run.index);
+
+            std::vector<std::string> args;
+            try {
+                auto parameter_set = nlohmann::json::parse(line);
+                nlohmann::json json_args = parameter_set;
+                if (parameter_set.is_object()) {
+                    if (parameter_set.contains("id")) {
+                        run.id = parameter_set.at("id");
+                    }
+                    json_args = parameter_set.at("args");
+                }
+                if (not json_args.is_array()) {
+                    throw std::invalid_argument("the arguments must be a JSON array");
+                }
+                for (auto const &arg : json_args) {
+                    args.push_back(arg.is_string() ? arg.get<std::string>() : arg.dump());
+                }
+            } catch (std::exception &e) {
+                nlohmann::json result = {{"index", run.index},
+                                         {"error", std::string("invalid parameter set: ") + e.what()}};
+                std::cout << result.dump() << std::endl;
+                num_failed++;
+                continue;
+            }
+            args.insert(args.end(), extra_args.begin(), extra_args.end());
+            args.emplace_back("--output-dir=" + run.output_dir);
+
+            if ((mkdir(run.output_dir.c_str(), 0700) != 0) and (errno != EEXIST)) {
+                throw std::runtime_error("BatchMode::runBatch(): cannot create directory " + run.output_dir +
+                                         " (" + strerror(errno) + ")");
+            }
+
+            run.start_time = now();
+            pid_t pid = ChildProcess::start(program, args, run.output_dir + "/stdout.txt",
+                                            run.output_dir + "/stderr.txt");
+            running[pid] = run;
+            return pid;
+        }
+        return -1;
+    };
+
+    ChildProcess::runJobs(num_jobs, start_next, [&](pid_t pid, int status) {
+        if (not reportRun(running.at(pid), status)) {
+            num_failed++;
+        }
+        running.erase(pid);
+    });
+
+    return (num_failed == 0) ? 0 : 1;
+}
+
+/**
+ * @brief Write the result line of a completed run to stdout
+ *
+ * @param run: the run
+ * @param status: the wait status of its process
+ * @return true if the run succeeded, false otherwise
+ */
+bool BatchMode::reportRun(const Run &run, int status) {
+    nlohmann::json result;
+    result["index"] = run.index;
+    if (not run.id.is_null()) {
+        result["id"] = run.id;
+    }
+    result["output_dir"] = run.output_dir;
+
+    bool succeeded = false;
+    if (WIFEXITED(status)) {
+        result["exit_status"] = WEXITSTATUS(status);
+        succeeded = (WEXITSTATUS(status) == 0);
+    } else if (WIFSIGNALED(status)) {
+        result["signal"] = WTERMSIG(status);
+    }
+    result["wall_time"] = now() - run.start_time;
+    result["stdout"] = readFile(run.output_dir + "/stdout.txt");
+    if (not succeeded) {
+        result["stderr"] = readFile(run.output_dir + "/stderr.txt");
+    }
+
+    std::cout << result.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) << std::endl;
+    return succeeded;
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cerrno>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ChildProcess.h"
+
+/**
+ * @brief Start a program in a child process
+ *
+ * @param program: the program (looked up in the PATH if it has no '/'), also its argv[0]
+ * @param args: the arguments (after argv[0])
+ * @param stdout_path: the file to which the standard output is written (truncated)
+ * @param stderr_path: the file to which the standard error is written (truncated)
+ * @return the process ID of the child (which exits with status 127 if the program cannot be run)
+ *
+ * @throws std::runtime_error
+ */
+pid_t ChildProcess::start(const std::string &program, const std::vector<std::string> &args,
+                          const std::string &stdout_path, const std::string &stderr_path) {
+
+    // built before forking, so that the child only calls async-signal-safe functions
+    std::vector<char *> child_argv;
+    child_argv.push_back(const_cast<char *>(program.c_str()));
+    for (auto const &arg : args) {
+        child_argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    child_argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        throw std::runtime_error(std::string("ChildProcess::start(): cannot fork (") + strerror(errno) + ")");
+    } else if (pid > 0) {
+        return pid;
+    }
+
+    int null_fd = open("/dev/null", O_RDONLY);
+    int stdout_fd = open(stdout_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    int stderr_fd = open(stderr_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if ((null_fd == -1) or (stdout_fd == -1) or (stderr_fd == -1)) {
+        _exit(127);
+    }
+    dup2(null_fd, STDIN_FILENO);
+    dup2(stdout_fd, STDOUT_FILENO);
+    dup2(stderr_fd, STDERR_FILENO);
+    close(null_fd);
+    close(stdout_fd);
+    close(stderr_fd);
+
+    execvp(program.c_str(), child_argv.data());
+    _exit(127);
+}
+
+/**
+ * @brief Wait for a child process to complete (retrying if interrupted by a signal)
+ *
+ * @param status: set to the wait status of the child
+ * @param pid: the process ID of the child (-1 for any child)
+ * @return the process ID of the child that completed
+ *
+ * @throws std::runtime_error
+ */
+pid_t ChildProcess::wait(int &status, pid_t pid) {
+    while (true) {
+        pid_t completed = waitpid(pid, &status, 0);
+        if (completed != -1) {
+            return completed;
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error(std::string("ChildProcess::wait(): waitpid() failed (") + strerror(errno) + ")");
+        }
+    }
+}
+
+/**
+ * @brief Run a program in a child process, and wait for it to complete
+ *
+ * @param program: the program (looked up in the PATH if it has no '/'), also its argv[0]
+ * @param args: the arguments (after argv[0])
+ * @param stdout_path: the file to which the standard output is written (truncated)
+ * @param stderr_path: the file to which the standard error is written (truncated)
+ * @return the wait status of the child
+ *
+ * @throws std::runtime_error
+ */
+int ChildProcess::run(const std::string &program, const std::vector<std::string> &args,
+                      const std::string &stdout_path, const std::string &stderr_path) {
+    int status;
+    wait(status, start(program, args, stdout_path, stderr_path));
+    return status;
+}
+
+/**
+ * @brief Get the exit status of a child from its wait status, as a shell would
+ *
+ * @param status: the wait status
+ * @return the exit status, or 128 plus the signal number if the child was killed
+ */
+int ChildProcess::exitStatus(int status) {
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+/**
+ * @brief Run jobs in child processes, at most num_jobs at a time: start_next() is called while
+ *        fewer than num_jobs children are running, until it returns -1, and completed() is
+ *        called as each child completes
+ *
+ * @param num_jobs: the maximum number of concurrent children
+ * @param start_next: starts the next job (e.g., with start()) and returns the process ID of its
+ *                    child, or -1 if there is no job left
+ * @param completed: called with the process ID and the wait status of each completed child
+ *
+ * @throws std::runtime_error
+ */
+void ChildProcess::runJobs(long num_jobs, const std::function<pid_t()> &start_next,
+                           const std::function<void(pid_t pid, int status)> &completed) {
+    std::set<pid_t> running;
+    bool no_job_left = false;
+    while ((not no_job_left) or (not running.empty())) {
+
+        // start jobs while there are free slots
+        while ((not no_job_left) and ((long) running.size() < num_jobs)) {
+            pid_t pid = start_next();
+            if (pid == -1) {
+                no_job_left = true;
+            } else {
+                running.insert(pid);
+            }
+        }
+
+        if (running.empty()) {
+            continue;
+        }
+
+        // wait for a job to complete
+        int status;
+        pid_t pid = wait(status);
+        if (running.erase(pid)) {
+            completed(pid, status);
+        }
+    }
+}
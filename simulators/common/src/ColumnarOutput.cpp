@@ -0,0 +1,404 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stack>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef EDUWRENCH_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "ColumnarOutput.h"
+
+#define COLUMNAR_OUTPUT_FLAG "--columnar-output="
+#define COLUMNAR_COMPRESS_FLAG "--columnar-compress"
+#define COLUMNAR_VERSION 1
+#define COLUMNAR_FLAG_ZLIB 0x01
+
+std::set<std::string> ColumnarOutput::groups;
+bool ColumnarOutput::compress = false;
+
+namespace {
+
+    void putU8(std::string &out, uint8_t value) {
+        out.push_back((char) value);
+    }
+
+    void putU32(std::string &out, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back((char) ((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    void putF64(std::string &out, double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; i++) {
+            out.push_back((char) ((bits >> (8 * i)) & 0xff));
+        }
+    }
+
+    void putString(std::string &out, const std::string &value) {
+        putU32(out, (uint32_t) value.size());
+        out.append(value);
+    }
+
+    /**
+     * @brief A group of columns with the same number of rows, filled one row at a time
+     */
+    class ColumnGroup {
+    public:
+        enum Type {
+            REAL = 0,
+            COUNT = 1,
+            STRING = 2
+        };
+
+        explicit ColumnGroup(const std::string &name) : name(name), num_rows(0) {}
+
+        /**
+         * @brief Declare a column (all columns must be declared before the first row is added)
+         * @param column_name: the column name
+         * @param type: the column type
+         */
+        void addColumn(const std::string &column_name, Type type) {
+            this->columns.push_back(Column{column_name, type});
+        }
+
+        /**
+         * @brief Set a value of the current row (column index i)
+         */
+        void set(size_t i, double value) {
+            this->columns.at(i).reals.push_back(value);
+        }
+
+        void set(size_t i, unsigned long value) {
+            this->columns.at(i).counts.push_back((uint32_t) value);
+        }
+
+        void set(size_t i, const std::string &value) {
+            auto &column = this->columns.at(i);
+            auto entry = column.dictionary_index.emplace(value, (uint32_t) column.dictionary.size());
+            if (entry.second) {
+                column.dictionary.push_back(value);
+            }
+            column.counts.push_back(entry.first->second);
+        }
+
+        /**
+         * @brief Close the current row
+         */
+        void endRow() {
+            this->num_rows++;
+        }
+
+        /**
+         * @brief Append the serialized group to a body
+         * @param out: the body
+         */
+        void serialize(std::string &out) const {
+            putString(out, this->name);
+            putU32(out, this->num_rows);
+            putU32(out, (uint32_t) this->columns.size());
+            for (auto const &column : this->columns) {
+                putString(out, column.name);
+                putU8(out, column.type);
+                if (column.type == STRING) {
+                    putU32(out, (uint32_t) column.dictionary.size());
+                    for (auto const &value : column.dictionary) {
+                        putString(out, value);
+                    }
+                }
+                if (column.type == REAL) {
+                    for (auto value : column.reals) {
+                        putF64(out, value);
+                    }
+                } else {
+                    // counts, or dictionary indices
+                    for (auto value : column.counts) {
+                        putU32(out, value);
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Column {
+            std::string name;
+            Type type;
+            std::vector<double> reals;
+            std::vector<uint32_t> counts;
+            std::vector<std::string> dictionary;
+            std::unordered_map<std::string, uint32_t> dictionary_index;
+        };
+
+        std::string name;
+        uint32_t num_rows;
+        std::vector<Column> columns;
+    };
+
+    /**
+     * @brief Build the "tasks" group: one row per task execution attempt (as in the
+     *        "workflow_execution" section of the unified JSON output)
+     */
+    ColumnGroup taskGroup(wrench::Workflow *workflow) {
+        ColumnGroup group("tasks");
+        for (auto const &column : {"task_id", "execution_host"}) {
+            group.addColumn(column, ColumnGroup::STRING);
+        }
+        group.addColumn("num_cores_allocated", ColumnGroup::COUNT);
+        for (auto const &column : {"task_start", "read_input_start", "read_input_end", "computation_start",
+                                   "computation_end", "write_output_start", "write_output_end", "task_end",
+                                   "task_failed", "task_terminated"}) {
+            group.addColumn(column, ColumnGroup::REAL);
+        }
+
+        for (auto const &task : workflow->getTasks()) {
+            auto history = task->getExecutionHistory();
+            // the history is a stack, with the most recent attempt on top
+            std::vector<wrench::WorkflowTask::WorkflowTaskExecution> attempts;
+            while (not history.empty()) {
+                attempts.push_back(history.top());
+                history.pop();
+            }
+            for (auto attempt = attempts.rbegin(); attempt != attempts.rend(); ++attempt) {
+                size_t i = 0;
+                group.set(i++, task->getID());
+                group.set(i++, attempt->execution_host);
+                group.set(i++, attempt->num_cores_allocated);
+                for (auto date : {attempt->task_start, attempt->read_input_start, attempt->read_input_end,
+                                  attempt->computation_start, attempt->computation_end,
+                                  attempt->write_output_start, attempt->write_output_end, attempt->task_end,
+                                  attempt->task_failed, attempt->task_terminated}) {
+                    group.set(i++, date);
+                }
+                group.endRow();
+            }
+        }
+        return group;
+    }
+
+    /**
+     * @brief Build the "file_transfers" group: one row per file copy
+     */
+    ColumnGroup fileTransferGroup(wrench::SimulationOutput &output) {
+        ColumnGroup group("file_transfers");
+        for (auto const &column : {"file_id", "source", "destination"}) {
+            group.addColumn(column, ColumnGroup::STRING);
+        }
+        group.addColumn("file_size", ColumnGroup::REAL);
+        group.addColumn("start", ColumnGroup::REAL);
+        group.addColumn("end", ColumnGroup::REAL);
+
+        for (auto const &timestamp : output.getTrace<wrench::SimulationTimestampFileCopyStart>()) {
+            auto copy = timestamp->getContent();
+            auto endpoint = copy->getEndpoint();
+            group.set(0, copy->getFile()->getID());
+            group.set(1, copy->getSource()->getStorageService()->getHostname());
+            group.set(2, copy->getDestination()->getStorageService()->getHostname());
+            group.set(3, copy->getFile()->getSize());
+            group.set(4, timestamp->getDate());
+            group.set(5, endpoint ? endpoint->getDate() : -1.0);
+            group.endRow();
+        }
+        return group;
+    }
+
+    /**
+     * @brief Add the rows of a disk operation trace to the "disk" group
+     */
+    template<class T>
+    void addDiskRows(ColumnGroup &group, wrench::SimulationOutput &output, const std::string &operation) {
+        for (auto const &timestamp : output.getTrace<T>()) {
+            auto start = timestamp->getContent();
+            auto endpoint = start->getEndpoint();
+            group.set(0, start->getHostname());
+            group.set(1, start->getMount());
+            group.set(2, operation);
+            group.set(3, start->getBytes());
+            group.set(4, timestamp->getDate());
+            group.set(5, endpoint ? endpoint->getDate() : -1.0);
+            group.endRow();
+        }
+    }
+
+    /**
+     * @brief Build the "disk" group: one row per disk read or write
+     */
+    ColumnGroup diskGroup(wrench::SimulationOutput &output) {
+        ColumnGroup group("disk");
+        for (auto const &column : {"hostname", "mount", "operation"}) {
+            group.addColumn(column, ColumnGroup::STRING);
+        }
+        group.addColumn("bytes", ColumnGroup::REAL);
+        group.addColumn("start", ColumnGroup::REAL);
+        group.addColumn("end", ColumnGroup::REAL);
+
+        addDiskRows<wrench::SimulationTimestampDiskReadStart>(group, output, "read");
+        addDiskRows<wrench::SimulationTimestampDiskWriteStart>(group, output, "write");
+        return group;
+    }
+
+    /**
+     * @brief Build the "links" group: one row per link usage sample (recorded by bandwidth meters)
+     */
+    ColumnGroup linkGroup(wrench::SimulationOutput &output) {
+        ColumnGroup group("links");
+        group.addColumn("linkname", ColumnGroup::STRING);
+        group.addColumn("time", ColumnGroup::REAL);
+        group.addColumn("bytes_per_second", ColumnGroup::REAL);
+
+        for (auto const &timestamp : output.getTrace<wrench::SimulationTimestampLinkUsage>()) {
+            group.set(0, timestamp->getContent()->getLinkname());
+            group.set(1, timestamp->getDate());
+            group.set(2, timestamp->getContent()->getUsage());
+            group.endRow();
+        }
+        return group;
+    }
+
+    /**
+     * @brief Write a body to a file, zlib-compressed
+     * @return true on success
+     */
+    bool writeCompressed(FILE *file, const std::string &body) {
+#ifdef EDUWRENCH_HAVE_ZLIB
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            return false;
+        }
+        unsigned char chunk[64 * 1024];
+        stream.next_in = (Bytef *) body.data();
+        stream.avail_in = (uInt) body.size();
+        int status;
+        do {
+            stream.next_out = chunk;
+            stream.avail_out = sizeof(chunk);
+            status = deflate(&stream, Z_FINISH);
+            size_t n = sizeof(chunk) - stream.avail_out;
+            if ((status == Z_STREAM_ERROR) or (fwrite(chunk, 1, n, file) != n)) {
+                deflateEnd(&stream);
+                return false;
+            }
+        } while (status != Z_STREAM_END);
+        deflateEnd(&stream);
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+/**
+ * @brief Enable the columnar output if a --columnar-output=<groups> argument is present, and
+ *        compress it if --columnar-compress is present (both are removed from argv)
+ *
+ * @param argc: pointer to the argument count (updated if flags are removed)
+ * @param argv: the arguments
+ *
+ * @throws std::invalid_argument
+ */
+void ColumnarOutput::init(int *argc, char **argv) {
+
+    int j = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (not strncmp(argv[i], COLUMNAR_OUTPUT_FLAG, strlen(COLUMNAR_OUTPUT_FLAG))) {
+            std::istringstream list(argv[i] + strlen(COLUMNAR_OUTPUT_FLAG));
+            std::string group;
+            while (std::getline(list, group, ',')) {
+                if ((group != "tasks") and (group != "file_transfers") and (group != "disk") and (group != "links")) {
+                    throw std::invalid_argument("ColumnarOutput::init(): unknown output group " + group);
+                }
+                groups.insert(group);
+            }
+            if (groups.empty()) {
+                throw std::invalid_argument("ColumnarOutput::init(): empty " COLUMNAR_OUTPUT_FLAG " argument");
+            }
+        } else if (not strcmp(argv[i], COLUMNAR_COMPRESS_FLAG)) {
+            compress = true;
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    *argc = j;
+    argv[j] = nullptr;
+
+#ifndef EDUWRENCH_HAVE_ZLIB
+    if (compress) {
+        std::cerr << "Warning: built without zlib, " COLUMNAR_COMPRESS_FLAG " is ignored" << std::endl;
+        compress = false;
+    }
+#endif
+}
+
+/**
+ * @brief Determine whether the columnar output is enabled (in which case it replaces the
+ *        unified JSON output)
+ * @return true or false
+ */
+bool ColumnarOutput::isEnabled() {
+    return not groups.empty();
+}
+
+/**
+ * @brief Write the requested groups of the simulation output
+ *
+ * @param simulation: the simulation (which must have completed)
+ * @param workflow: the workflow
+ * @param file_path: the output file path
+ *
+ * @throws std::runtime_error
+ */
+void ColumnarOutput::dump(wrench::Simulation &simulation, wrench::Workflow *workflow, const std::string &file_path) {
+
+    auto &output = simulation.getOutput();
+    std::vector<ColumnGroup> selected;
+    if (groups.count("tasks")) {
+        selected.push_back(taskGroup(workflow));
+    }
+    if (groups.count("file_transfers")) {
+        selected.push_back(fileTransferGroup(output));
+    }
+    if (groups.count("disk")) {
+        selected.push_back(diskGroup(output));
+    }
+    if (groups.count("links")) {
+        selected.push_back(linkGroup(output));
+    }
+
+    std::string body;
+    putU32(body, (uint32_t) selected.size());
+    for (auto const &group : selected) {
+        group.serialize(body);
+    }
+
+    std::string header("EWCOL");
+    putU8(header, COLUMNAR_VERSION);
+    putU8(header, compress ? COLUMNAR_FLAG_ZLIB : 0);
+    putU8(header, 0);
+
+    FILE *file = fopen(file_path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("ColumnarOutput::dump(): cannot open " + file_path);
+    }
+    bool ok = (fwrite(header.data(), 1, header.size(), file) == header.size());
+    if (ok) {
+        ok = compress ? writeCompressed(file, body) : (fwrite(body.data(), 1, body.size(), file) == body.size());
+    }
+    if ((fclose(file) != 0) or (not ok)) {
+        throw std::runtime_error("ColumnarOutput::dump(): cannot write " + file_path);
+    }
+}
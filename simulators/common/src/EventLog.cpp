@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <simgrid/s4u.hpp>
+
+#include "EventLog.h"
+#include "OutputDirectory.h"
+
+#define EVENT_LOG_FLAG "--event-log"
+#define EVENT_LOG_BUFFER_SIZE (1024 * 1024)
+
+FILE *EventLog::file = nullptr;
+
+/**
+ * @brief Enable the event log if a --event-log argument is present (it is removed from argv).
+ *        Must be called after OutputDirectory::init().
+ *
+ * @param argc: pointer to the argument count (updated if the flag is removed)
+ * @param argv: the arguments
+ *
+ * @throws std::runtime_error
+ */
+void EventLog::init(int *argc, char **argv) {
+
+    bool enabled = false;
+    int j = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (not strcmp(argv[i], EVENT_LOG_FLAG)) {
+            enabled = true;
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    *argc = j;
+    argv[j] = nullptr;
+
+    if (not enabled) {
+        return;
+    }
+
+    std::string path = OutputDirectory::path("events.jsonl");
+    file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        throw std::runtime_error("EventLog::init(): cannot open event log " + path);
+    }
+    setvbuf(file, nullptr, _IOFBF, EVENT_LOG_BUFFER_SIZE);
+    atexit(EventLog::close);
+}
+
+/**
+ * @brief Determine whether the event log is enabled
+ * @return true or false
+ */
+bool EventLog::isEnabled() {
+    return file != nullptr;
+}
+
+/**
+ * @brief Record an event, stamped with the current simulated date and the calling actor and its host
+ *
+ * @param event: the event type (e.g., "job_submission")
+ * @param fields: additional fields (e.g., the ids of the tasks or files involved)
+ */
+void EventLog::record(const std::string &event, const nlohmann::json &fields) {
+    if (file == nullptr) {
+        return;
+    }
+
+    nlohmann::json line = {
+            {"time",  simgrid::s4u::Engine::get_clock()},
+            {"host",  simgrid::s4u::this_actor::get_host()->get_name()},
+            {"actor", simgrid::s4u::this_actor::get_name()},
+            {"event", event}
+    };
+    for (auto const &field : fields.items()) {
+        line[field.key()] = field.value();
+    }
+    std::string text = line.dump();
+    fwrite(text.c_str(), 1, text.size(), file);
+    fputc('\n', file);
+}
+
+/**
+ * @brief Get the ids of a list of tasks, as a JSON array
+ *
+ * @param tasks: the tasks
+ * @return a JSON array
+ */
+nlohmann::json EventLog::taskIDs(const std::vector<wrench::WorkflowTask *> &tasks) {
+    nlohmann::json ids = nlohmann::json::array();
+    for (auto const &task : tasks) {
+        ids.push_back(task->getID());
+    }
+    return ids;
+}
+
+/**
+ * @brief Flush and close the event log (registered with atexit())
+ */
+void EventLog::close() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
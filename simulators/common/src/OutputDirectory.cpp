@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OutputDirectory.h"
+
+#define OUTPUT_DIR_FLAG "--output-dir="
+
+std::string OutputDirectory::directory;
+bool OutputDirectory::created = false;
+
+/**
+ * @brief Set up the output directory of this process. If a --output-dir=<path> argument is
+ *        present, it is removed from argv and the directory is created if needed. Otherwise a
+ *        fresh directory is created under $TMPDIR (or /tmp) and its path is reported on stderr.
+ *        That directory is removed when the process exits if nothing was written to it;
+ *        otherwise it is left for the caller to remove.
+ *
+ * @param argc: pointer to the argument count (updated if the flag is removed)
+ * @param argv: the arguments
+ * @param simulator_name: the simulator name, used to name a derived directory
+ * @return the output directory path
+ *
+ * @throws std::runtime_error
+ */
+std::string OutputDirectory::init(int *argc, char **argv, const std::string &simulator_name) {
+
+    std::string requested;
+    int j = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (not strncmp(argv[i], OUTPUT_DIR_FLAG, strlen(OUTPUT_DIR_FLAG))) {
+            requested = std::string(argv[i] + strlen(OUTPUT_DIR_FLAG));
+            if (requested.empty()) {
+                throw std::runtime_error("OutputDirectory::init(): empty " OUTPUT_DIR_FLAG " argument");
+            }
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    *argc = j;
+    argv[j] = nullptr;
+
+    if (not requested.empty()) {
+        if ((mkdir(requested.c_str(), 0700) != 0) and (errno != EEXIST)) {
+            throw std::runtime_error("OutputDirectory::init(): cannot create directory " + requested +
+                                     " (" + strerror(errno) + ")");
+        }
+        directory = requested;
+        created = false;
+    } else {
+        const char *tmpdir = getenv("TMPDIR");
+        std::string pattern = std::string((tmpdir and *tmpdir) ? tmpdir : "/tmp") +
+                              "/eduwrench_" + simulator_name + "_XXXXXX";
+        std::vector<char> buffer(pattern.begin(), pattern.end());
+        buffer.push_back('\0');
+        if (mkdtemp(buffer.data()) == nullptr) {
+            throw std::runtime_error("OutputDirectory::init(): cannot create directory " + pattern +
+                                     " (" + strerror(errno) + ")");
+        }
+        directory = std::string(buffer.data());
+        std::cerr << "Output directory: " << directory << std::endl;
+        if (not created) {
+            atexit(removeIfEmpty);
+        }
+        created = true;
+    }
+
+    return directory;
+}
+
+/**
+ * @brief Remove the output directory created by OutputDirectory::init() if it is empty
+ *        (registered with atexit())
+ */
+void OutputDirectory::removeIfEmpty() {
+    if (created) {
+        // rmdir() fails, leaving the directory in place, if anything was written to it
+        rmdir(directory.c_str());
+    }
+}
+
+/**
+ * @brief Get the output directory (OutputDirectory::init() must have been called)
+ * @return a directory path
+ *
+ * @throws std::runtime_error
+ */
+std::string OutputDirectory::get() {
+    if (directory.empty()) {
+        throw std::runtime_error("OutputDirectory::get(): the output directory has not been initialized");
+    }
+    return directory;
+}
+
+/**
+ * @brief Get the path of a file in the output directory
+ *
+ * @param file_name: the file name
+ * @return a file path
+ *
+ * @throws std::runtime_error
+ */
+std::string OutputDirectory::path(const std::string &file_name) {
+    return get() + "/" + file_name;
+}
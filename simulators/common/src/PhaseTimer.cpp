@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include <simgrid/s4u.hpp>
+
+#include "PhaseTimer.h"
+
+#define PROFILE_FLAG "--profile"
+#define PROFILE_ENV "EDUWRENCH_PROFILE"
+#define PROFILE_PREFIX "EDUWRENCH_PROFILE "
+
+bool PhaseTimer::enabled = false;
+std::string PhaseTimer::simulator_name;
+std::string PhaseTimer::current_phase;
+std::chrono::steady_clock::time_point PhaseTimer::current_phase_start;
+std::vector<PhaseTimer::Phase> PhaseTimer::phases;
+unsigned long PhaseTimer::num_simulated_events = 0;
+unsigned long PhaseTimer::num_actors = 0;
+double PhaseTimer::simulated_time = 0;
+
+/**
+ * @brief Enable profiling if a --profile argument is present (it is removed from argv) or if
+ *        the EDUWRENCH_PROFILE environment variable is set, and start the "arguments" phase
+ *
+ * @param argc: pointer to the argument count (updated if the flag is removed)
+ * @param argv: the arguments
+ * @param simulator_name: the simulator name (reported in the summary)
+ */
+void PhaseTimer::init(int *argc, char **argv, const std::string &simulator_name) {
+
+    int j = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (not strcmp(argv[i], PROFILE_FLAG)) {
+            enabled = true;
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    *argc = j;
+    argv[j] = nullptr;
+
+    const char *env = getenv(PROFILE_ENV);
+    if ((env != nullptr) and strcmp(env, "") and strcmp(env, "0")) {
+        enabled = true;
+    }
+    if (not enabled) {
+        return;
+    }
+
+    PhaseTimer::simulator_name = simulator_name;
+    simgrid::s4u::Engine::on_time_advance.connect([](double delta) {
+        num_simulated_events++;
+        simulated_time += delta;
+    });
+    simgrid::s4u::Actor::on_creation.connect([](simgrid::s4u::Actor &) { num_actors++; });
+    atexit(PhaseTimer::report);
+
+    start("arguments");
+}
+
+/**
+ * @brief End the current phase (if any) and start a new one
+ *
+ * @param phase: the phase name
+ */
+void PhaseTimer::start(const std::string &phase) {
+    if (not enabled) {
+        return;
+    }
+    endPhase();
+    current_phase = phase;
+    current_phase_start = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief End the current phase (if any)
+ */
+void PhaseTimer::endPhase() {
+    if (current_phase.empty()) {
+        return;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - current_phase_start;
+    struct rusage usage;
+    long peak_rss_kb = (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : -1;
+    phases.push_back(Phase{current_phase, elapsed.count(), peak_rss_kb});
+    current_phase.clear();
+}
+
+/**
+ * @brief End the current phase and print the summary line (called at exit)
+ */
+void PhaseTimer::report() {
+    endPhase();
+
+    nlohmann::json summary;
+    summary["simulator"] = simulator_name;
+    summary["pid"] = getpid();
+    summary["phases"] = nlohmann::json::array();
+    for (auto const &phase : phases) {
+        summary["phases"].push_back({{"name",        phase.name},
+                                     {"wall_time",   phase.wall_time},
+                                     {"peak_rss_kb", phase.peak_rss_kb}});
+    }
+    summary["simulated_events"] = num_simulated_events;
+    summary["actors"] = num_actors;
+    summary["simulated_time"] = simulated_time;
+
+    std::cerr << PROFILE_PREFIX << summary.dump() << std::endl;
+}
@@ -0,0 +1,387 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "OutputDirectory.h"
+#include "PlatformBuilder.h"
+
+#define PLATFORM_CACHE_ENV "EDUWRENCH_PLATFORM_CACHE"
+// total size of the platform files kept in the cache directory
+#define PLATFORM_CACHE_MAX_BYTES (64UL * 1024 * 1024)
+// platform files not used for this long (in seconds) are removed
+#define PLATFORM_CACHE_MAX_AGE (7 * 24 * 3600)
+// platform files used more recently than this (in seconds) may be about to be read, and are kept
+#define PLATFORM_CACHE_MIN_AGE 600
+
+/**
+ * @brief Escape a string for use in an XML attribute value
+ * @param value: the string
+ * @return the escaped string
+ */
+static std::string escape(const std::string &value) {
+    std::string escaped;
+    for (char c : value) {
+        switch (c) {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            default:
+                escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of a string
+ * @param value: the string
+ * @return the hash
+ */
+static uint64_t fnv1a(const std::string &value) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : value) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Set a property of the host (e.g., "ram")
+ * @param name: the property name
+ * @param value: the property value
+ * @return the host
+ */
+PlatformBuilder::Host &PlatformBuilder::Host::setProperty(const std::string &name, const std::string &value) {
+    properties[name] = value;
+    return *this;
+}
+
+/**
+ * @brief Set the initial pstate of the host, for a host with several speeds (e.g., "100Gf,50Gf")
+ *        and a "wattage_per_state" property
+ * @param pstate: the pstate index
+ * @return the host
+ */
+PlatformBuilder::Host &PlatformBuilder::Host::setPState(int pstate) {
+    this->pstate = pstate;
+    return *this;
+}
+
+/**
+ * @brief Add a disk to the host
+ * @param id: the disk id
+ * @param read_bw: the read bandwidth (e.g., "50MBps")
+ * @param write_bw: the write bandwidth (e.g., "50MBps")
+ * @param size: the disk capacity (e.g., "5000GiB")
+ * @param mount: the mount point
+ * @return the host
+ */
+PlatformBuilder::Host &PlatformBuilder::Host::addDisk(const std::string &id, const std::string &read_bw,
+                                                      const std::string &write_bw, const std::string &size,
+                                                      const std::string &mount) {
+    disks.push_back(Disk{id, read_bw, write_bw, size, mount});
+    return *this;
+}
+
+/**
+ * @brief Constructor
+ * @param id: the zone id
+ * @param routing: the zone routing (e.g., "Full")
+ */
+PlatformBuilder::Zone::Zone(const std::string &id, const std::string &routing) : id(id), routing(routing) {
+}
+
+/**
+ * @brief Add a host to the zone
+ * @param id: the host name
+ * @param speed: the core speed (e.g., "100Gf")
+ * @param cores: the number of cores
+ * @return the host (valid until the next host is added)
+ */
+PlatformBuilder::Host &PlatformBuilder::Zone::addHost(const std::string &id, const std::string &speed, int cores) {
+    hosts.push_back(Host{id, speed, cores, -1, {}, {}});
+    return hosts.back();
+}
+
+/**
+ * @brief Add a router to the zone
+ * @param id: the router name
+ */
+void PlatformBuilder::Zone::addRouter(const std::string &id) {
+    routers.push_back(id);
+}
+
+/**
+ * @brief Add a sub-zone to the zone
+ * @param id: the sub-zone id
+ * @param routing: the sub-zone routing
+ * @return the sub-zone (valid until the next sub-zone is added)
+ */
+PlatformBuilder::Zone &PlatformBuilder::Zone::addZone(const std::string &id, const std::string &routing) {
+    zones.emplace_back(id, routing);
+    return zones.back();
+}
+
+/**
+ * @brief Add a link to the zone
+ * @param id: the link name
+ * @param bandwidth: the link bandwidth (e.g., "100MBps")
+ * @param latency: the link latency (e.g., "10us")
+ * @return the link
+ */
+PlatformBuilder::Link &PlatformBuilder::Zone::addLink(const std::string &id, const std::string &bandwidth,
+                                                      const std::string &latency) {
+    links.push_back(Link{id, bandwidth, latency});
+    return links.back();
+}
+
+/**
+ * @brief Add a (symmetrical) route between two hosts or routers of the zone
+ * @param src: the source
+ * @param dst: the destination
+ * @param links: the names of the links of the route
+ * @return the route
+ */
+PlatformBuilder::Route &PlatformBuilder::Zone::addRoute(const std::string &src, const std::string &dst,
+                                                        const std::vector<std::string> &links) {
+    routes.push_back(Route{src, dst, links});
+    return routes.back();
+}
+
+/**
+ * @brief Add a (symmetrical) route between two sub-zones of the zone
+ * @param src: the source zone
+ * @param dst: the destination zone
+ * @param gw_src: the gateway in the source zone
+ * @param gw_dst: the gateway in the destination zone
+ * @param links: the names of the links of the route
+ * @return the route
+ */
+PlatformBuilder::ZoneRoute &PlatformBuilder::Zone::addZoneRoute(const std::string &src, const std::string &dst,
+                                                                const std::string &gw_src,
+                                                                const std::string &gw_dst,
+                                                                const std::vector<std::string> &links) {
+    zone_routes.push_back(ZoneRoute{src, dst, gw_src, gw_dst, links});
+    return zone_routes.back();
+}
+
+/**
+ * @brief Serialize a platform to SimGrid XML (the same platform always gives the same string)
+ * @param platform: the top-level zone of the platform
+ * @return the XML platform description
+ */
+std::string PlatformBuilder::toXML(const Zone &platform) {
+    std::string xml = "<?xml version='1.0'?>\n"
+                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
+                      "<platform version=\"4.1\">\n";
+    zoneToXML(platform, "   ", xml);
+    xml += "</platform>\n";
+    return xml;
+}
+
+/**
+ * @brief Serialize a zone (and its sub-zones) to SimGrid XML
+ * @param zone: the zone
+ * @param indent: the indentation of the zone element
+ * @param xml: the string to append to
+ */
+void PlatformBuilder::zoneToXML(const Zone &zone, const std::string &indent, std::string &xml) {
+    const std::string in = indent + "   ";
+
+    xml += indent + "<zone id=\"" + escape(zone.id) + "\" routing=\"" + escape(zone.routing) + "\">\n";
+
+    for (auto const &host : zone.hosts) {
+        xml += in + "<host id=\"" + escape(host.id) + "\" speed=\"" + escape(host.speed) +
+               (host.pstate >= 0 ? "\" pstate=\"" + std::to_string(host.pstate) : "") +
+               "\" core=\"" + std::to_string(host.cores) + "\">\n";
+        for (auto const &property : host.properties) {
+            xml += in + "   <prop id=\"" + escape(property.first) + "\" value=\"" + escape(property.second) + "\"/>\n";
+        }
+        for (auto const &disk : host.disks) {
+            xml += in + "   <disk id=\"" + escape(disk.id) + "\" read_bw=\"" + escape(disk.read_bw) +
+                   "\" write_bw=\"" + escape(disk.write_bw) + "\">\n";
+            xml += in + "      <prop id=\"size\" value=\"" + escape(disk.size) + "\"/>\n";
+            xml += in + "      <prop id=\"mount\" value=\"" + escape(disk.mount) + "\"/>\n";
+            xml += in + "   </disk>\n";
+        }
+        xml += in + "</host>\n";
+    }
+
+    for (auto const &router : zone.routers) {
+        xml += in + "<router id=\"" + escape(router) + "\"/>\n";
+    }
+
+    for (auto const &sub_zone : zone.zones) {
+        zoneToXML(sub_zone, in, xml);
+    }
+
+    for (auto const &link : zone.links) {
+        xml += in + "<link id=\"" + escape(link.id) + "\" bandwidth=\"" + escape(link.bandwidth) +
+               "\" latency=\"" + escape(link.latency) + "\"/>\n";
+    }
+
+    for (auto const &route : zone.routes) {
+        xml += in + "<route src=\"" + escape(route.src) + "\" dst=\"" + escape(route.dst) + "\">\n";
+        for (auto const &link : route.links) {
+            xml += in + "   <link_ctn id=\"" + escape(link) + "\"/>\n";
+        }
+        xml += in + "</route>\n";
+    }
+
+    for (auto const &route : zone.zone_routes) {
+        xml += in + "<zoneRoute src=\"" + escape(route.src) + "\" dst=\"" + escape(route.dst) +
+               "\" gw_src=\"" + escape(route.gw_src) + "\" gw_dst=\"" + escape(route.gw_dst) + "\">\n";
+        for (auto const &link : route.links) {
+            xml += in + "   <link_ctn id=\"" + escape(link) + "\"/>\n";
+        }
+        xml += in + "</zoneRoute>\n";
+    }
+
+    xml += indent + "</zone>\n";
+}
+
+/**
+ * @brief Get the path of a platform file describing a platform. The file is named after a hash
+ *        of the platform's XML serialization in the platform cache directory, and is only written
+ *        if it is not already there (atomically, so that concurrent runs never read a partial
+ *        file), after which the cache is trimmed (see evict()). If the cache directory cannot be
+ *        used, the file is written to the output directory instead.
+ *
+ * @param platform: the top-level zone of the platform
+ * @return the path of the platform file
+ *
+ * @throws std::runtime_error
+ */
+std::string PlatformBuilder::cache(const Zone &platform) {
+    std::string xml = toXML(platform);
+
+    std::string directory = cacheDirectory();
+    if ((mkdir(directory.c_str(), 0700) == 0) or (errno == EEXIST)) {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.xml", (unsigned long long) fnv1a(xml));
+        std::string path = directory + "/" + name;
+
+        struct stat st;
+        if ((stat(path.c_str(), &st) == 0) and (st.st_size == (off_t) xml.size())) {
+            // mark the file as recently used
+            utimes(path.c_str(), nullptr);
+            return path;
+        }
+
+        std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+        if (writeFile(tmp_path, xml) and (rename(tmp_path.c_str(), path.c_str()) == 0)) {
+            evict(directory);
+            return path;
+        }
+        unlink(tmp_path.c_str());
+    }
+
+    std::string path = OutputDirectory::path("platform.xml");
+    if (not writeFile(path, xml)) {
+        throw std::runtime_error("PlatformBuilder::cache(): cannot write platform file " + path);
+    }
+    return path;
+}
+
+/**
+ * @brief Trim the platform cache directory: remove the platform files (and leftover temporary
+ *        files) not used for PLATFORM_CACHE_MAX_AGE, then the least recently used platform files
+ *        until the cache holds at most PLATFORM_CACHE_MAX_BYTES. Files used in the last
+ *        PLATFORM_CACHE_MIN_AGE are never removed, since a concurrent run may be about to read them.
+ *
+ * @param directory: the cache directory
+ */
+void PlatformBuilder::evict(const std::string &directory) {
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+
+    time_t now = time(nullptr);
+    std::vector<std::tuple<time_t, off_t, std::string>> files;
+    unsigned long total_bytes = 0;
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != nullptr) {
+        std::string name(dirent->d_name);
+        std::string path = directory + "/" + name;
+        struct stat st;
+        if ((name.find(".xml") == std::string::npos) or (stat(path.c_str(), &st) != 0) or
+            (not S_ISREG(st.st_mode))) {
+            continue;
+        }
+        if (now - st.st_mtime > PLATFORM_CACHE_MAX_AGE) {
+            unlink(path.c_str());
+            continue;
+        }
+        if (name.find(".tmp.") == std::string::npos) {
+            files.emplace_back(st.st_mtime, st.st_size, path);
+            total_bytes += st.st_size;
+        }
+    }
+    closedir(dir);
+
+    std::sort(files.begin(), files.end());
+    for (auto const &file : files) {
+        if ((total_bytes <= PLATFORM_CACHE_MAX_BYTES) or (now - std::get<0>(file) < PLATFORM_CACHE_MIN_AGE)) {
+            break;
+        }
+        unlink(std::get<2>(file).c_str());
+        total_bytes -= std::get<1>(file);
+    }
+}
+
+/**
+ * @brief Get the platform cache directory
+ * @return a directory path
+ */
+std::string PlatformBuilder::cacheDirectory() {
+    const char *env = getenv(PLATFORM_CACHE_ENV);
+    if (env and *env) {
+        return std::string(env);
+    }
+    const char *tmpdir = getenv("TMPDIR");
+    return std::string((tmpdir and *tmpdir) ? tmpdir : "/tmp") + "/eduwrench_platforms";
+}
+
+/**
+ * @brief Write a string to a file
+ * @param path: the file path
+ * @param content: the file content
+ * @return true on success, false otherwise
+ */
+bool PlatformBuilder::writeFile(const std::string &path, const std::string &content) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = (fwrite(content.data(), 1, content.size(), file) == content.size());
+    return (fclose(file) == 0) and written;
+}
@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Statistics.h"
+
+/**
+ * @brief Get a percentile of sorted values (nearest rank)
+ *
+ * @param sorted_values: the values, in increasing order
+ * @param percentile: the percentile, in [0,100]
+ * @return the percentile value
+ *
+ * @throws std::invalid_argument
+ */
+double Statistics::percentile(const std::vector<double> &sorted_values, double percentile) {
+    if (sorted_values.empty()) {
+        throw std::invalid_argument("Statistics::percentile(): no values");
+    }
+    auto rank = (unsigned long) std::ceil(percentile / 100.0 * sorted_values.size());
+    return sorted_values[std::min<unsigned long>(std::max<unsigned long>(rank, 1), sorted_values.size()) - 1];
+}
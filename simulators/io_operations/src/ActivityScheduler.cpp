@@ -1,5 +1,6 @@
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -57,6 +58,8 @@ namespace wrench {
         }
         auto job = this->getJobManager()->createStandardJob(tasks_to_submit, file_locations);
         this->getJobManager()->submitJob(job, compute_service, service_specific_args);
+        EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                            {"compute_service", compute_service->getHostname()}});
 
     }
 }
@@ -0,0 +1,404 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <nlohmann/json.hpp>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Launcher.h"
+
+#define MAX_REQUEST_SIZE (1024 * 1024)
+#define READ_BUFFER_SIZE (64 * 1024)
+#define MAX_CACHED_OUTPUT_SIZE (64 * 1024 * 1024)
+#define OUTPUT_DIR_FLAG "--output-dir="
+
+/**
+ * @brief Write a whole buffer to a socket
+ *
+ * @param fd: the socket
+ * @param data: the data
+ * @return true on success, false if the peer has gone away
+ */
+static bool sendAll(int fd, const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+/**
+ * @brief Send one JSON message (a single line) to the client
+ *
+ * @param fd: the socket
+ * @param message: the message
+ * @return true on success, false if the peer has gone away
+ */
+static bool sendMessage(int fd, const nlohmann::json &message) {
+    return sendAll(fd, message.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) + "\n");
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param socket_path: the path of the Unix socket to listen on
+ * @param simulators_dir: the directory under which all executables must be located
+ * @param max_jobs: the maximum number of simulators running at the same time
+ * @param cache: the result cache (nullptr if results should not be cached)
+ *
+ * @throws std::invalid_argument
+ */
+Launcher::Launcher(const std::string &socket_path, const std::string &simulators_dir, unsigned long max_jobs,
+                   std::unique_ptr<ResultCache> cache) :
+        socket_path(socket_path), max_jobs(max_jobs), cache(std::move(cache)) {
+
+    if (socket_path.size() >= sizeof(((struct sockaddr_un *) nullptr)->sun_path)) {
+        throw std::invalid_argument("Launcher::Launcher(): socket path too long: " + socket_path);
+    }
+    if (max_jobs < 1) {
+        throw std::invalid_argument("Launcher::Launcher(): the maximum number of jobs must be at least 1");
+    }
+
+    char resolved[PATH_MAX];
+    if (realpath(simulators_dir.c_str(), resolved) == nullptr) {
+        throw std::invalid_argument("Launcher::Launcher(): invalid simulators directory " + simulators_dir);
+    }
+    this->simulators_dir = std::string(resolved);
+}
+
+/**
+ * @brief Accept connections forever, forking a handler for each of them (at most max_jobs at a time)
+ *
+ * @throws std::runtime_error
+ */
+void Launcher::run() {
+
+    signal(SIGPIPE, SIG_IGN);
+
+    // remove a socket left over by a previous instance
+    struct stat st;
+    if ((lstat(this->socket_path.c_str(), &st) == 0) and S_ISSOCK(st.st_mode)) {
+        unlink(this->socket_path.c_str());
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error("Launcher::run(): cannot create socket (" + std::string(strerror(errno)) + ")");
+    }
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, this->socket_path.c_str(), sizeof(address.sun_path) - 1);
+    if (bind(listen_fd, (struct sockaddr *) &address, sizeof(address)) != 0) {
+        throw std::runtime_error("Launcher::run(): cannot bind " + this->socket_path +
+                                 " (" + std::string(strerror(errno)) + ")");
+    }
+    chmod(this->socket_path.c_str(), 0600);
+    if (listen(listen_fd, 128) != 0) {
+        throw std::runtime_error("Launcher::run(): cannot listen (" + std::string(strerror(errno)) + ")");
+    }
+
+    std::cerr << "Launcher listening on " << this->socket_path << " (simulators in " << this->simulators_dir
+              << ", at most " << this->max_jobs << " concurrent runs)" << std::endl;
+
+    unsigned long num_running = 0;
+    while (true) {
+        // reap finished handlers, and wait for one if all slots are taken
+        while ((num_running > 0) and (waitpid(-1, nullptr, WNOHANG) > 0)) {
+            num_running--;
+        }
+        while (num_running >= this->max_jobs) {
+            if (waitpid(-1, nullptr, 0) > 0) {
+                num_running--;
+            } else if (errno != EINTR) {
+                num_running = 0;
+            }
+        }
+
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if ((errno != EINTR) and (errno != ECONNABORTED)) {
+                std::cerr << "accept(): " << strerror(errno) << std::endl;
+            }
+            continue;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "fork(): " << strerror(errno) << std::endl;
+            sendMessage(fd, {{"error", "the launcher could not fork a handler"}});
+            close(fd);
+            continue;
+        }
+        if (pid == 0) {
+            close(listen_fd);
+            this->serveConnection(fd);
+            close(fd);
+            _exit(0);
+        }
+        close(fd);
+        num_running++;
+    }
+}
+
+/**
+ * @brief Handle one client connection: read the request, run the simulator, stream back its output
+ *
+ * @param fd: the client socket
+ */
+void Launcher::serveConnection(int fd) {
+
+    // read the request line
+    std::string request_line;
+    char buffer[READ_BUFFER_SIZE];
+    while (request_line.find('\n') == std::string::npos) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 and errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        request_line.append(buffer, n);
+        if (request_line.size() > MAX_REQUEST_SIZE) {
+            sendMessage(fd, {{"error", "request too large"}});
+            return;
+        }
+    }
+
+    std::string executable;
+    std::vector<std::string> args;
+    bool use_cache = false;
+    try {
+        auto request = nlohmann::json::parse(request_line.substr(0, request_line.find('\n')));
+        executable = this->checkExecutable(request.at("executable").get<std::string>());
+        if (request.contains("args")) {
+            args = request.at("args").get<std::vector<std::string>>();
+        }
+        use_cache = request.value("cache", false) and (this->cache != nullptr);
+    } catch (std::exception &e) {
+        sendMessage(fd, {{"error", std::string("invalid request: ") + e.what()}});
+        return;
+    }
+
+    if (not use_cache) {
+        int exit_status = this->runSimulator(fd, executable, args, nullptr, nullptr);
+        if (exit_status != INT_MIN) {
+            sendMessage(fd, {{"exit_status", exit_status}});
+        }
+        return;
+    }
+
+    std::string output_dir;
+    for (auto const &arg : args) {
+        if (not arg.compare(0, strlen(OUTPUT_DIR_FLAG), OUTPUT_DIR_FLAG)) {
+            output_dir = arg.substr(strlen(OUTPUT_DIR_FLAG));
+        }
+    }
+
+    std::string key;
+    try {
+        key = ResultCache::makeKey(executable, args, output_dir);
+    } catch (std::invalid_argument &e) {
+        sendMessage(fd, {{"error", std::string("invalid request: ") + e.what()}});
+        return;
+    }
+
+    std::string captured_stdout, captured_stderr;
+    if (this->cache->lookup(key, output_dir, captured_stdout, captured_stderr)) {
+        if ((captured_stdout.empty() or sendMessage(fd, {{"stream", "stdout"}, {"data", captured_stdout}})) and
+            (captured_stderr.empty() or sendMessage(fd, {{"stream", "stderr"}, {"data", captured_stderr}}))) {
+            sendMessage(fd, {{"exit_status", 0}, {"cached", true}});
+        }
+        return;
+    }
+
+    auto input_files = ResultCache::listFiles(output_dir);
+    int exit_status = this->runSimulator(fd, executable, args, &captured_stdout, &captured_stderr);
+    if (exit_status == INT_MIN) {
+        return;
+    }
+    sendMessage(fd, {{"exit_status", exit_status}});
+    if ((exit_status == 0) and (captured_stdout.size() + captured_stderr.size() <= MAX_CACHED_OUTPUT_SIZE)) {
+        this->cache->store(key, output_dir, input_files, captured_stdout, captured_stderr);
+    }
+}
+
+/**
+ * @brief Check that an executable is located under the simulators directory
+ *
+ * @param executable: the executable path
+ * @return the resolved executable path
+ *
+ * @throws std::invalid_argument
+ */
+std::string Launcher::checkExecutable(const std::string &executable) {
+    char resolved[PATH_MAX];
+    if (realpath(executable.c_str(), resolved) == nullptr) {
+        throw std::invalid_argument("unknown executable " + executable);
+    }
+    std::string path(resolved);
+    if ((path.compare(0, this->simulators_dir.size() + 1, this->simulators_dir + "/") != 0) or
+        (access(path.c_str(), X_OK) != 0)) {
+        throw std::invalid_argument("executable " + executable + " is not a simulator");
+    }
+    return path;
+}
+
+/**
+ * @brief Run a simulator, sending its output to the client line by line
+ *
+ * @param fd: the client socket
+ * @param executable: the executable path
+ * @param args: the arguments
+ * @param captured_stdout: if not nullptr, where to append the simulator's stdout
+ * @param captured_stderr: if not nullptr, where to append the simulator's stderr
+ * @return the simulator's exit status (128 + signal number if it was killed), or INT_MIN if
+ *         the client went away
+ */
+int Launcher::runSimulator(int fd, const std::string &executable, const std::vector<std::string> &args,
+                           std::string *captured_stdout, std::string *captured_stderr) {
+
+    int out_pipe[2], err_pipe[2];
+    if ((pipe(out_pipe) != 0) or (pipe(err_pipe) != 0)) {
+        sendMessage(fd, {{"error", "the launcher could not create pipes"}});
+        return INT_MIN;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        sendMessage(fd, {{"error", "the launcher could not fork the simulator"}});
+        return INT_MIN;
+    }
+
+    if (pid == 0) {
+        dup2(out_pipe[1], STDOUT_FILENO);
+        dup2(err_pipe[1], STDERR_FILENO);
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        close(err_pipe[0]);
+        close(err_pipe[1]);
+        close(fd);
+        signal(SIGPIPE, SIG_DFL);
+
+        std::vector<char *> argv;
+        argv.push_back(const_cast<char *>(executable.c_str()));
+        for (auto const &arg : args) {
+            argv.push_back(const_cast<char *>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        execv(executable.c_str(), argv.data());
+        fprintf(stderr, "Cannot execute %s: %s\n", executable.c_str(), strerror(errno));
+        _exit(127);
+    }
+
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+
+    // forward complete lines as they come (so that no message splits a multi-byte character),
+    // and watch the client socket so that the simulator is killed if the client goes away
+    struct pollfd fds[3] = {{out_pipe[0], POLLIN, 0},
+                            {err_pipe[0], POLLIN, 0},
+                            {fd,          POLLIN, 0}};
+    const char *stream_names[2] = {"stdout", "stderr"};
+    std::string *captured[2] = {captured_stdout, captured_stderr};
+    std::string pending[2];
+    char buffer[READ_BUFFER_SIZE];
+    bool client_gone = false;
+    int num_open = 2;
+
+    while ((num_open > 0) and (not client_gone)) {
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[2].revents) {
+            // the client never sends anything after its request, so this is a disconnection
+            ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n <= 0 and not (n < 0 and (errno == EAGAIN or errno == EINTR))) {
+                client_gone = true;
+                break;
+            }
+        }
+        for (int i = 0; i < 2; i++) {
+            if (fds[i].fd < 0 or not fds[i].revents) {
+                continue;
+            }
+            ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+            if (n < 0 and errno == EINTR) {
+                continue;
+            }
+            if (n > 0) {
+                pending[i].append(buffer, n);
+                if (captured[i] and (captured[i]->size() <= MAX_CACHED_OUTPUT_SIZE)) {
+                    captured[i]->append(buffer, n);
+                }
+                auto last_newline = pending[i].rfind('\n');
+                if (last_newline == std::string::npos) {
+                    continue;
+                }
+                if (not sendMessage(fd, {{"stream", stream_names[i]},
+                                         {"data",   pending[i].substr(0, last_newline + 1)}})) {
+                    client_gone = true;
+                    break;
+                }
+                pending[i].erase(0, last_newline + 1);
+            } else {
+                if (not pending[i].empty()) {
+                    client_gone = not sendMessage(fd, {{"stream", stream_names[i]},
+                                                       {"data",   pending[i]}});
+                    pending[i].clear();
+                }
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                num_open--;
+            }
+        }
+    }
+
+    if (client_gone) {
+        kill(pid, SIGKILL);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (fds[i].fd >= 0) {
+            close(fds[i].fd);
+        }
+    }
+
+    int status;
+    while ((waitpid(pid, &status, 0) < 0) and (errno == EINTR));
+
+    if (client_gone) {
+        return INT_MIN;
+    }
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_LAUNCHER_H
+#define EDUWRENCH_LAUNCHER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ResultCache.h"
+
+/**
+ *  @brief A long-lived daemon that runs simulators on behalf of the web server.
+ *
+ *  Clients connect to a Unix socket and send one request per connection, as a single
+ *  line of JSON:
+ *
+ *      {"executable": "/path/to/simulators/io_operations/io_simulator", "args": ["10", ...]}
+ *
+ *  The executable must be located under the simulators directory. The launcher forks a
+ *  handler per connection, which runs the simulator and streams its output back as JSON
+ *  lines, one per line of output, followed by the exit status:
+ *
+ *      {"stream": "stderr", "data": "[0.000000][thehost:wms] Starting...\n"}
+ *      {"stream": "stdout", "data": "...\n"}
+ *      {"exit_status": 0}
+ *
+ *  A malformed request is answered with {"error": "<message>"}. If the client disconnects,
+ *  the simulator is killed.
+ *
+ *  A request for a deterministic simulator can add "cache": true, in which case the results of
+ *  successful runs are kept in a ResultCache, and identical runs are answered from it: the
+ *  cached output is streamed back, the cached result files are copied to the --output-dir
+ *  given in the arguments, and the final message is {"exit_status": 0, "cached": true}.
+ */
+class Launcher {
+public:
+    Launcher(const std::string &socket_path, const std::string &simulators_dir, unsigned long max_jobs,
+             std::unique_ptr<ResultCache> cache);
+
+    void run();
+
+private:
+    void serveConnection(int fd);
+    int runSimulator(int fd, const std::string &executable, const std::vector<std::string> &args,
+                     std::string *captured_stdout, std::string *captured_stderr);
+    std::string checkExecutable(const std::string &executable);
+
+    std::string socket_path;
+    std::string simulators_dir;
+    unsigned long max_jobs;
+    std::unique_ptr<ResultCache> cache;
+};
+
+#endif //EDUWRENCH_LAUNCHER_H
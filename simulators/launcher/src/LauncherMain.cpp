@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+#include "Launcher.h"
+
+#define DEFAULT_SOCKET_PATH "/tmp/eduwrench_launcher.sock"
+#define DEFAULT_CACHE_DIR "/tmp/eduwrench_launcher_cache"
+#define DEFAULT_CACHE_SIZE_MB 1024
+
+static void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--socket=<path>] [--simulators-dir=<path>] [--max-jobs=<n>]"
+                                         " [--cache-dir=<path>] [--cache-size=<MB>]" << std::endl;
+    std::cerr << "   socket: the Unix socket to listen on (default: " DEFAULT_SOCKET_PATH ")" << std::endl;
+    std::cerr << "   simulators-dir: the directory under which all simulators are located "
+                 "(default: the parent directory of the launcher's own directory)" << std::endl;
+    std::cerr << "   max-jobs: the maximum number of simulators running at the same time "
+                 "(default: the number of cores)" << std::endl;
+    std::cerr << "   cache-dir: the directory of the result cache (default: " DEFAULT_CACHE_DIR ")" << std::endl;
+    std::cerr << "   cache-size: the maximum size of the result cache in MB, 0 to disable caching (default: "
+              << DEFAULT_CACHE_SIZE_MB << ")" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    std::string socket_path = DEFAULT_SOCKET_PATH;
+    std::string simulators_dir;
+    long max_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    std::string cache_dir = DEFAULT_CACHE_DIR;
+    long cache_size_mb = DEFAULT_CACHE_SIZE_MB;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            if (not strncmp(argv[i], "--socket=", strlen("--socket="))) {
+                socket_path = std::string(argv[i] + strlen("--socket="));
+            } else if (not strncmp(argv[i], "--simulators-dir=", strlen("--simulators-dir="))) {
+                simulators_dir = std::string(argv[i] + strlen("--simulators-dir="));
+            } else if (not strncmp(argv[i], "--max-jobs=", strlen("--max-jobs="))) {
+                max_jobs = std::stol(std::string(argv[i] + strlen("--max-jobs=")));
+            } else if (not strncmp(argv[i], "--cache-dir=", strlen("--cache-dir="))) {
+                cache_dir = std::string(argv[i] + strlen("--cache-dir="));
+            } else if (not strncmp(argv[i], "--cache-size=", strlen("--cache-size="))) {
+                cache_size_mb = std::stol(std::string(argv[i] + strlen("--cache-size=")));
+            } else {
+                throw std::invalid_argument("unknown argument " + std::string(argv[i]));
+            }
+        }
+        if (max_jobs < 1) {
+            throw std::invalid_argument("invalid maximum number of jobs");
+        }
+        if (cache_size_mb < 0) {
+            throw std::invalid_argument("invalid cache size");
+        }
+    } catch (std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (simulators_dir.empty()) {
+        // the launcher is built in simulators/launcher/
+        char self[4096];
+        ssize_t n = readlink("/proc/self/exe", self, sizeof(self) - 1);
+        if (n < 0) {
+            std::cerr << "Cannot locate the simulators directory, use --simulators-dir" << std::endl;
+            return 1;
+        }
+        std::string path(self, n);
+        path = path.substr(0, path.rfind('/'));
+        simulators_dir = path.substr(0, path.rfind('/'));
+    }
+
+    try {
+        std::unique_ptr<ResultCache> cache;
+        if (cache_size_mb > 0) {
+            cache.reset(new ResultCache(cache_dir, (unsigned long) cache_size_mb * 1024 * 1024));
+        }
+        Launcher launcher(socket_path, simulators_dir, (unsigned long) max_jobs, std::move(cache));
+        launcher.run();
+    } catch (std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,396 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <ctime>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "ResultCache.h"
+
+#define OUTPUT_DIR_FLAG "--output-dir="
+// environment variables whose names start with this prefix may change the results of a run
+#define ENVIRONMENT_PREFIX "EDUWRENCH_"
+// unreferenced entry data directories younger than this (in seconds) may still be read by a lookup
+#define DATA_GRACE_PERIOD 60
+
+extern char **environ;
+
+/**
+ * @brief Read a whole file
+ *
+ * @param path: the file path
+ * @param content: the file content (output)
+ * @return true on success
+ */
+static bool readFile(const std::string &path, std::string &content) {
+    std::ifstream input(path, std::ios::binary);
+    if (not input.good()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << input.rdbuf();
+    content = buffer.str();
+    return true;
+}
+
+/**
+ * @brief Write a whole file
+ *
+ * @param path: the file path
+ * @param content: the file content
+ * @return true on success
+ */
+static bool writeFile(const std::string &path, const std::string &content) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output << content;
+    output.close();
+    return not output.fail();
+}
+
+/**
+ * @brief Copy a file
+ *
+ * @param src: the source path
+ * @param dst: the destination path
+ * @return true on success
+ */
+static bool copyFile(const std::string &src, const std::string &dst) {
+    std::string content;
+    return readFile(src, content) and writeFile(dst, content);
+}
+
+/**
+ * @brief Remove an entry data directory (and its "files" subdirectory)
+ *
+ * @param path: the directory path
+ */
+static void removeData(const std::string &path) {
+    for (auto const &name : ResultCache::listFiles(path + "/files")) {
+        unlink((path + "/files/" + name).c_str());
+    }
+    rmdir((path + "/files").c_str());
+    for (auto const &name : ResultCache::listFiles(path)) {
+        unlink((path + "/" + name).c_str());
+    }
+    rmdir(path.c_str());
+}
+
+/**
+ * @brief Remove a cache entry: the symbolic link, and the data directory it points to
+ *
+ * @param path: the entry path
+ */
+static void removeEntry(const std::string &path) {
+    char target[PATH_MAX];
+    ssize_t length = readlink(path.c_str(), target, sizeof(target) - 1);
+    if (length < 0) {
+        // an entry of an older cache, stored as a directory
+        removeData(path);
+        return;
+    }
+    target[length] = '\0';
+    unlink(path.c_str());
+    removeData(path.substr(0, path.rfind('/') + 1) + target);
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param directory: the cache directory (created if needed)
+ * @param max_bytes: the maximum total size of the cached entries
+ *
+ * @throws std::invalid_argument
+ */
+ResultCache::ResultCache(const std::string &directory, unsigned long max_bytes) :
+        directory(directory), max_bytes(max_bytes) {
+    if ((mkdir(directory.c_str(), 0700) != 0) and (errno != EEXIST)) {
+        throw std::invalid_argument("ResultCache::ResultCache(): cannot create cache directory " + directory +
+                                    " (" + strerror(errno) + ")");
+    }
+}
+
+/**
+ * @brief Build the canonical key of a simulator run: the executable (with its size and modification
+ *        date, so that rebuilding a simulator invalidates its entries), the EDUWRENCH_* environment
+ *        variables (e.g., EDUWRENCH_PROFILE, which adds a profile to stderr), and the arguments,
+ *        without the output directory. Arguments naming a file, or --<flag>=<file> arguments, also
+ *        add the file's content (files in the output directory, e.g., a JSON input file written
+ *        there by the server, by their relative path).
+ *
+ * @param executable: the (resolved) executable path
+ * @param args: the arguments
+ * @param output_dir: the output directory ("" if none)
+ * @return a key
+ *
+ * @throws std::invalid_argument
+ */
+std::string ResultCache::makeKey(const std::string &executable, const std::vector<std::string> &args,
+                                 const std::string &output_dir) {
+    struct stat st;
+    if (stat(executable.c_str(), &st) != 0) {
+        throw std::invalid_argument("ResultCache::makeKey(): cannot stat " + executable);
+    }
+
+    std::ostringstream key;
+    key << "executable " << executable.size() << ":" << executable << "\n";
+    key << "version " << st.st_size << ":" << st.st_mtim.tv_sec << "." << st.st_mtim.tv_nsec << "\n";
+
+    std::vector<std::string> environment;
+    for (char **variable = environ; *variable != nullptr; variable++) {
+        if (not strncmp(*variable, ENVIRONMENT_PREFIX, strlen(ENVIRONMENT_PREFIX))) {
+            environment.emplace_back(*variable);
+        }
+    }
+    std::sort(environment.begin(), environment.end());
+    for (auto const &variable : environment) {
+        key << "env " << variable.size() << ":" << variable << "\n";
+    }
+
+    for (auto const &arg : args) {
+        if (not arg.compare(0, strlen(OUTPUT_DIR_FLAG), OUTPUT_DIR_FLAG)) {
+            continue;
+        }
+        key << "arg " << arg.size() << ":" << arg << "\n";
+
+        std::string path = arg;
+        if ((not arg.compare(0, 2, "--")) and (arg.find('=') != std::string::npos)) {
+            path = arg.substr(arg.find('=') + 1);
+        }
+        if ((stat(path.c_str(), &st) != 0) or (not S_ISREG(st.st_mode))) {
+            continue;
+        }
+        std::string content;
+        if (not readFile(path, content)) {
+            throw std::invalid_argument("ResultCache::makeKey(): cannot read " + path);
+        }
+        if ((not output_dir.empty()) and (not path.compare(0, output_dir.size() + 1, output_dir + "/"))) {
+            path = path.substr(output_dir.size() + 1);
+        }
+        key << "file " << path.size() << ":" << path << " " << content.size() << ":" << content << "\n";
+    }
+    return key.str();
+}
+
+/**
+ * @brief Get the directory of the entry for a key (named after the 64-bit FNV-1a hash of the key)
+ *
+ * @param key: the key
+ * @return a path
+ */
+std::string ResultCache::entryPath(const std::string &key) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", hash);
+    return this->directory + "/" + name;
+}
+
+/**
+ * @brief Look up a run's results, and if found copy its result files to the output directory
+ *
+ * @param key: the run's key
+ * @param output_dir: the output directory of the new run ("" if none)
+ * @param stdout_data: the cached stdout content (output)
+ * @param stderr_data: the cached stderr content (output)
+ * @return true on a hit
+ */
+bool ResultCache::lookup(const std::string &key, const std::string &output_dir,
+                         std::string &stdout_data, std::string &stderr_data) {
+    // read the data directory the entry points to now, even if the entry is replaced meanwhile
+    char target[PATH_MAX];
+    ssize_t length = readlink(this->entryPath(key).c_str(), target, sizeof(target) - 1);
+    if (length < 0) {
+        return false;
+    }
+    target[length] = '\0';
+    std::string entry = this->directory + "/" + target;
+    std::string stored_key;
+    if ((not readFile(entry + "/key", stored_key)) or (stored_key != key)) {
+        return false;
+    }
+    if ((not readFile(entry + "/stdout", stdout_data)) or (not readFile(entry + "/stderr", stderr_data))) {
+        return false;
+    }
+    if (not output_dir.empty()) {
+        for (auto const &name : listFiles(entry + "/files")) {
+            if (not copyFile(entry + "/files/" + name, output_dir + "/" + name)) {
+                return false;
+            }
+        }
+    }
+    // mark the entry as recently used
+    utimes(entry.c_str(), nullptr);
+    return true;
+}
+
+/**
+ * @brief Store a successful run's results, then evict least recently used entries if the cache
+ *        is over its size limit
+ *
+ * @param key: the run's key
+ * @param output_dir: the output directory of the run ("" if none)
+ * @param input_files: the files that were in the output directory before the run (not stored)
+ * @param stdout_data: the stdout content
+ * @param stderr_data: the stderr content
+ */
+void ResultCache::store(const std::string &key, const std::string &output_dir,
+                        const std::vector<std::string> &input_files,
+                        const std::string &stdout_data, const std::string &stderr_data) {
+    std::string entry = this->entryPath(key);
+    std::string tmp = this->directory + "/tmp." + std::to_string(getpid());
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    std::string data = "data." + entry.substr(entry.rfind('/') + 1) + "." + std::to_string(getpid()) + "." +
+                       std::to_string(now.tv_sec) + "." + std::to_string(now.tv_nsec);
+    std::string link = this->directory + "/link." + std::to_string(getpid());
+
+    bool ok = (mkdir(tmp.c_str(), 0700) == 0) and (mkdir((tmp + "/files").c_str(), 0700) == 0) and
+              writeFile(tmp + "/key", key) and
+              writeFile(tmp + "/stdout", stdout_data) and
+              writeFile(tmp + "/stderr", stderr_data);
+    if (ok and (not output_dir.empty())) {
+        for (auto const &name : listFiles(output_dir)) {
+            if (std::find(input_files.begin(), input_files.end(), name) != input_files.end()) {
+                continue;
+            }
+            if (not copyFile(output_dir + "/" + name, tmp + "/files/" + name)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (ok) {
+        ok = (rename(tmp.c_str(), (this->directory + "/" + data).c_str()) == 0);
+    }
+    if (not ok) {
+        removeData(tmp);
+        return;
+    }
+
+    // an existing entry for the same key (or a colliding one) is replaced by renaming a new symbolic
+    // link over it, so that lookups see either entry; the old data directory is removed by evict()
+    // once no lookup can be reading it
+    struct stat st;
+    if ((lstat(entry.c_str(), &st) == 0) and S_ISDIR(st.st_mode)) {
+        removeEntry(entry);
+    }
+    unlink(link.c_str());
+    if ((symlink(data.c_str(), link.c_str()) != 0) or (rename(link.c_str(), entry.c_str()) != 0)) {
+        unlink(link.c_str());
+        removeData(this->directory + "/" + data);
+        return;
+    }
+
+    this->evict();
+}
+
+/**
+ * @brief Remove least recently used entries until the cache fits in its size limit
+ */
+void ResultCache::evict() {
+    struct stat st;
+    std::vector<std::tuple<double, unsigned long, std::string>> entries;
+    std::vector<std::string> data_dirs;
+    std::vector<std::string> referenced_data_dirs;
+    unsigned long total_bytes = 0;
+
+    DIR *dir = opendir(this->directory.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != nullptr) {
+        std::string name(dirent->d_name);
+        if ((name[0] == '.') or (not name.compare(0, 4, "tmp.")) or (not name.compare(0, 5, "link."))) {
+            continue;
+        }
+        if (not name.compare(0, 5, "data.")) {
+            data_dirs.push_back(name);
+            continue;
+        }
+        std::string path = this->directory + "/" + name;
+        char target[PATH_MAX];
+        ssize_t length = readlink(path.c_str(), target, sizeof(target) - 1);
+        if (length >= 0) {
+            target[length] = '\0';
+            referenced_data_dirs.emplace_back(target);
+        }
+        if ((stat(path.c_str(), &st) != 0) or (not S_ISDIR(st.st_mode))) {
+            continue;
+        }
+        double last_use = st.st_mtim.tv_sec + st.st_mtim.tv_nsec / 1e9;
+        unsigned long bytes = 0;
+        for (auto const &subdir : {path, path + "/files"}) {
+            for (auto const &file : listFiles(subdir)) {
+                if (stat((subdir + "/" + file).c_str(), &st) == 0) {
+                    bytes += st.st_size;
+                }
+            }
+        }
+        entries.emplace_back(last_use, bytes, path);
+        total_bytes += bytes;
+    }
+    closedir(dir);
+
+    // data directories of replaced entries
+    time_t now = time(nullptr);
+    for (auto const &name : data_dirs) {
+        std::string path = this->directory + "/" + name;
+        if ((std::find(referenced_data_dirs.begin(), referenced_data_dirs.end(), name) == referenced_data_dirs.end()) and
+            (stat(path.c_str(), &st) == 0) and (now - st.st_mtim.tv_sec > DATA_GRACE_PERIOD)) {
+            removeData(path);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+    for (auto const &entry : entries) {
+        if (total_bytes <= this->max_bytes) {
+            break;
+        }
+        removeEntry(std::get<2>(entry));
+        total_bytes -= std::get<1>(entry);
+    }
+}
+
+/**
+ * @brief List the regular files of a directory
+ *
+ * @param dir: the directory path
+ * @return the file names (empty if the directory cannot be read)
+ */
+std::vector<std::string> ResultCache::listFiles(const std::string &dir) {
+    std::vector<std::string> names;
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) {
+        return names;
+    }
+    struct dirent *dirent;
+    struct stat st;
+    while ((dirent = readdir(d)) != nullptr) {
+        std::string name(dirent->d_name);
+        if ((stat((dir + "/" + name).c_str(), &st) == 0) and S_ISREG(st.st_mode)) {
+            names.push_back(name);
+        }
+    }
+    closedir(d);
+    return names;
+}
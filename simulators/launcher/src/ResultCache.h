@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef EDUWRENCH_RESULT_CACHE_H
+#define EDUWRENCH_RESULT_CACHE_H
+
+#include <string>
+#include <vector>
+
+/**
+ *  @brief An on-disk cache of the results (stdout, stderr, and files written to the output
+ *         directory) of deterministic simulator runs, bounded in size with LRU eviction.
+ *
+ *  Each entry is a symbolic link named after a hash of the run's key, to a data directory which
+ *  holds the key itself (checked on lookup), the stdout and stderr contents, and a copy of the
+ *  result files. An entry's modification date (that of its data directory) is its last use date.
+ *  Data directories are created under a temporary name and renamed, and entries are (re)placed by
+ *  renaming a new link over them, so that concurrent handlers never see partial or missing
+ *  entries.
+ */
+class ResultCache {
+public:
+    ResultCache(const std::string &directory, unsigned long max_bytes);
+
+    static std::string makeKey(const std::string &executable, const std::vector<std::string> &args,
+                               const std::string &output_dir);
+
+    bool lookup(const std::string &key, const std::string &output_dir,
+                std::string &stdout_data, std::string &stderr_data);
+    void store(const std::string &key, const std::string &output_dir, const std::vector<std::string> &input_files,
+               const std::string &stdout_data, const std::string &stderr_data);
+
+    static std::vector<std::string> listFiles(const std::string &dir);
+
+private:
+    std::string entryPath(const std::string &key);
+    void evict();
+
+    std::string directory;
+    unsigned long max_bytes;
+};
+
+#endif //EDUWRENCH_RESULT_CACHE_H
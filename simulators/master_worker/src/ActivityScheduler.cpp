@@ -2,6 +2,7 @@
 #include <random>
 #include <algorithm>
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -257,6 +258,8 @@ namespace wrench {
 //                std::cerr << "SUBMITTING " << task_to_run.task->getID() << " to " << cs.compute_service->getHostname() << "\n";
                 auto job = this->getJobManager()->createStandardJob(task_to_run.task, file_locations);
                 this->getJobManager()->submitJob(job, cs.compute_service, service_specific_args);
+                EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                    {"compute_service", cs.compute_service->getHostname()}});
                 scheduled = true;
                 break;
             }
@@ -1,5 +1,6 @@
 
 #include "ActivityWMS.h"
+#include "EventLog.h"
 #include <algorithm>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms, "Log category for Simple WMS");
@@ -39,6 +40,8 @@ namespace wrench {
 //                    this->mailbox_name.c_str());
 //        WRENCH_INFO("About to execute a workflow with %lu tasks", this->getWorkflow()->getNumberOfTasks());
 
+        EventLog::record("wms_start", {{"num_tasks", this->getWorkflow()->getNumberOfTasks()}});
+
         // Create a job manager
         this->job_manager = this->createJobManager();
 
@@ -74,6 +77,8 @@ namespace wrench {
             WRENCH_INFO("Execution is incomplete!");
         }
 
+        EventLog::record("wms_end", {{"completed", this->getWorkflow()->isDone()}});
+
         this->job_manager.reset();
 
         return 0;
@@ -85,6 +90,7 @@ namespace wrench {
      */
     void ActivityWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) {
         auto standard_job = event->standard_job;
+        EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(standard_job->getTasks())}});
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);
         WRENCH_INFO("Notified that %s has completed", standard_job->getTasks().at(0)->getID().c_str());
     }
@@ -7,11 +7,16 @@
 #include <simgrid/s4u.hpp>
 #include <wrench.h>
 #include <nlohmann/json.hpp>
-#include <pugixml.hpp>
 #include <sys/wait.h>
 
 #include "ActivityWMS.h"
 #include "ActivityScheduler.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 
 
@@ -74,139 +79,52 @@ void generateWorkflow(wrench::Workflow *workflow, std::vector<std::tuple<double,
 }
 
 /**
- * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
- *
- * @throws std::invalid_argument
+ * @brief Generates a platform with a coordinator and workers
+ * @param workers: the workers (name, link bandwidth in MBps, speed in GFlop/sec), or none for
+ *                 the default three workers
+ * @return the platform description
  */
-void generatePlatform(std::string platform_file_path, std::vector<std::tuple<std::string, double, double>> workers = {}) {
+PlatformBuilder::Zone generatePlatform(std::vector<std::tuple<std::string, double, double>> workers = {}) {
 
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
-
-    std::string xml_string = "";
+    PlatformBuilder::Zone platform("AS0");
 
     //if no workers specified, use default.
-    if (workers.empty()){
-        // Create a the platform file
-        xml_string = "<?xml version='1.0'?>\n"
-                     "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                     "<platform version=\"4.1\">\n"
-                     "   <zone id=\"AS0\" routing=\"Full\">\n"
-                     "       <host id=\"coordinator\" speed=\"1000000000000000Gf\" core=\"1000\">\n"
-                     "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                     "           <disk id=\"large_disk\" read_bw=\"1000000000000TBps\" write_bw=\"1000000000000TBps\">\n"
-                     "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                     "                            <prop id=\"mount\" value=\"/\"/>\n"
-                     "           </disk>\n"
-                     "       </host>\n"
-                     "       <host id=\"worker_zero\" speed=\"500Gf\" core=\"1\">\n"
-                     "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                     "           <disk id=\"worker_zero_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                     "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                     "                            <prop id=\"mount\" value=\"/\"/>\n"
-                     "           </disk>\n"
-                     "       </host>\n"
-                     "       <host id=\"worker_one\" speed=\"1000Gf\" core=\"1\">\n"
-                     "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                     "           <disk id=\"worker_one_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                     "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                     "                            <prop id=\"mount\" value=\"/\"/>\n"
-                     "           </disk>\n"
-                     "       </host>\n"
-                     "       <host id=\"worker_two\" speed=\"100Gf\" core=\"1\">\n"
-                     "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                     "           <disk id=\"worker_two_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                     "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                     "                            <prop id=\"mount\" value=\"/\"/>\n"
-                     "           </disk>\n"
-                     "       </host>\n"
-                     "       <link id=\"link\" bandwidth=\"1000MBps\" latency=\"0us\"/>\n"
-                     "       <link id=\"link1\" bandwidth=\"10000MBps\" latency=\"0us\"/>\n"
-                     "       <link id=\"link2\" bandwidth=\"100000MBps\" latency=\"0us\"/>\n"
-                     "       <route src=\"coordinator\" dst=\"worker_zero\">"
-                     "           <link_ctn id=\"link\"/>"
-                     "       </route>"
-                     "       <route src=\"coordinator\" dst=\"worker_one\">"
-                     "           <link_ctn id=\"link1\"/>"
-                     "       </route>"
-                     "       <route src=\"coordinator\" dst=\"worker_two\">"
-                     "           <link_ctn id=\"link2\"/>"
-                     "       </route>"
-                     "   </zone>\n"
-                     "</platform>\n";
-
-        FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-        fprintf(platform_file, "%s", xml_string.c_str());
-        fclose(platform_file);
+    if (workers.empty()) {
+        platform.addHost("coordinator", "1000000000000000Gf", 1000)
+                .setProperty("ram", "32GB")
+                .addDisk("large_disk", "1000000000000TBps", "1000000000000TBps");
+        platform.addHost("worker_zero", "500Gf", 1)
+                .setProperty("ram", "32GB")
+                .addDisk("worker_zero_disk", "50MBps", "50MBps");
+        platform.addHost("worker_one", "1000Gf", 1)
+                .setProperty("ram", "32GB")
+                .addDisk("worker_one_disk", "50MBps", "50MBps");
+        platform.addHost("worker_two", "100Gf", 1)
+                .setProperty("ram", "32GB")
+                .addDisk("worker_two_disk", "50MBps", "50MBps");
+        platform.addLink("link", "1000MBps", "0us");
+        platform.addLink("link1", "10000MBps", "0us");
+        platform.addLink("link2", "100000MBps", "0us");
+        platform.addRoute("coordinator", "worker_zero", {"link"});
+        platform.addRoute("coordinator", "worker_one", {"link1"});
+        platform.addRoute("coordinator", "worker_two", {"link2"});
     } else {
-        xml_string = "<?xml version='1.0'?>\n"
-                     "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                     "<platform version=\"4.1\">\n"
-                     "   <zone id=\"AS0\" routing=\"Full\">\n"
-                     "       <host id=\"coordinator\" speed=\"1000000000000000Gf\" core=\"1000\">\n"
-                     "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                     "           <disk id=\"large_disk\" read_bw=\"1000000000000TBps\" write_bw=\"1000000000000TBps\">\n"
-                     "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                     "                            <prop id=\"mount\" value=\"/\"/>\n"
-                     "           </disk>\n"
-                     "       </host>\n"
-                     "   </zone>\n"
-                     "</platform>\n";
-
-        pugi::xml_document xml_doc;
-
-        if (xml_doc.load_string(xml_string.c_str(), pugi::parse_doctype)) {
-
-            pugi::xml_node previous_route;
-            ///creating the workers specified by command line arguments.
-            ///Currently, only the flops and link speed to coordinator are set.
-            for (const auto &worker : workers) {
-
-                pugi::xml_node host = xml_doc.child("platform").child("zone").prepend_child("host");
-                host.append_attribute("id") = (std::get<0>(worker)).c_str();
-                host.append_attribute("speed") = (std::to_string(std::get<2>(worker))+"Gf").c_str();
-                host.append_attribute("core") = "1";
-                pugi::xml_node host_prop = host.append_child("prop");
-                host_prop.append_attribute("id") = "ram";
-                host_prop.append_attribute("value") = "32GB";
-                /**
-                pugi::xml_node host_disk = host.append_child("disk");
-                host_disk.append_attribute("id") = (std::get<0>(worker)+"_disk").c_str();
-                host_disk.append_attribute("read_bw") = "50MBps";
-                host_disk.append_attribute("write_bw") = "50MBps";
-                pugi::xml_node host_disk_prop = host_disk.append_child("prop");
-                host_disk_prop.append_attribute("id") = "size";
-                host_disk_prop.append_attribute("value") = "5000GiB";
-                pugi::xml_node host_disk_prop2 = host_disk.append_child("prop");
-                host_disk_prop2.append_attribute("id") = "mount";
-                host_disk_prop2.append_attribute("value") = "/";
-                */
-
-                pugi::xml_node route = xml_doc.child("platform").child("zone").append_child("route");
-                route.append_attribute("src") = "coordinator";
-                route.append_attribute("dst") = (std::get<0>(worker)).c_str();
-                pugi::xml_node route_link = route.append_child("link_ctn");
-                route_link.append_attribute("id") = ("link_"+std::get<0>(worker)).c_str();
-
-                if (previous_route == nullptr) {
-                    previous_route = route;
-                }
-
-                pugi::xml_node link = xml_doc.child("platform").child("zone").insert_child_before("link", previous_route);
-                link.append_attribute("id") = ("link_"+std::get<0>(worker)).c_str();
-                link.append_attribute("bandwidth") = (std::to_string(std::get<1>(worker)/0.97)+"MBps").c_str();
-                link.append_attribute("latency") = "0us";
-
-
-
-                xml_doc.save_file(platform_file_path.c_str());
-            }
-        } else {
-            throw std::runtime_error("something went wrong with parsing xml string");
+        ///creating the workers specified by command line arguments (in reverse order, before
+        ///the coordinator). Currently, only the flops and link speed to coordinator are set.
+        for (auto worker = workers.rbegin(); worker != workers.rend(); ++worker) {
+            platform.addHost(std::get<0>(*worker), std::to_string(std::get<2>(*worker)) + "Gf", 1)
+                    .setProperty("ram", "32GB");
+        }
+        platform.addHost("coordinator", "1000000000000000Gf", 1000)
+                .setProperty("ram", "32GB")
+                .addDisk("large_disk", "1000000000000TBps", "1000000000000TBps");
+        for (const auto &worker : workers) {
+            platform.addLink("link_" + std::get<0>(worker), std::to_string(std::get<1>(worker) / 0.97) + "MBps", "0us");
+            platform.addRoute("coordinator", std::get<0>(worker), {"link_" + std::get<0>(worker)});
         }
     }
+
+    return platform;
 }
 
 retVals parse_arguments_for_individual_run(int argc, char** argv, std::mt19937 &rng) {
@@ -584,11 +502,11 @@ std::string run_simulation(std::vector<std::tuple<std::string, double, double>>
     generateWorkflow(&workflow, tasks);
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform_";
-    platform_file_path.append(std::to_string(getpid()));
-    platform_file_path.append(".xml");
-    generatePlatform(platform_file_path, workers);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(workers));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     const std::string MASTER("coordinator");
     const std::string WORKER_ZERO("worker_zero");
@@ -675,9 +593,15 @@ std::string run_simulation(std::vector<std::tuple<std::string, double, double>>
     ));
 
     wms->addWorkflow(&workflow);
+    PhaseTimer::start("simulation");
     simulation.launch();
+    PhaseTimer::start("output");
     if (single) {
-        simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", false, true, false, false, false);
+        if (ColumnarOutput::isEnabled()) {
+            ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+        } else {
+            simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), false, true, false, false, false);
+        }
     }
 
     auto task_termination_timestamps = simulation.getOutput().getTrace<wrench::SimulationTimestampTaskCompletion>();
@@ -696,9 +620,17 @@ std::string run_simulation(std::vector<std::tuple<std::string, double, double>>
  */
 int main(int argc, char** argv) {
 
+    BatchMode::init(&argc, &argv, "master_worker");
+
     //Mersenne Twister: Good quality random number generator
     std::mt19937 rng;
 
+    // set up before forking, so that all invocations write to the same directory
+    OutputDirectory::init(&argc, argv, "master_worker");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "master_worker");
+
     if (argc <= 1) {
         std::cerr << "Try " << argv[0] << " --help\n";
         return 1;
@@ -804,7 +736,9 @@ int main(int argc, char** argv) {
                 ));
 
                 wms->addWorkflow(&workflow);
+                PhaseTimer::start("simulation");
                 simulation.launch();
+                PhaseTimer::start("output");
                 auto task_termination_timestamps = simulation.getOutput().getTrace<wrench::SimulationTimestampTaskCompletion>();
                 if(!task_termination_timestamps.empty()) {
                     auto last_task = task_termination_timestamps.back()->getContent()->getDate();
@@ -849,8 +783,14 @@ int main(int argc, char** argv) {
         ));
 
         wms->addWorkflow(&workflow);
+        PhaseTimer::start("simulation");
         simulation.launch();
-        simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", false, true, false, false, false);
+        PhaseTimer::start("output");
+        if (ColumnarOutput::isEnabled()) {
+            ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+        } else {
+            simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), false, true, false, false, false);
+        }
     }
 
     return 0;
@@ -1,5 +1,6 @@
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -27,6 +28,8 @@ namespace wrench {
             WRENCH_INFO("Starting task %s on a core!", t->getID().c_str());
             auto job = this->getJobManager()->createStandardJob(t);
             this->getJobManager()->submitJob(job, compute_service, {});
+            EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                {"compute_service", compute_service->getHostname()}});
             idle_core_count--;
         }
 
@@ -1,5 +1,6 @@
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -62,6 +63,8 @@ namespace wrench {
             WRENCH_INFO("Starting task %s on a core!", lucky_winner->getID().c_str());
             auto job = this->getJobManager()->createStandardJob(lucky_winner);
             this->getJobManager()->submitJob(job, compute_service, {});
+            EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                {"compute_service", compute_service->getHostname()}});
             idle_core_count--;
             num_scheduled++;
         }
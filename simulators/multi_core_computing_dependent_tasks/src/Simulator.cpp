@@ -7,10 +7,15 @@
 #include <simgrid/s4u.hpp>
 #include <wrench.h>
 #include <nlohmann/json.hpp>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
 #include "ActivityScheduler.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
  * @brief Generates a dependent-task Workflow
@@ -79,34 +84,16 @@ void generateWorkflow(wrench::Workflow *workflow, double analyze_work) {
 
 /**
  * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
- *
- * @throws std::invalid_argument
+ * @param num_cores: number of cores of the host
+ * @return the platform description
  */
-void generatePlatform(std::string platform_file_path, int num_cores) {
-
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
+PlatformBuilder::Zone generatePlatform(int num_cores) {
 
-    // Create a the platform file
-    std::string xml = "<?xml version='1.0'?>\n"
-                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                      "<platform version=\"4.1\">\n"
-                      "   <zone id=\"AS0\" routing=\"Full\">\n"
-                      "       <host id=\"the_host\" speed=\"10Gf\" core=\"" + std::to_string(num_cores) +  "\">\n"
-                      "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                      "       </host>\n"
-                      "       <link id=\"link\" bandwidth=\"100000TBps\" latency=\"0us\"/>\n"
-                      "       <route src=\"the_host\" dst=\"the_host\">"
-                      "           <link_ctn id=\"link\"/>"
-                      "       </route>"
-                      "   </zone>\n"
-                      "</platform>\n";
-
-    FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-    fprintf(platform_file, "%s", xml.c_str());
-    fclose(platform_file);
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("the_host", "10Gf", num_cores).setProperty("ram", "32GB");
+    platform.addLink("link", "100000TBps", "0us");
+    platform.addRoute("the_host", "the_host", {"link"});
+    return platform;
 }
 
 /**
@@ -117,8 +104,14 @@ void generatePlatform(std::string platform_file_path, int num_cores) {
  */
 int main(int argc, char** argv) {
 
+    BatchMode::init(&argc, &argv, "multi_core_computing_dependent_tasks");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "multi_core_computing_dependent_tasks");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "multi_core_computing_dependent_tasks");
 
     const int MAX_CORES         = 1000;
     int NUM_CORES;
@@ -167,9 +160,11 @@ int main(int argc, char** argv) {
     generateWorkflow(&workflow, ANALYZE);
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, NUM_CORES);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(NUM_CORES));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
 
     const std::string THE_HOST("the_host");
@@ -192,9 +187,21 @@ int main(int argc, char** argv) {
 
     wms->addWorkflow(&workflow);
 
+    PhaseTimer::start("simulation");
+
     simulation.launch();
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", true, true, true, false, false, false);
+    PhaseTimer::start("output");
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), true, true, true, false, false, false);
+
+    }
 
     std::cout << simulation.getCurrentSimulatedDate() << "\n";
     return 0;
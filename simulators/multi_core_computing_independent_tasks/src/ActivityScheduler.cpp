@@ -1,5 +1,6 @@
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -33,6 +34,8 @@ namespace wrench {
             }
             auto job = this->getJobManager()->createStandardJob(ready_task);
             this->getJobManager()->submitJob(job, compute_service, {});
+            EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                {"compute_service", compute_service->getHostname()}});
             idle_core_count--;
             ram_capacity = ram_capacity - task_memory;
         }
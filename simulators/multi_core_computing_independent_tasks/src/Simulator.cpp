@@ -7,10 +7,15 @@
 #include <simgrid/s4u.hpp>
 #include <wrench.h>
 #include <nlohmann/json.hpp>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
 #include "ActivityScheduler.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
  * @brief Generates an independent-task Workflow
@@ -56,34 +61,16 @@ void generateWorkflow(wrench::Workflow *workflow, int num_tasks, int task_gflop,
 
 /**
  * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
- *
- * @throws std::invalid_argumemnt
+ * @param num_cores: number of cores of the host
+ * @return the platform description
  */
-void generatePlatform(std::string platform_file_path, int num_cores) {
-
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
+PlatformBuilder::Zone generatePlatform(int num_cores) {
 
-    // Create a the platform file
-    std::string xml = "<?xml version='1.0'?>\n"
-                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                      "<platform version=\"4.1\">\n"
-                      "   <zone id=\"AS0\" routing=\"Full\">\n"
-                      "       <host id=\"thehost\" speed=\"100Gf\" core=\"" + std::to_string(num_cores)  + "\">\n"
-                      "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                      "       </host>\n"
-                      "       <link id=\"link\" bandwidth=\"100000TBps\" latency=\"0us\"/>\n"
-                      "       <route src=\"thehost\" dst=\"thehost\">"
-                      "           <link_ctn id=\"link\"/>"
-                      "       </route>"
-                      "   </zone>\n"
-                      "</platform>\n";
-
-    FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-    fprintf(platform_file, "%s", xml.c_str());
-    fclose(platform_file);
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("thehost", "100Gf", num_cores).setProperty("ram", "32GB");
+    platform.addLink("link", "100000TBps", "0us");
+    platform.addRoute("thehost", "thehost", {"link"});
+    return platform;
 }
 
 /**
@@ -94,8 +81,14 @@ void generatePlatform(std::string platform_file_path, int num_cores) {
  */
 int main(int argc, char** argv) {
 
+    BatchMode::init(&argc, &argv, "multi_core_computing_independent_tasks");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "multi_core_computing_independent_tasks");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "multi_core_computing_independent_tasks");
 
     const int MAX_CORES         = 1000;
     int NUM_CORES;
@@ -154,9 +147,11 @@ int main(int argc, char** argv) {
     generateWorkflow(&workflow, NUM_TASKS, TASK_GFLOP, TASK_MEMORY);
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, NUM_CORES);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(NUM_CORES));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
 
     const std::string THE_HOST("thehost");
@@ -180,9 +175,21 @@ int main(int argc, char** argv) {
 
     wms->addWorkflow(&workflow);
 
+    PhaseTimer::start("simulation");
+
     simulation.launch();
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", true, true, true, false, false, false);
+    PhaseTimer::start("output");
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), true, true, true, false, false, false);
+
+    }
 
     return 0;
 }
@@ -1,5 +1,6 @@
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -51,6 +52,8 @@ namespace wrench {
             }
             auto job = this->getJobManager()->createStandardJob(task, file_locations);
             this->getJobManager()->submitJob(job, compute_service, service_specific_args);
+            EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                {"compute_service", compute_service->getHostname()}});
             if (task->getID() == "io read task #1") {
                 TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);
                 WRENCH_INFO("Starting reading input file for task #1");
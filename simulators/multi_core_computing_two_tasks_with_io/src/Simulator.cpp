@@ -15,6 +15,12 @@
 
 #include "ActivityWMS.h"
 #include "ActivityScheduler.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
  * @brief Generates a two-task Workflow
@@ -97,38 +103,17 @@ void generateWorkflow(wrench::Workflow *workflow,
 
 /**
  * @brief Generates a platform with a single two-core host
- * @param platform_file_path: path to write the platform file to
- *
- * @throws std::invalid_argumemnt
+ * @return the platform description
  */
-void generatePlatform(std::string platform_file_path) {
-
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
-
-    // Create a the platform file
-    std::string xml = "<?xml version='1.0'?>\n"
-                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                      "<platform version=\"4.1\">\n"
-                      "   <zone id=\"AS0\" routing=\"Full\">\n"
-                      "       <host id=\"twocorehost\" speed=\"100Gf\" core=\"2\">\n"
-                      "           <prop id=\"ram\" value=\"31GB\"/>\n"
-                      "           <disk id=\"large_disk\" read_bw=\"100MBps\" write_bw=\"100MBps\">\n"
-                      "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                      "                            <prop id=\"mount\" value=\"/\"/>\n"
-                      "           </disk>\n"
-                      "       </host>\n"
-                      "       <link id=\"link\" bandwidth=\"100000TBps\" latency=\"0us\"/>\n"
-                      "       <route src=\"twocorehost\" dst=\"twocorehost\">\n"
-                      "           <link_ctn id=\"link\"/>\n"
-                      "       </route>\n"
-                      "   </zone>\n"
-                      "</platform>\n";
-
-    FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-    fprintf(platform_file, "%s", xml.c_str());
-    fclose(platform_file);
+PlatformBuilder::Zone generatePlatform() {
+
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("twocorehost", "100Gf", 2)
+            .setProperty("ram", "31GB")
+            .addDisk("large_disk", "100MBps", "100MBps");
+    platform.addLink("link", "100000TBps", "0us");
+    platform.addRoute("twocorehost", "twocorehost", {"link"});
+    return platform;
 }
 
 /**
@@ -139,10 +124,20 @@ void generatePlatform(std::string platform_file_path) {
  */
 int main(int argc, char **argv) {
 
+    BatchMode::init(&argc, &argv, "multi_core_computing_two_tasks_with_io");
+
     wrench::Simulation simulation;
 
     simulation.init(&argc, argv);
 
+    OutputDirectory::init(&argc, argv, "multi_core_computing_two_tasks_with_io");
+
+    EventLog::init(&argc, argv);
+
+    ColumnarOutput::init(&argc, argv);
+
+    PhaseTimer::init(&argc, argv, "multi_core_computing_two_tasks_with_io");
+
     int TASK1_READ;
     int TASK1_WRITE;
     int TASK1_GFLOP;
@@ -202,11 +197,15 @@ int main(int argc, char **argv) {
     generateWorkflow(&workflow, task_specs, TASK1_BEFORE_TASK2);
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform());
+
+    PhaseTimer::start("platform_instantiation");
 
     simulation.instantiatePlatform(platform_file_path);
 
+    PhaseTimer::start("simulation_setup");
+
     const std::string WMS_HOST("twocorehost");
     const std::string COMPUTE_HOST("twocorehost");
     const std::string STORAGE_HOST("twocorehost");
@@ -249,8 +248,18 @@ int main(int argc, char **argv) {
     }
 
     simulation.getOutput().enableDiskTimestamps(true);
+    PhaseTimer::start("simulation");
     simulation.launch();
+    PhaseTimer::start("output");
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", true, true, true, false, false, true);
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), true, true, true, false, false, true);
+
+    }
     return 0;
 }
@@ -8,17 +8,53 @@ namespace wrench {
 
     class Simulation;
 
+    /**
+     * @brief A file transfer, as parallel streams that each copy a sequence of chunks (files), one at a time
+     */
+    struct Transfer {
+        std::string id;
+        std::string source;
+        std::string destination;
+        double start_date;
+        double size;
+        unsigned long num_streams;
+        double chunk_size;
+        std::vector<std::vector<WorkflowFile *>> streams;
+        /** @brief The completion date (-1 until the transfer completes, or if a chunk copy failed) */
+        double completion_date;
+    };
+
     class ActivityWMS : public WMS {
     public:
         ActivityWMS(const std::set<std::shared_ptr<wrench::StorageService>> &storage_services,
-                    const std::string &hostname);
+                    const std::string &hostname, const std::vector<Transfer> &transfers);
+
+        const std::vector<Transfer> &getTransfers();
 
     private:
         int main() override;
 
+        void processEventFileCopyCompletion(std::shared_ptr<FileCopyCompletedEvent> event) override;
+        void processEventFileCopyFailure(std::shared_ptr<FileCopyFailedEvent> event) override;
+        void processEventTimer(std::shared_ptr<TimerEvent> event) override;
+
+        void startTransfers();
+        void startNextChunk(unsigned long transfer, unsigned long stream);
+
         std::shared_ptr<wrench::DataMovementManager> data_movement_manager;
+        /** @brief The storage service of each host */
+        std::map<std::string, std::shared_ptr<StorageService>> storage_services;
+
+        std::vector<Transfer> transfers;
+        /** @brief The transfers in start date order, and the number of those already started */
+        std::vector<unsigned long> start_order;
+        unsigned long num_started;
+        /** @brief The transfer and stream of each chunk */
+        std::map<WorkflowFile *, std::pair<unsigned long, unsigned long>> chunk_streams;
+        /** @brief The number of chunks copied by each stream of each transfer */
+        std::vector<std::vector<unsigned long>> num_copied;
+        unsigned long num_pending_streams;
     };
 };
 
 #endif
-
@@ -10,49 +10,155 @@
 #include <algorithm>
 
 #include "ActivityWMS.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(FileCopyWMS, "Log category for FileCopyWMS");
 
 namespace wrench {
     ActivityWMS::ActivityWMS(const std::set<std::shared_ptr<StorageService>> &storage_services,
-                             const std::string &hostname)
-            : WMS(nullptr, nullptr, {}, storage_services, {}, nullptr, hostname, "activity0") {
+                             const std::string &hostname, const std::vector<Transfer> &transfers)
+            : WMS(nullptr, nullptr, {}, storage_services, {}, nullptr, hostname, "activity0"),
+              transfers(transfers) {
 
     }
 
+    /**
+     * @brief Get the transfers, with their completion dates once the simulation has completed
+     * @return the transfers
+     */
+    const std::vector<Transfer> &ActivityWMS::getTransfers() {
+        return this->transfers;
+    }
+
     int ActivityWMS::main() {
 
+        EventLog::record("wms_start", {{"num_files", this->getWorkflow()->getFiles().size()}});
+
         this->data_movement_manager = this->createDataMovementManager();
 
-        auto storage_services = this->getAvailableStorageServices();
-
-        auto storage_service_1 = std::find_if(
-                storage_services.begin(),
-                storage_services.end(),
-                [](std::shared_ptr<StorageService> ss) {
-                    return ss->getHostname() ==
-                           "host1";
-                });
-
-        auto storage_service_2 = std::find_if(
-                storage_services.begin(),
-                storage_services.end(),
-                [](std::shared_ptr<StorageService> ss) {
-                    return ss->getHostname() ==
-                           "host2";
-                });
-
-        for (auto const &file : this->getWorkflow()->getFiles()) {
-            this->data_movement_manager->initiateAsynchronousFileCopy(file,
-                                                                      FileLocation::LOCATION(*storage_service_1, "/"),
-                                                                      FileLocation::LOCATION(*storage_service_2, "/"),
-                                                                      nullptr);
+        for (auto const &storage_service : this->getAvailableStorageServices()) {
+            this->storage_services[storage_service->getHostname()] = storage_service;
         }
 
-        for (auto const &file: this->getWorkflow()->getFiles()) {
+        for (unsigned long i = 0; i < this->transfers.size(); i++) {
+            this->num_copied.emplace_back(this->transfers[i].streams.size(), 0);
+            for (unsigned long j = 0; j < this->transfers[i].streams.size(); j++) {
+                for (auto const &chunk : this->transfers[i].streams[j]) {
+                    this->chunk_streams[chunk] = std::make_pair(i, j);
+                }
+            }
+            this->start_order.push_back(i);
+        }
+        std::stable_sort(this->start_order.begin(), this->start_order.end(), [this](unsigned long a, unsigned long b) {
+            return this->transfers[a].start_date < this->transfers[b].start_date;
+        });
+
+        // all streams of a transfer start at once, at its start date
+        this->num_pending_streams = 0;
+        this->num_started = 0;
+        this->startTransfers();
+
+        while ((this->num_pending_streams > 0) or (this->num_started < this->transfers.size())) {
             this->waitForAndProcessNextEvent();
         }
 
+        EventLog::record("wms_end");
+
         return 0;
     }
+
+    /**
+     * @brief Start the transfers whose start date has come, and set a timer for the next start date
+     */
+    void ActivityWMS::startTransfers() {
+        while ((this->num_started < this->transfers.size()) and
+               (this->transfers[this->start_order[this->num_started]].start_date <=
+                Simulation::getCurrentSimulatedDate())) {
+            unsigned long i = this->start_order[this->num_started++];
+            for (unsigned long j = 0; j < this->transfers[i].streams.size(); j++) {
+                this->startNextChunk(i, j);
+                this->num_pending_streams++;
+            }
+        }
+        if (this->num_started < this->transfers.size()) {
+            this->setTimer(this->transfers[this->start_order[this->num_started]].start_date, "start_transfers");
+        }
+    }
+
+    /**
+     * @brief Start the copy of the next chunk of a stream
+     *
+     * @param transfer: the transfer index
+     * @param stream: the stream index
+     */
+    void ActivityWMS::startNextChunk(unsigned long transfer, unsigned long stream) {
+        auto file = this->transfers[transfer].streams[stream][this->num_copied[transfer][stream]];
+        auto source = this->storage_services.at(this->transfers[transfer].source);
+        auto destination = this->storage_services.at(this->transfers[transfer].destination);
+        EventLog::record("file_copy_start", {{"file", file->getID()},
+                                             {"src",  source->getHostname()},
+                                             {"dst",  destination->getHostname()}});
+        this->data_movement_manager->initiateAsynchronousFileCopy(file,
+                                                                  FileLocation::LOCATION(source, "/"),
+                                                                  FileLocation::LOCATION(destination, "/"),
+                                                                  nullptr);
+    }
+
+    /**
+     * @brief Process a timer event (the start date of transfers)
+     *
+     * @param event: the event
+     */
+    void ActivityWMS::processEventTimer(std::shared_ptr<TimerEvent> event) {
+        this->startTransfers();
+    }
+
+    /**
+     * @brief Process a file copy completion event
+     *
+     * @param event: the event
+     */
+    void ActivityWMS::processEventFileCopyCompletion(std::shared_ptr<FileCopyCompletedEvent> event) {
+        EventLog::record("file_copy_completion", {{"file", event->file->getID()}});
+
+        auto chunk_stream = this->chunk_streams.at(event->file);
+        unsigned long i = chunk_stream.first;
+        unsigned long j = chunk_stream.second;
+        auto &transfer = this->transfers[i];
+
+        if (++this->num_copied[i][j] < transfer.streams[j].size()) {
+            this->startNextChunk(i, j);
+            return;
+        }
+        this->num_pending_streams--;
+
+        // the transfer is complete once all its streams are
+        for (unsigned long k = 0; k < transfer.streams.size(); k++) {
+            if (this->num_copied[i][k] < transfer.streams[k].size()) {
+                return;
+            }
+        }
+        transfer.completion_date = Simulation::getCurrentSimulatedDate();
+        EventLog::record("transfer_completion", {{"transfer",    transfer.id},
+                                                 {"size",        transfer.size},
+                                                 {"num_streams", transfer.streams.size()},
+                                                 {"throughput",  transfer.size /
+                                                                 (transfer.completion_date - transfer.start_date)}});
+    }
+
+    /**
+     * @brief Process a file copy failure event: the stream of the chunk stops (and its transfer
+     *        never completes), while the other streams go on
+     *
+     * @param event: the event
+     */
+    void ActivityWMS::processEventFileCopyFailure(std::shared_ptr<FileCopyFailedEvent> event) {
+        auto chunk_stream = this->chunk_streams.at(event->file);
+        EventLog::record("file_copy_failure", {{"file",     event->file->getID()},
+                                               {"transfer", this->transfers[chunk_stream.first].id},
+                                               {"cause",    event->failure_cause->toString()}});
+        WRENCH_INFO("Copy of %s failed (%s)", event->file->getID().c_str(), event->failure_cause->toString().c_str());
+
+        this->num_pending_streams--;
+    }
 }
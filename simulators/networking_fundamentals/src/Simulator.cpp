@@ -12,127 +12,624 @@
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
-#include <pugixml.hpp>
+#include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include <simgrid/s4u.hpp>
 
 #include "ActivityWMS.h"
+#include "BatchMode.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
+#include "Statistics.h"
 
 /**
- * @brief Generate a workflow containing only files
+ * @brief Generate a workflow containing only files: one file per transfer, or, for a transfer with several
+ *        streams or a chunk size, one file per chunk, the chunks being spread over the streams round-robin
  * @param workflow: pointer to the workflow
-  @param file_sizes: the list of file sizes, in MB
+ * @param file_sizes: the list of file sizes, in MB
+ * @param num_streams: the number of streams of each transfer
+ * @param chunk_sizes: the chunk size of each transfer, in MB (0 for one chunk per stream)
+ * @return the transfers
  */
-void generateWorkflow(wrench::Workflow *workflow, std::vector<double> &file_sizes) {
-    int id = 0;
-    for (auto const &size : file_sizes) {
-        workflow->addFile(("file_" + std::to_string(id++)), size * 1000.0 * 1000.0);
+std::vector<wrench::Transfer> generateWorkflow(wrench::Workflow *workflow, std::vector<double> &file_sizes,
+                                               std::vector<unsigned long> &num_streams,
+                                               std::vector<double> &chunk_sizes) {
+    std::vector<wrench::Transfer> transfers;
+    for (unsigned long id = 0; id < file_sizes.size(); id++) {
+        wrench::Transfer transfer;
+        transfer.id = "file_" + std::to_string(id);
+        transfer.source = "host1";
+        transfer.destination = "host2";
+        transfer.start_date = 0;
+        transfer.size = file_sizes[id] * 1000.0 * 1000.0;
+        transfer.num_streams = num_streams[id];
+        transfer.chunk_size = chunk_sizes[id] * 1000.0 * 1000.0;
+        transfer.completion_date = -1;
+
+        if ((transfer.num_streams == 1) and (transfer.chunk_size <= 0)) {
+            transfer.streams = {{workflow->addFile(transfer.id, transfer.size)}};
+        } else {
+            unsigned long num_chunks = (transfer.chunk_size > 0) ?
+                                       (unsigned long) std::ceil(transfer.size / transfer.chunk_size) :
+                                       transfer.num_streams;
+            double chunk_size = (transfer.chunk_size > 0) ? transfer.chunk_size : transfer.size / num_chunks;
+            transfer.streams.resize(std::min(transfer.num_streams, num_chunks));
+            for (unsigned long k = 0; k < num_chunks; k++) {
+                double size = std::min(chunk_size, transfer.size - k * chunk_size);
+                transfer.streams[k % transfer.streams.size()].push_back(
+                        workflow->addFile(transfer.id + "_chunk_" + std::to_string(k), size));
+            }
+        }
+        transfers.push_back(transfer);
     }
+    return transfers;
 }
 
 /**
  * @brief Generate a platform with two hosts connected by three links.
- * @param platform_file_path: the path where the platform.xml file will be written to
  * @param effective_bandwidth: effective bandwidth of the second (middle) of the three links in MBps
+ * @param latencies: latencies of the three links in us
+ * @return the platform description
  *
  * throws std::invalid_argument
  */
-void generatePlatform(std::string platform_file_path, unsigned long effective_bandwidth) {
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generateSingleLinkPlatform() platform_file_path cannot be empty");
-    }
+PlatformBuilder::Zone generatePlatform(unsigned long effective_bandwidth, const std::vector<int> &latencies) {
 
     if (effective_bandwidth < 1) {
         throw std::invalid_argument("generateSingleLinkPlatform() bandwidth must be at least 1 MBps");
     }
 
-    std::string xml_string = "<?xml version='1.0'?>\n"
-                             "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                             "<platform version=\"4.1\">\n"
-                             "   <zone id=\"AS0\" routing=\"Full\">\n"
-                             "       <host id=\"host1\" speed=\"1000Gf\" core=\"1\">\n"
-                             "           <disk id=\"large_disk\" read_bw=\"100MBps\" write_bw=\"100MBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <host id=\"host2\" speed=\"1000Gf\" core=\"1\">\n"
-                             "           <disk id=\"large_disk\" read_bw=\"100MBps\" write_bw=\"100MBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <!-- effective bandwidth = 100 MBps -->\n"
-                             "       <link id=\"link1\" bandwidth=\"206.185MBps\" latency=\"10us\"/>\n"
-                             "       <link id=\"link2\" bandwidth=\"103.092MBps\" latency=\"10us\"/>\n"
-                             "       <link id=\"link3\" bandwidth=\"206.185MBps\" latency=\"10us\"/>\n"
-                             "       <route src=\"host1\" dst=\"host2\">\n"
-                             "           <link_ctn id=\"link1\"/>\n"
-                             "           <link_ctn id=\"link2\"/>\n"
-                             "           <link_ctn id=\"link3\"/>\n"
-                             "       </route>\n"
-                             "    </zone>\n"
-                             "</platform>";
-
-    pugi::xml_document xml_doc;
-
-    if (xml_doc.load_string(xml_string.c_str(), pugi::parse_doctype)) {
-
-        pugi::xml_node zone = xml_doc.child("platform").child("zone");
-        pugi::xml_node middle_link = zone.find_child_by_attribute("link", "id", "link2");
-
-        // entering (effective_bandwidth / 0.97) as bandwidth into the simulation
-        // so that the max bandwidth we can achieve is the effective_bandwidth
-        double bandwidth = effective_bandwidth / 0.97;
-
-        middle_link.attribute("bandwidth").set_value(std::string(std::to_string(bandwidth) + "MBps").c_str());
-
-        xml_doc.save_file(platform_file_path.c_str());
-
-    } else {
-        throw std::runtime_error("something went wrong with parsing xml string");
+    // entering (effective_bandwidth / 0.97) as bandwidth into the simulation
+    // so that the max bandwidth we can achieve is the effective_bandwidth
+    double bandwidth = effective_bandwidth / 0.97;
+
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("host1", "1000Gf", 1).addDisk("large_disk", "100MBps", "100MBps");
+    platform.addHost("host2", "1000Gf", 1).addDisk("large_disk", "100MBps", "100MBps");
+    platform.addLink("link1", "206.185MBps", std::to_string(latencies[0]) + "us");
+    platform.addLink("link2", std::to_string(bandwidth) + "MBps", std::to_string(latencies[1]) + "us");
+    platform.addLink("link3", "206.185MBps", std::to_string(latencies[2]) + "us");
+    platform.addRoute("host1", "host2", {"link1", "link2", "link3"});
+    return platform;
+}
+
+/**
+ * @brief Add a host, with a disk, to a generated topology
+ * @param platform: the platform
+ * @param hosts: the names of the hosts of the topology (appended to)
+ * @return the host name
+ */
+std::string addTopologyHost(PlatformBuilder::Zone &platform, std::vector<std::string> &hosts) {
+    std::string name = "host_" + std::to_string(hosts.size());
+    platform.addHost(name, "1000Gf", 1).addDisk("large_disk", "100000TBps", "100000TBps");
+    hosts.push_back(name);
+    return name;
+}
+
+/**
+ * @brief Add a link between two hosts or switches of a generated topology
+ * @param platform: the platform
+ * @param a: the first end of the link
+ * @param b: the second end of the link
+ * @param bandwidth: the link bandwidth (e.g., "1250MBps")
+ * @param latency: the link latency (e.g., "1us")
+ */
+void addTopologyLink(PlatformBuilder::Zone &platform, const std::string &a, const std::string &b,
+                     const std::string &bandwidth, const std::string &latency) {
+    std::string link = "link_" + a + "_" + b;
+    platform.addLink(link, bandwidth, latency);
+    platform.addRoute(a, b, {link});
+}
+
+/**
+ * @brief Add the host that runs the WMS to a generated topology, as a leaf attached to one switch by an
+ *        unbounded link, so that no flow route goes through it and it does not send or receive any flow
+ * @param platform: the platform
+ * @param attachment: the switch the host is attached to
+ * @return the host name
+ */
+std::string addTopologyController(PlatformBuilder::Zone &platform, const std::string &attachment) {
+    std::string name = "controller";
+    platform.addHost(name, "1000Gf", 1);
+    platform.addLink("controller_link", "100000TBps", "0us");
+    platform.addRoute(name, attachment, {"controller_link"});
+    return name;
+}
+
+/**
+ * @brief Generate a k-ary fat-tree platform: k pods of k/2 edge and k/2 aggregation switches, (k/2)^2 core
+ *        switches, and k/2 hosts per edge switch (k^3/4 hosts). Routes are shortest paths (Dijkstra routing),
+ *        so that the route between two hosts goes through a single, fixed, core switch. The WMS host is
+ *        attached to the first core switch.
+ * @param k: the switch radix (even)
+ * @param bandwidth: the link bandwidth (e.g., "1250MBps")
+ * @param latency: the link latency (e.g., "1us")
+ * @param hosts: set to the host names
+ * @return the platform description
+ */
+PlatformBuilder::Zone generateFatTreePlatform(int k, const std::string &bandwidth, const std::string &latency,
+                                              std::vector<std::string> &hosts) {
+    PlatformBuilder::Zone platform("AS0", "DijkstraCache");
+    int half = k / 2;
+
+    for (int c = 0; c < half * half; c++) {
+        platform.addRouter("core_" + std::to_string(c));
+    }
+    for (int p = 0; p < k; p++) {
+        for (int i = 0; i < half; i++) {
+            std::string edge = "edge_" + std::to_string(p) + "_" + std::to_string(i);
+            std::string aggregation = "agg_" + std::to_string(p) + "_" + std::to_string(i);
+            platform.addRouter(edge);
+            platform.addRouter(aggregation);
+            for (int h = 0; h < half; h++) {
+                addTopologyLink(platform, addTopologyHost(platform, hosts), edge, bandwidth, latency);
+            }
+            for (int c = 0; c < half; c++) {
+                addTopologyLink(platform, aggregation, "core_" + std::to_string(i * half + c), bandwidth, latency);
+            }
+        }
+        for (int i = 0; i < half; i++) {
+            for (int j = 0; j < half; j++) {
+                addTopologyLink(platform, "edge_" + std::to_string(p) + "_" + std::to_string(i),
+                                "agg_" + std::to_string(p) + "_" + std::to_string(j), bandwidth, latency);
+            }
+        }
+    }
+    addTopologyController(platform, "core_0");
+    return platform;
+}
+
+/**
+ * @brief Generate a dragonfly platform: groups of routers connected all-to-all within each group, one global
+ *        link between each pair of groups (spread over the routers of each group), and hosts attached to each
+ *        router. Routes are shortest paths (Dijkstra routing). The WMS host is attached to the first router.
+ * @param num_groups: the number of groups
+ * @param num_routers: the number of routers per group
+ * @param num_hosts: the number of hosts per router
+ * @param bandwidth: the link bandwidth (e.g., "1250MBps")
+ * @param latency: the link latency (e.g., "1us")
+ * @param hosts: set to the host names
+ * @return the platform description
+ */
+PlatformBuilder::Zone generateDragonflyPlatform(int num_groups, int num_routers, int num_hosts,
+                                                const std::string &bandwidth, const std::string &latency,
+                                                std::vector<std::string> &hosts) {
+    PlatformBuilder::Zone platform("AS0", "DijkstraCache");
+
+    auto router = [](int g, int r) {
+        return "router_" + std::to_string(g) + "_" + std::to_string(r);
+    };
+
+    for (int g = 0; g < num_groups; g++) {
+        for (int r = 0; r < num_routers; r++) {
+            platform.addRouter(router(g, r));
+            for (int h = 0; h < num_hosts; h++) {
+                addTopologyLink(platform, addTopologyHost(platform, hosts), router(g, r), bandwidth, latency);
+            }
+        }
+        for (int r = 0; r < num_routers; r++) {
+            for (int s = r + 1; s < num_routers; s++) {
+                addTopologyLink(platform, router(g, r), router(g, s), bandwidth, latency);
+            }
+        }
+    }
+
+    // the next router of each group to get a global link
+    std::vector<int> next_router(num_groups, 0);
+    for (int g = 0; g < num_groups; g++) {
+        for (int h = g + 1; h < num_groups; h++) {
+            addTopologyLink(platform, router(g, next_router[g]++ % num_routers),
+                            router(h, next_router[h]++ % num_routers), bandwidth, latency);
+        }
+    }
+    addTopologyController(platform, router(0, 0));
+    return platform;
+}
+
+/**
+ * @brief Read a transfer matrix, a CSV file with one "<source>,<destination>,<size>[,<start date>]" line per
+ *        flow, where the source and destination are host names or indices, the size is in MB and the start
+ *        date in seconds (0 by default). Empty lines, lines starting with # and a "source,..." header are ignored.
+ * @param path: the file path
+ * @param hosts: the host names
+ * @param max_num_flows: the maximum number of flows
+ * @return the flows, as transfers (without files)
+ *
+ * @throws std::invalid_argument
+ */
+std::vector<wrench::Transfer> readTransferMatrix(const std::string &path, const std::vector<std::string> &hosts,
+                                                 unsigned long max_num_flows) {
+    std::ifstream file(path);
+    if (not file) {
+        throw std::invalid_argument("cannot read transfer matrix " + path);
+    }
+
+    std::set<std::string> host_set(hosts.begin(), hosts.end());
+    auto host = [&hosts, &host_set, &path](const std::string &field) {
+        if (host_set.find(field) != host_set.end()) {
+            return field;
+        }
+        char *end;
+        long index = strtol(field.c_str(), &end, 10);
+        if (field.empty() or (*end != '\0') or (index < 0) or (index >= (long) hosts.size())) {
+            throw std::invalid_argument("unknown host " + field + " in transfer matrix " + path);
+        }
+        return hosts[index];
+    };
+
+    std::vector<wrench::Transfer> flows;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (not line.empty() and (line.back() == '\r')) {
+            line.pop_back();
+        }
+        if (line.empty() or (line[0] == '#') or (line.rfind("source", 0) == 0)) {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string field;
+        std::vector<std::string> values;
+        while (std::getline(fields, field, ',')) {
+            values.push_back(field);
+        }
+        if ((values.size() < 3) or (values.size() > 4)) {
+            throw std::invalid_argument("invalid line in transfer matrix " + path + ": " + line);
+        }
+
+        wrench::Transfer flow;
+        flow.id = "flow_" + std::to_string(flows.size());
+        flow.source = host(values[0]);
+        flow.destination = host(values[1]);
+        flow.size = std::stod(values[2]) * 1000.0 * 1000.0;
+        flow.start_date = (values.size() > 3) ? std::stod(values[3]) : 0.0;
+        flow.num_streams = 1;
+        flow.chunk_size = 0;
+        flow.completion_date = -1;
+        if ((flow.source == flow.destination) or (flow.size <= 0) or (flow.start_date < 0)) {
+            throw std::invalid_argument("invalid flow in transfer matrix " + path + ": " + line);
+        }
+        flows.push_back(flow);
+        if (flows.size() > max_num_flows) {
+            throw std::invalid_argument("too many flows in transfer matrix " + path + " (maximum " +
+                                        std::to_string(max_num_flows) + ")");
+        }
+    }
+    if (flows.empty()) {
+        throw std::invalid_argument("no flow in transfer matrix " + path);
     }
+    return flows;
+}
+
+/**
+ * @brief Simulate a transfer matrix on a generated fat-tree or dragonfly topology, and report the flow completion
+ *        time distribution and the most utilized links (flows.csv and links.csv in the output directory hold the
+ *        per-flow and per-link results)
+ * @param simulation: the simulation (initialized)
+ * @param argc: the argument count
+ * @param argv: the arguments
+ * @return the exit status
+ */
+int simulateTopology(wrench::Simulation &simulation, int argc, char **argv) {
+
+    const int MAX_NUM_HOSTS = 4096;
+    // reading a 100,000-flow transfer matrix takes 0.2 s, but simulating that many flows end to end has
+    // not been timed, so the limit is kept at 10,000 until it is
+    const unsigned long MAX_NUM_FLOWS = 10000;
+    const unsigned long NUM_HOT_SPOTS = 10;
+
+    std::vector<std::string> hosts;
+    PlatformBuilder::Zone platform("AS0");
+    std::vector<wrench::Transfer> flows;
+
+    try {
+        std::string topology;
+        std::string transfer_matrix;
+        std::string bandwidth = "1250MBps";
+        std::string latency = "1us";
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--topology=", 0) == 0) {
+                topology = arg.substr(strlen("--topology="));
+            } else if (arg.rfind("--transfers=", 0) == 0) {
+                transfer_matrix = arg.substr(strlen("--transfers="));
+            } else if (arg.rfind("--link-bandwidth=", 0) == 0) {
+                bandwidth = std::to_string(std::stod(arg.substr(strlen("--link-bandwidth=")))) + "MBps";
+            } else if (arg.rfind("--link-latency=", 0) == 0) {
+                latency = std::to_string(std::stod(arg.substr(strlen("--link-latency=")))) + "us";
+            } else {
+                throw std::invalid_argument("unexpected argument " + arg);
+            }
+        }
+        if (transfer_matrix.empty()) {
+            throw std::invalid_argument("missing --transfers");
+        }
+
+        // <type>:<parameters>
+        std::string type = topology.substr(0, topology.find(':'));
+        std::vector<int> parameters;
+        if (topology.find(':') != std::string::npos) {
+            std::istringstream values(topology.substr(topology.find(':') + 1));
+            std::string value;
+            while (std::getline(values, value, ',')) {
+                parameters.push_back(std::stoi(value));
+            }
+        }
+        if ((type == "fat-tree") and (parameters.size() == 1) and (parameters[0] >= 2) and (parameters[0] % 2 == 0) and
+            (parameters[0] * parameters[0] * parameters[0] / 4 <= MAX_NUM_HOSTS)) {
+            platform = generateFatTreePlatform(parameters[0], bandwidth, latency, hosts);
+        } else if ((type == "dragonfly") and (parameters.size() == 3) and
+                   std::all_of(parameters.begin(), parameters.end(), [](int p) { return p >= 1; }) and
+                   ((long) parameters[0] * parameters[1] * parameters[2] <= MAX_NUM_HOSTS)) {
+            platform = generateDragonflyPlatform(parameters[0], parameters[1], parameters[2], bandwidth, latency, hosts);
+        } else {
+            throw std::invalid_argument("invalid topology " + topology);
+        }
+
+        flows = readTransferMatrix(transfer_matrix, hosts, MAX_NUM_FLOWS);
+
+    } catch (std::invalid_argument &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << std::string(argv[0]) << " --topology=<topology> --transfers=<path>"
+                     " [--link-bandwidth=<MBps>] [--link-latency=<us>]" << std::endl;
+        std::cerr << "    topology: fat-tree:<k> (k even, k^3/4 hosts) or dragonfly:<groups>,<routers per group>,"
+                     "<hosts per router>, with at most " + std::to_string(MAX_NUM_HOSTS) + " hosts" << std::endl;
+        std::cerr << "    transfers: a CSV file with one <source>,<destination>,<size in MB>[,<start date>] line per"
+                     " flow (hosts are named host_<i>, or given by index), at most " +
+                     std::to_string(MAX_NUM_FLOWS) + " flows" << std::endl;
+        std::cerr << "    --link-bandwidth, --link-latency: the bandwidth and latency of every link"
+                     " (default: 1250 MBps, 1 us)" << std::endl;
+        return 1;
+    }
+
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(platform);
+    PhaseTimer::start("platform_instantiation");
+    simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
+
+    // one storage service per host that sends or receives a flow (disks are infinitely fast, so without a
+    // buffer each copy is a single network transfer)
+    std::map<std::string, std::shared_ptr<wrench::StorageService>> storage_services;
+    for (auto const &flow : flows) {
+        for (auto const &hostname : {flow.source, flow.destination}) {
+            if (storage_services.find(hostname) == storage_services.end()) {
+                storage_services[hostname] = simulation.add(new wrench::SimpleStorageService(
+                        hostname, {"/"}, {{wrench::SimpleStorageServiceProperty::BUFFER_SIZE, "infinity"}}));
+            }
+        }
+    }
+
+    wrench::Workflow workflow;
+    for (auto &flow : flows) {
+        flow.streams = {{workflow.addFile(flow.id, flow.size)}};
+    }
+
+    std::set<std::shared_ptr<wrench::StorageService>> storage_service_set;
+    for (auto const &storage_service : storage_services) {
+        storage_service_set.insert(storage_service.second);
+    }
+    auto wms = simulation.add(new wrench::ActivityWMS(storage_service_set, "controller", flows));
+    wms->addWorkflow(&workflow);
+
+    for (auto const &flow : flows) {
+        simulation.stageFile(flow.streams[0][0], storage_services.at(flow.source));
+    }
+
+    PhaseTimer::start("simulation");
+
+    simulation.launch();
+
+    PhaseTimer::start("output");
+
+    // flow completion times, and bytes sent over each link
+    std::vector<double> completion_times;
+    std::map<std::string, std::pair<double, double>> link_bytes; // link name -> (bandwidth, bytes)
+    std::map<std::pair<std::string, std::string>, std::vector<simgrid::s4u::Link *>> routes;
+    double total_size = 0;
+    double makespan = 0;
+    unsigned long num_failed = 0;
+    std::ofstream flows_file(OutputDirectory::path("flows.csv"));
+    flows_file << "flow,source,destination,size,start,end,duration" << std::endl;
+    for (auto const &flow : wms->getTransfers()) {
+        if (flow.completion_date < 0) {
+            // a chunk copy failed, the flow has no end date
+            flows_file << flow.id << "," << flow.source << "," << flow.destination << "," << flow.size << ","
+                       << flow.start_date << ",,\n";
+            num_failed++;
+            continue;
+        }
+        double duration = flow.completion_date - flow.start_date;
+        completion_times.push_back(duration);
+        total_size += flow.size;
+        makespan = std::max(makespan, flow.completion_date);
+        flows_file << flow.id << "," << flow.source << "," << flow.destination << "," << flow.size << ","
+                   << flow.start_date << "," << flow.completion_date << "," << duration << "\n";
+
+        auto route = routes.find({flow.source, flow.destination});
+        if (route == routes.end()) {
+            std::vector<simgrid::s4u::Link *> links;
+            simgrid::s4u::Host::by_name(flow.source)->route_to(simgrid::s4u::Host::by_name(flow.destination), links,
+                                                               nullptr);
+            route = routes.insert({{flow.source, flow.destination}, links}).first;
+        }
+        for (auto const &link : route->second) {
+            auto &bytes = link_bytes[link->get_name()];
+            bytes.first = link->get_bandwidth();
+            bytes.second += flow.size;
+        }
+    }
+    std::sort(completion_times.begin(), completion_times.end());
+
+    // links by decreasing utilization (bytes sent over the link / bytes the link could send until the makespan)
+    std::vector<std::pair<double, std::string>> utilizations;
+    std::ofstream links_file(OutputDirectory::path("links.csv"));
+    links_file << "link,bandwidth,bytes,utilization" << std::endl;
+    for (auto const &link : link_bytes) {
+        // if no flow completed, the makespan is 0 and so is the utilization
+        double utilization = (makespan > 0) ? link.second.second / (link.second.first * makespan) : 0;
+        utilizations.emplace_back(utilization, link.first);
+        links_file << link.first << "," << link.second.first << "," << link.second.second << "," << utilization << "\n";
+    }
+    std::sort(utilizations.begin(), utilizations.end(), std::greater<std::pair<double, std::string>>());
+
+    double mean = 0;
+    for (auto const &t : completion_times) {
+        mean += t / completion_times.size();
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout.precision(4);
+    std::cout << flows.size() << " flows between " << storage_services.size() << " of " << hosts.size()
+              << " hosts completed at time " << makespan;
+    if (makespan > 0) {
+        std::cout << " (" << (total_size / makespan / (1000.0 * 1000.0)) << " MBps aggregate throughput)";
+    }
+    std::cout << std::endl;
+    if (num_failed > 0) {
+        std::cout << num_failed << " flows failed" << std::endl;
+    }
+    if (not completion_times.empty()) {
+        std::cout << "Flow completion times: mean " << mean
+                  << ", p50 " << Statistics::percentile(completion_times, 50)
+                  << ", p90 " << Statistics::percentile(completion_times, 90)
+                  << ", p99 " << Statistics::percentile(completion_times, 99)
+                  << ", max " << completion_times.back() << std::endl;
+    }
+    std::cout << "Most utilized links:" << std::endl;
+    for (unsigned long i = 0; i < std::min(NUM_HOT_SPOTS, utilizations.size()); i++) {
+        std::cout << "  " << utilizations[i].second << ": " << (100.0 * utilizations[i].first) << "%" << std::endl;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    return 0;
 }
 
 int main(int argc, char **argv) {
+    BatchMode::init(&argc, &argv, "networking_fundamentals");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "networking_fundamentals");
+    EventLog::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "networking_fundamentals");
+
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]).rfind("--topology=", 0) == 0) {
+            return simulateTopology(simulation, argc, argv);
+        }
+    }
 
     const int MAX_NUM_FILES = 100;
     const int MAX_FILE_SIZE = 1000;
+    const int MAX_NUM_STREAMS = 64;
+    const int MAX_NUM_CHUNKS = 10000;
 
     std::vector<double> file_sizes;
+    std::vector<unsigned long> num_streams;
+    std::vector<double> chunk_sizes;
+    std::vector<int> latencies = {10, 10, 10};
+    bool transfer_options = false;
 
     try {
-        if (argc < 2) {
+        unsigned long default_num_streams = 1;
+        double default_chunk_size = 0;
+        std::vector<std::string> transfer_specs;
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--streams=", 0) == 0) {
+                default_num_streams = std::stoul(arg.substr(strlen("--streams=")));
+                transfer_options = true;
+            } else if (arg.rfind("--chunk-size=", 0) == 0) {
+                default_chunk_size = std::stod(arg.substr(strlen("--chunk-size=")));
+                transfer_options = true;
+            } else if (arg.rfind("--latencies=", 0) == 0) {
+                std::istringstream values(arg.substr(strlen("--latencies=")));
+                std::string value;
+                latencies.clear();
+                while (std::getline(values, value, ',')) {
+                    latencies.push_back(std::stoi(value));
+                }
+                if ((latencies.size() != 3) or
+                    std::any_of(latencies.begin(), latencies.end(), [](int latency) { return latency < 0; })) {
+                    std::cerr << "Invalid latencies. Enter three comma-separated latencies in us" << std::endl;
+                    throw std::invalid_argument("invalid latencies");
+                }
+            } else {
+                transfer_specs.push_back(arg);
+            }
+        }
+
+        if (transfer_specs.empty()) {
             throw std::invalid_argument("bad args");
         }
 
-        if (argc - 1 > MAX_NUM_FILES) {
+        if (transfer_specs.size() > MAX_NUM_FILES) {
             std::cerr << "Too many file sizes specified (maximum 100)" << std::endl;
             throw std::invalid_argument("invalid number of files");
         }
 
-        for (int i = 1; i < argc; i++) {
-            double size = std::stof(std::string(argv[i]));
+        for (auto const &spec : transfer_specs) {
+            // <file size>[:<streams>[:<chunk size>]]
+            std::istringstream fields(spec);
+            std::string field;
+            std::vector<std::string> values;
+            while (std::getline(fields, field, ':')) {
+                values.push_back(field);
+            }
+            if (values.empty() or (values.size() > 3)) {
+                throw std::invalid_argument("invalid transfer");
+            }
+
+            double size = std::stof(values[0]);
             if ((size < 1) || (size > MAX_FILE_SIZE)) {
                 std::cerr << "Invalid file size. Enter a file size in the range [1, " + std::to_string(MAX_FILE_SIZE) +
                              "] MB" << std::endl;
                 throw std::invalid_argument("invalid file size");
-            } else {
-                file_sizes.push_back(size);
             }
+            unsigned long streams = (values.size() > 1) ? std::stoul(values[1]) : default_num_streams;
+            if ((streams < 1) || (streams > MAX_NUM_STREAMS)) {
+                std::cerr << "Invalid number of streams. Enter a number of streams in the range [1, " +
+                             std::to_string(MAX_NUM_STREAMS) + "]" << std::endl;
+                throw std::invalid_argument("invalid number of streams");
+            }
+            double chunk_size = (values.size() > 2) ? std::stod(values[2]) : default_chunk_size;
+            if ((chunk_size < 0) || ((chunk_size > 0) && (size / chunk_size > MAX_NUM_CHUNKS))) {
+                std::cerr << "Invalid chunk size. Enter a chunk size that splits the file in at most " +
+                             std::to_string(MAX_NUM_CHUNKS) + " chunks" << std::endl;
+                throw std::invalid_argument("invalid chunk size");
+            }
+            transfer_options = transfer_options or (values.size() > 1);
+
+            file_sizes.push_back(size);
+            num_streams.push_back(streams);
+            chunk_sizes.push_back(chunk_size);
         }
 
     } catch (std::invalid_argument &e) {
-        std::cerr << "Usage: " << std::string(argv[0]) << " <file size> [file size]*" << std::endl;
+        std::cerr << "Usage: " << std::string(argv[0]) << " <transfer> [transfer]* [--streams=<n>] [--chunk-size=<MB>]"
+                     " [--latencies=<us>,<us>,<us>]" << std::endl;
+        std::cerr << "    transfer: <file size>[:<streams>[:<chunk size>]]" << std::endl;
         std::cerr << "    file size: the size of each file, a value in the range of [1, " +
                      std::to_string(MAX_FILE_SIZE) + "] MB" << std::endl;
         std::cerr << "    (at most " + std::to_string(MAX_FILE_SIZE) + " file sizes can be specified)" << std::endl;
+        std::cerr << "    streams: the number of parallel streams of the transfer, in the range of [1, " +
+                     std::to_string(MAX_NUM_STREAMS) + "] (default: --streams, or 1)" << std::endl;
+        std::cerr << "    chunk size: the size in MB of the chunks each stream copies one after the other"
+                     " (default: --chunk-size, or one chunk per stream)" << std::endl;
+        std::cerr << "    --latencies: the latencies of the three links (default: 10,10,10)" << std::endl;
         return 1;
     }
 
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, 100);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(100, latencies));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     // two storage services, one on each host
     const double STORAGE_CAPACITY = MAX_FILE_SIZE * MAX_NUM_FILES * 1000.0 * 1000.0;
@@ -140,11 +637,11 @@ int main(int argc, char **argv) {
 
     auto storage_service_2 = simulation.add(new wrench::SimpleStorageService("host2", {"/"}));
 
-    // wms
-    auto wms = simulation.add(new wrench::ActivityWMS({storage_service_1, storage_service_2}, "host1"));
-
     wrench::Workflow workflow;
-    generateWorkflow(&workflow, file_sizes);
+    auto transfers = generateWorkflow(&workflow, file_sizes, num_streams, chunk_sizes);
+
+    // wms
+    auto wms = simulation.add(new wrench::ActivityWMS({storage_service_1, storage_service_2}, "host1", transfers));
     wms->addWorkflow(&workflow);
 
     // file registry service
@@ -155,25 +652,39 @@ int main(int argc, char **argv) {
         simulation.stageFile(file, storage_service_1);
     }
 
-    simulation.launch();
+    PhaseTimer::start("simulation");
 
-    // Gather the data transfer completion times
-    std::map<wrench::WorkflowFile *, double> transfer_completion_times;
-
-    auto file_copy_starts = simulation.getOutput().getTrace<wrench::SimulationTimestampFileCopyStart>();
+    simulation.launch();
 
-    for (const auto &file_copy : file_copy_starts) {
-        double start_time = file_copy->getDate();
-        double end_time = file_copy->getContent()->getEndpoint()->getDate();
-        double duration = end_time - start_time;
-        transfer_completion_times[file_copy->getContent()->getFile()] = duration;
-    }
+    PhaseTimer::start("output");
 
     std::cout << "----------------------------------------" << std::endl;
     std::cout.precision(4);
-    for (const auto &tct : transfer_completion_times) {
-        std::cout << (tct.first->getSize() / (1000.0 * 1000.0)) << " MB transfer completed at time " << tct.second
-                  << "\n";
+    double total_size = 0;
+    double makespan = 0;
+    for (const auto &transfer : wms->getTransfers()) {
+        std::cout << (transfer.size / (1000.0 * 1000.0)) << " MB transfer";
+        if (transfer_options) {
+            std::cout << " (" << transfer.streams.size() << " stream" << ((transfer.streams.size() > 1) ? "s" : "");
+            if (transfer.chunk_size > 0) {
+                std::cout << ", " << (transfer.chunk_size / (1000.0 * 1000.0)) << " MB chunks";
+            }
+            std::cout << ")";
+        }
+        if (transfer.completion_date < 0) {
+            std::cout << " failed\n";
+            continue;
+        }
+        std::cout << " completed at time " << transfer.completion_date;
+        if (transfer_options) {
+            std::cout << " (" << (transfer.size / transfer.completion_date / (1000.0 * 1000.0)) << " MBps)";
+        }
+        std::cout << "\n";
+        total_size += transfer.size;
+        makespan = std::max(makespan, transfer.completion_date);
+    }
+    if (transfer_options and (makespan > 0)) {
+        std::cout << "Aggregate throughput: " << (total_size / makespan / (1000.0 * 1000.0)) << " MBps" << std::endl;
     }
     std::cout << "----------------------------------------" << std::endl;
 
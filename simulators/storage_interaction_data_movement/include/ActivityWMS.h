@@ -22,8 +22,27 @@ namespace wrench {
                     const std::string &hostname,
                     const std::shared_ptr<FileRegistryService> &file_registry_service);
 
+        /**
+         * @brief The registration of the first num_entries copied files in a file registry, one request per
+         *        file ("per-file") or as one batch ("batched"), and the time it took
+         */
+        struct Registration {
+            std::string mode;
+            unsigned long num_entries;
+            std::shared_ptr<FileRegistryService> file_registry;
+            double time;
+        };
+
+        void setRegistrations(const std::vector<WorkflowFile *> &files, const std::vector<Registration> &registrations);
+        const std::vector<Registration> &getRegistrations();
+
     private:
         int main() override;
+
+        void registerFiles(Registration &registration, const std::shared_ptr<StorageService> &storage_service);
+
+        std::vector<WorkflowFile *> files;
+        std::vector<Registration> registrations;
     };
 };
 
@@ -8,6 +8,8 @@
  */
 
 #include "ActivityWMS.h"
+#include "AdaptiveBandwidthMeter.h"
+#include "EventLog.h"
 #include <algorithm>
 #include <memory>
 
@@ -35,6 +37,43 @@ namespace wrench {
             "client_server"
     ) {}
 
+    /**
+     * @brief Copy several files, and register them with the given registrations (instead of the single file
+     *        copy with registration)
+     * @param files: the files to copy
+     * @param registrations: the registrations, done in order once the files are copied (or, for a single
+     *        "per-file" registration, after each file copy)
+     */
+    void ActivityWMS::setRegistrations(const std::vector<WorkflowFile *> &files,
+                                       const std::vector<Registration> &registrations) {
+        this->files = files;
+        this->registrations = registrations;
+    }
+
+    /**
+     * @brief Get the registrations, with their times once the simulation has completed
+     * @return the registrations
+     */
+    const std::vector<ActivityWMS::Registration> &ActivityWMS::getRegistrations() {
+        return this->registrations;
+    }
+
+    /**
+     * @brief Register the first copied files in the file registry of a registration. The file registry of a
+     *        batched registration charges the cost of the whole batch, split among its entries.
+     * @param registration: the registration (its time is updated)
+     * @param storage_service: the storage service that holds the copies
+     */
+    void ActivityWMS::registerFiles(Registration &registration, const std::shared_ptr<StorageService> &storage_service) {
+        EventLog::record("registration_start", {{"mode", registration.mode}, {"entries", registration.num_entries}});
+        double start = Simulation::getCurrentSimulatedDate();
+        for (unsigned long i = 0; i < registration.num_entries; i++) {
+            registration.file_registry->addEntry(this->files[i], FileLocation::LOCATION(storage_service));
+        }
+        registration.time = Simulation::getCurrentSimulatedDate() - start;
+        EventLog::record("registration_completion", {{"mode", registration.mode}, {"entries", registration.num_entries}});
+    }
+
     /**
      * @brief WMS main method
      * @return
@@ -42,16 +81,19 @@ namespace wrench {
     int ActivityWMS::main() {
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);
 
+        EventLog::record("wms_start");
+
         // Create a job manager
         auto data_manager = this->createDataMovementManager();
         auto job_manager = this->createJobManager();
         auto file_registry = this->getAvailableFileRegistryService();
 
-        // Start bandwidth meters
+        // Start bandwidth meters (recording link usage only when it changes)
         const double BANDWIDTH_METER_PERIOD = 0.01;
         std::vector<std::string> linknames;
         linknames.emplace_back("network_link");
-        auto em = this->createBandwidthMeter(linknames, BANDWIDTH_METER_PERIOD);
+        auto bandwidth_meter = AdaptiveBandwidthMeter::start(this->simulation, this->getHostname(), linknames,
+                                                             BANDWIDTH_METER_PERIOD);
 
         std::shared_ptr<StorageService> client_storage_service, server_storage_service;
         for (const auto &storage_service : this->getAvailableStorageServices()) {
@@ -62,21 +104,66 @@ namespace wrench {
             }
         }
 
+        if (not this->files.empty()) {
+            // a single per-file registration registers each file after its copy, as a copy with a file
+            // registry does, and the others register the files once they are all copied
+            bool per_file = (this->registrations.size() == 1) and (this->registrations[0].mode == "per-file");
+            double registration_time = 0;
+            for (auto const &file : this->files) {
+                EventLog::record("file_copy_start", {{"file", file->getID()},
+                                                     {"src",  client_storage_service->getHostname()},
+                                                     {"dst",  server_storage_service->getHostname()}});
+                data_manager->doSynchronousFileCopy(file,
+                                                    FileLocation::LOCATION(client_storage_service),
+                                                    FileLocation::LOCATION(server_storage_service));
+                if (per_file) {
+                    double start = Simulation::getCurrentSimulatedDate();
+                    this->registrations[0].file_registry->addEntry(file, FileLocation::LOCATION(server_storage_service));
+                    registration_time += Simulation::getCurrentSimulatedDate() - start;
+                }
+                EventLog::record("file_copy_completion", {{"file", file->getID()}, {"registered", per_file}});
+            }
+
+            if (per_file) {
+                this->registrations[0].time = registration_time;
+            } else {
+                for (auto &registration : this->registrations) {
+                    registerFiles(registration, server_storage_service);
+                }
+            }
+
+            WRENCH_INFO("Files sent and registered in the file registry!");
+
+            bandwidth_meter->flush();
+
+            EventLog::record("wms_end");
+
+            return 0;
+        }
+
         auto input_file = this->getWorkflow()->getFileByID("data_file");
 
         WRENCH_INFO("Sending the file over to the server running on host %s",
                     server_storage_service->getHostname().c_str());
 
         //  Copy the file over to the server
+        EventLog::record("file_copy_start", {{"file", input_file->getID()},
+                                             {"src",  client_storage_service->getHostname()},
+                                             {"dst",  server_storage_service->getHostname()}});
         data_manager->doSynchronousFileCopy(input_file,
                                             FileLocation::LOCATION(client_storage_service),
                                             FileLocation::LOCATION(server_storage_service),
                                             file_registry);
+        EventLog::record("file_copy_completion", {{"file", input_file->getID()}, {"registered", true}});
 
         WRENCH_INFO("File sent and registered in the file registry!");
 
         WRENCH_INFO("Simulation Complete!");
 
+        bandwidth_meter->flush();
+
+        EventLog::record("wms_end");
+
         return 0;
     }
 }
@@ -7,69 +7,110 @@
  * (at your option) any later version.
  */
 
+#include <cstring>
+#include <fstream>
+#include <map>
 #include <wrench-dev.h>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
+#include "AnalyticalEstimator.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
- * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
+ * @brief Generates a platform with a client, a storage service host and a file registry host
+ * @param link_bandwidth: bandwidth of the network link in MBps
+ * @return the platform description
  *
  * @throws std::invalid_argument
  */
-void generatePlatform(std::string &platform_file_path, int link_bandwidth) {
+PlatformBuilder::Zone generatePlatform(int link_bandwidth) {
 
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
     if (link_bandwidth < 1) {
         throw std::invalid_argument("generatePlatform() bandwidth must be greater than 1");
     }
 
-    // Create a the platform file
-    std::string xml_string = "<?xml version='1.0'?>\n"
-                             "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                             "<platform version=\"4.1\">\n"
-                             "   <zone id=\"AS0\" routing=\"Full\">\n"
-                             "       <host id=\"FileRegistryService\" speed=\"1f\" core=\"1\">\n"
-                             "       </host>\n"
-                             "       <host id=\"StorageService\" speed=\"100Gf\" core=\"1\">\n"
-                             "           <prop id=\"ram\" value=\"32GB\"/>\n"
-                             "           <disk id=\"large_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <host id=\"Client\" speed=\"100f\" core=\"1\">\n"
-                             "           <disk id=\"hard_disk\" read_bw=\"100000TBps\" write_bw=\"100000TBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n"
-                             "       <link id=\"network_link\" bandwidth=\"20MBps\" latency=\"20us\"/>\n"
-                             "       <route src=\"FileRegistryService\" dst=\"Client\">"
-                             "           <link_ctn id=\"network_link\"/>"
-                             "       </route>\n"
-                             "       <route src=\"FileRegistryService\" dst=\"StorageService\">"
-                             "           <link_ctn id=\"network_link\"/>"
-                             "       </route>\n"
-                             "       <route src=\"Client\" dst=\"StorageService\">"
-                             "           <link_ctn id=\"network_link\"/>"
-                             "       </route>\n"
-                             "   </zone>\n"
-                             "</platform>\n";
-
-
-    pugi::xml_document xml_doc;
-    if (xml_doc.load_string(xml_string.c_str(), pugi::parse_doctype)) {
-        pugi::xml_node link = xml_doc.child("platform").child("zone").child("link");
-        link.attribute("bandwidth").set_value(std::string(std::to_string(link_bandwidth) + "MBps").c_str());
-        xml_doc.save_file(platform_file_path.c_str());
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("FileRegistryService", "1f", 1);
+    platform.addHost("StorageService", "100Gf", 1)
+            .setProperty("ram", "32GB")
+            .addDisk("large_disk", "50MBps", "50MBps");
+    platform.addHost("Client", "100f", 1).addDisk("hard_disk", "100000TBps", "100000TBps");
+    platform.addLink("network_link", std::to_string(link_bandwidth) + "MBps", "20us");
+    platform.addRoute("FileRegistryService", "Client", {"network_link"});
+    platform.addRoute("FileRegistryService", "StorageService", {"network_link"});
+    platform.addRoute("Client", "StorageService", {"network_link"});
+    return platform;
+}
 
-    } else {
-        throw std::runtime_error("something went wrong with parsing xml string");
+/**
+ * @brief Closed-form estimate of the simulation (see AnalyticalEstimator): the file copy from the
+ *        client to the storage service, then the registration of the copy in the file registry
+ *
+ * @param args: the positional command-line arguments
+ * @param estimate: the estimated dates of the end of the file copy (and registration) and of the simulation
+ * @return false if the arguments are outside the range the estimate covers
+ */
+bool estimateSimulation(const std::vector<std::string> &args, nlohmann::json &estimate) {
+
+    const double MB = 1000.0 * 1000.0;
+    const double LATENCY = 20.0 / (1000.0 * 1000.0);
+    const double BUFFER_SIZE = 50000000;
+    const double CLIENT_DISK_BANDWIDTH = 100000.0 * MB * MB; // 100000TBps
+    const double SERVER_DISK_BANDWIDTH = 50 * MB;
+    // file copy request and answer, and file write request and answer between the storage services
+    const int FILE_COPY_CONTROL_MESSAGES = 4;
+    // add entry request and answer between the client and the file registry
+    const int FILE_REGISTRY_CONTROL_MESSAGES = 2;
+
+    if (args.size() != 3) {
+        return false;
+    }
+    int link_bandwidth = std::stoi(args[0]);
+    int file_size = std::stoi(args[1]);
+    int file_registry_overhead = std::stoi(args[2]);
+
+    if ((link_bandwidth < 1) || (link_bandwidth > 1000000) ||
+        (file_size < 1) || (file_size > 10000) ||
+        (file_registry_overhead < 0) || (file_registry_overhead > 10)) {
+        return false;
+    }
+
+    double bandwidth = link_bandwidth * MB;
+    double copy_time;
+    if (not AnalyticalEstimator::fileCopyTime(file_size * MB, BUFFER_SIZE, CLIENT_DISK_BANDWIDTH, bandwidth, LATENCY,
+                                              SERVER_DISK_BANDWIDTH, copy_time)) {
+        return false;
     }
+    double control_message_time = AnalyticalEstimator::messageTime(AnalyticalEstimator::CONTROL_MESSAGE_SIZE,
+                                                                   bandwidth, LATENCY);
+
+    // the file registry host computes at 1 flop/sec, so the add entry compute cost is in seconds
+    double file_copy_end = (FILE_COPY_CONTROL_MESSAGES + FILE_REGISTRY_CONTROL_MESSAGES) * control_message_time +
+                           copy_time + file_registry_overhead;
+    estimate["file_copy_end"] = file_copy_end;
+    estimate["makespan"] = file_copy_end;
+    return true;
+}
+
+/**
+ * @brief The parameter sets on which the estimate is checked against the simulation (--self-check)
+ * @return a list of positional command-line arguments
+ */
+std::vector<std::vector<std::string>> selfCheckGrid() {
+    std::vector<std::vector<std::string>> grid;
+    for (auto const &link_bandwidth : {"10", "100", "1000"}) {
+        for (auto const &file_size : {"1", "100", "1000"}) {
+            for (auto const &file_registry_overhead : {"0", "5"}) {
+                grid.push_back({link_bandwidth, file_size, file_registry_overhead});
+            }
+        }
+    }
+    return grid;
 }
 
 /**
@@ -80,33 +121,72 @@ void generatePlatform(std::string &platform_file_path, int link_bandwidth) {
  */
 int main(int argc, char **argv) {
 
+    BatchMode::init(&argc, &argv, "storage_interaction_data_movement");
+    // the estimate only covers the copy of a single file, with the default registration
+    AnalyticalEstimator::init(&argc, argv, "storage_interaction_data_movement", estimateSimulation,
+                              selfCheckGrid(), {"--num-files=", "--registration="});
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "storage_interaction_data_movement");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "storage_interaction_data_movement");
 
     int SERVER_LINK_BANDWIDTH;
     int FILE_SIZE;
     int FILE_REGISTRY_OVERHEAD;
     const double MB = 1000.0 * 1000.0;
 
+    // multi-file mode: the number of files, and how they are registered
+    const int MAX_NUM_FILES = 1000;
+    int NUM_FILES = 1;
+    std::string REGISTRATION;
+
     try {
-        if (argc != 4) {
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--num-files=", 0) == 0) {
+                NUM_FILES = std::stoi(arg.substr(strlen("--num-files=")));
+            } else if (arg.rfind("--registration=", 0) == 0) {
+                REGISTRATION = arg.substr(strlen("--registration="));
+            } else {
+                arguments.push_back(arg);
+            }
+        }
+
+        if (arguments.size() != 3) {
             throw std::invalid_argument("invalid number of arguments");
         }
 
-        SERVER_LINK_BANDWIDTH = std::stoi(std::string(argv[1]));
+        if (NUM_FILES < 1 || NUM_FILES > MAX_NUM_FILES) {
+            std::cerr << "Invalid number of files. Number must be in range [1," << MAX_NUM_FILES << "]" << std::endl;
+            throw std::invalid_argument("Invalid number of files.");
+        }
+        if ((NUM_FILES > 1) and REGISTRATION.empty()) {
+            REGISTRATION = "per-file";
+        }
+        if (not REGISTRATION.empty() and
+            (REGISTRATION != "per-file") and (REGISTRATION != "batched") and (REGISTRATION != "compare")) {
+            std::cerr << "Invalid registration. Registration must be per-file, batched or compare" << std::endl;
+            throw std::invalid_argument("Invalid registration.");
+        }
+
+        SERVER_LINK_BANDWIDTH = std::stoi(arguments[0]);
         if (SERVER_LINK_BANDWIDTH < 1 || SERVER_LINK_BANDWIDTH > 1000000) {
             std::cerr << "Invalid server1 link bandwidth. bandwidth must be in range [1,1000000] MBps" << std::endl;
             throw std::invalid_argument("invalid server1 link bandwidth");
         }
 
-        FILE_SIZE = std::stoi(std::string(argv[2]));
+        FILE_SIZE = std::stoi(arguments[1]);
 
         if (FILE_SIZE < 1 || FILE_SIZE > 10000) {
             std::cerr << "Invalid file size. Size must be in range [1,10000] MB" << std::endl;
             throw std::invalid_argument("Invalid file size.");
         }
 
-        FILE_REGISTRY_OVERHEAD = std::stoi(std::string(argv[3]));
+        FILE_REGISTRY_OVERHEAD = std::stoi(arguments[2]);
         if (FILE_REGISTRY_OVERHEAD < 0 || FILE_REGISTRY_OVERHEAD > 10) {
             std::cerr << "Invalid overhead for file registry. Overhead must be in range [0, 10] sec" << std::endl;
             throw std::invalid_argument("Invalid overhead for file registry.");
@@ -117,18 +197,31 @@ int main(int argc, char **argv) {
         std::cerr << "Usage: " << argv[0] << " <server_link_bandwidth> <file_size>" << std::endl;
         std::cerr << "   server_link_bandwidth: Bandwidth must be in range [1,1000000] MBps" << std::endl;
         std::cerr << "   file size: File size must be in range [1,100000] MBps" << std::endl;
+        std::cerr << "   --num-files=<n>: copy n files of that size (in range [1," << MAX_NUM_FILES << "])" << std::endl;
+        std::cerr << "   --registration=per-file|batched|compare: register the files with one request per file"
+                     " (default), as one batch charged the file registry overhead once, or compare both for"
+                     " increasing numbers of files (registration_report.json in the output directory)" << std::endl;
         std::cerr << "" << std::endl;
         return 1;
     }
 
     // create workflow
     wrench::Workflow workflow;
-    workflow.addFile("data_file", FILE_SIZE * MB);
+    std::vector<wrench::WorkflowFile *> files;
+    if (REGISTRATION.empty()) {
+        workflow.addFile("data_file", FILE_SIZE * MB);
+    } else {
+        for (int i = 0; i < NUM_FILES; i++) {
+            files.push_back(workflow.addFile("data_file_" + std::to_string(i), FILE_SIZE * MB));
+        }
+    }
 
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, SERVER_LINK_BANDWIDTH);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(SERVER_LINK_BANDWIDTH));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     const std::string CLIENT("Client");
     const std::string FILEREGISTRY("FileRegistryService");
@@ -155,15 +248,92 @@ int main(int argc, char **argv) {
 
     wms->addWorkflow(&workflow);
 
-    //staging file to be copied on client storage service
-    auto file = workflow.getFileByID("data_file");
-    simulation.stageFile(file, client_storage_service);
+    // WRENCH's file registry has no bulk request: a batch of n entries is modeled as n add entry
+    // requests to a file registry that charges 1/n of the overhead per entry, i.e., the overhead once
+    if (not REGISTRATION.empty()) {
+        auto batched_file_registry = [&simulation, &FILEREGISTRY, FILE_REGISTRY_OVERHEAD](unsigned long num_entries) {
+            return simulation.add(new wrench::FileRegistryService(FILEREGISTRY, {
+                    {wrench::FileRegistryServiceProperty::ADD_ENTRY_COMPUTE_COST,
+                     std::to_string((double) FILE_REGISTRY_OVERHEAD / (double) num_entries)}
+            }, {}));
+        };
+
+        std::vector<wrench::ActivityWMS::Registration> registrations;
+        if (REGISTRATION == "compare") {
+            // 1, 2, 5, 10, 20, 50, ... files, and all of them
+            std::vector<unsigned long> counts;
+            for (unsigned long scale = 1; scale < (unsigned long) NUM_FILES; scale *= 10) {
+                for (auto const &factor : {1, 2, 5}) {
+                    if (scale * factor < (unsigned long) NUM_FILES) {
+                        counts.push_back(scale * factor);
+                    }
+                }
+            }
+            counts.push_back(NUM_FILES);
+            for (auto const &count : counts) {
+                registrations.push_back({"per-file", count, file_registry, 0});
+                registrations.push_back({"batched", count, batched_file_registry(count), 0});
+            }
+        } else if (REGISTRATION == "batched") {
+            registrations.push_back({"batched", (unsigned long) NUM_FILES, batched_file_registry(NUM_FILES), 0});
+        } else {
+            registrations.push_back({"per-file", (unsigned long) NUM_FILES, file_registry, 0});
+        }
+        wms->setRegistrations(files, registrations);
+    }
+
+    //staging files to be copied on client storage service
+    if (REGISTRATION.empty()) {
+        auto file = workflow.getFileByID("data_file");
+        simulation.stageFile(file, client_storage_service);
+    } else {
+        for (auto const &file : files) {
+            simulation.stageFile(file, client_storage_service);
+        }
+    }
 
     simulation.getOutput().enableDiskTimestamps(true);
 
+    PhaseTimer::start("simulation");
+
     simulation.launch();
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", false, false, false, false, false, true, true);
+    PhaseTimer::start("output");
+
+    if (not REGISTRATION.empty()) {
+        nlohmann::json report = {{"num_files",              NUM_FILES},
+                                 {"file_size",              FILE_SIZE},
+                                 {"file_registry_overhead", FILE_REGISTRY_OVERHEAD},
+                                 {"registration",           REGISTRATION}};
+        std::map<unsigned long, double> per_file_times;
+        for (auto const &registration : wms->getRegistrations()) {
+            nlohmann::json entry = {{"mode",           registration.mode},
+                                    {"num_entries",    registration.num_entries},
+                                    {"time",           registration.time},
+                                    {"time_per_entry", registration.time / registration.num_entries}};
+            if (registration.mode == "per-file") {
+                per_file_times[registration.num_entries] = registration.time;
+            } else if (per_file_times.find(registration.num_entries) != per_file_times.end()) {
+                entry["speedup"] = per_file_times[registration.num_entries] / registration.time;
+            }
+            report["registrations"].push_back(entry);
+
+            std::cout << registration.num_entries << " files, " << registration.mode << " registration: "
+                      << registration.time << " sec" << std::endl;
+        }
+        std::ofstream report_file(OutputDirectory::path("registration_report.json"));
+        report_file << report.dump() << std::endl;
+    }
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), false, false, false, false, false, true, true);
+
+    }
 
     return 0;
 }
@@ -10,7 +10,9 @@
 #ifndef ACTIVITY_WMS_H
 #define ACTIVITY_WMS_H
 
+#include <deque>
 #include <wrench-dev.h>
+#include <nlohmann/json.hpp>
 
 namespace wrench {
 
@@ -20,10 +22,58 @@ namespace wrench {
     public:
         ActivityWMS(const std::shared_ptr<FileRegistryService> &file_registry,
                     const std::set<std::shared_ptr<NetworkProximityService>> &network_proximity, const std::set<std::shared_ptr<StorageService>> &storage_services,
-                    const std::string &hostname);
+                    const std::string &hostname, const std::map<std::string, double> &transfer_times,
+                    double probe_period, int probe_budget);
+
+        void setMultiSourceDownload(int num_sources, const std::vector<WorkflowFile *> &chunks,
+                                    const std::string &chunk_weighting);
+        void setWarmStartDistances(const std::map<std::string, double> &distances);
+
+        nlohmann::json getProximityReport();
 
     private:
+        /** @brief A source of a multi-source download, and the chunks it is to send (in proportion to its weight) */
+        struct DownloadSource {
+            std::shared_ptr<StorageService> storage_service;
+            double weight;
+            std::deque<WorkflowFile *> queue;
+            WorkflowFile *in_flight;
+            double in_flight_start;
+            double busy_time;
+            double bytes;
+            unsigned long num_chunks;
+
+            double getThroughput() const;
+        };
+
         int main() override;
+
+        std::shared_ptr<StorageService> selectStorageService(
+                const std::shared_ptr<NetworkProximityService> &np_service,
+                const std::vector<std::shared_ptr<StorageService>> &storage_services,
+                std::map<std::shared_ptr<StorageService>, double> &distances, unsigned long &num_known, bool record);
+        unsigned long getRank(const std::shared_ptr<StorageService> &storage_service);
+
+        nlohmann::json multiSourceDownload(const std::shared_ptr<DataMovementManager> &data_manager,
+                                           const std::vector<std::shared_ptr<StorageService>> &storage_services,
+                                           const std::map<std::shared_ptr<StorageService>, double> &distances,
+                                           const std::shared_ptr<StorageService> &client_storage_service);
+        void startNextChunk(const std::shared_ptr<DataMovementManager> &data_manager, DownloadSource &source,
+                            const std::shared_ptr<StorageService> &client_storage_service);
+        static void assignChunks(std::vector<DownloadSource> &sources, const std::vector<WorkflowFile *> &chunks);
+
+        /** @brief The (ground truth) time to transfer the file from each storage server to the client */
+        std::map<std::string, double> transfer_times;
+        double probe_period;
+        int probe_budget;
+
+        std::map<std::string, double> warm_start_distances;
+
+        int num_download_sources = 1;
+        std::vector<WorkflowFile *> chunks;
+        std::string chunk_weighting;
+
+        nlohmann::json proximity_report;
     };
 };
 
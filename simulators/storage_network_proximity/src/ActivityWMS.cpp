@@ -8,6 +8,10 @@
  */
 
 #include "ActivityWMS.h"
+#include "EventLog.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <memory>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms, "Log category for Simple WMS");
@@ -16,17 +20,341 @@ namespace wrench {
 
     /**
      * @brief WMS constructor
-     * @param standard_job_scheduler
-     * @param compute_services
+     * @param file_registry
+     * @param network_proximity
      * @param storage_services
      * @param hostname
+     * @param transfer_times: the (ground truth) time to transfer the file from each storage server to the client
+     * @param probe_period: the measurement period of the network proximity service in seconds
+     * @param probe_budget: the number of measurement periods to wait for before selecting a storage server
      */
     ActivityWMS::ActivityWMS(const std::shared_ptr<FileRegistryService> &file_registry,
                              const std::set<std::shared_ptr<NetworkProximityService>> &network_proximity,
                              const std::set<std::shared_ptr<StorageService>> &storage_services,
-                             const std::string &hostname) :
+                             const std::string &hostname, const std::map<std::string, double> &transfer_times,
+                             double probe_period, int probe_budget) :
             WMS(nullptr, nullptr, {}, storage_services, network_proximity, file_registry, hostname,
-                "client_server") {}
+                "client_server"), transfer_times(transfer_times), probe_period(probe_period),
+            probe_budget(probe_budget) {}
+
+    /**
+     * @brief Download the file from several servers at once after the single-server download, as chunks
+     *        (the chunk files, which are staged on every server, hold the content of the file)
+     * @param num_sources: the number of servers (the closest ones) to download from
+     * @param chunks: the chunk files
+     * @param chunk_weighting: "proximity" to assign chunks to servers in inverse proportion to their distance
+     *        to the client, "bandwidth" to assign them evenly and then in proportion to the measured throughput
+     *        of each server
+     */
+    void ActivityWMS::setMultiSourceDownload(int num_sources, const std::vector<WorkflowFile *> &chunks,
+                                             const std::string &chunk_weighting) {
+        this->num_download_sources = num_sources;
+        this->chunks = chunks;
+        this->chunk_weighting = chunk_weighting;
+    }
+
+    /**
+     * @brief Get the convergence and accuracy of the storage server selection (once the simulation has completed):
+     *        the selection after each measurement period, the date from which the selection no longer changed,
+     *        and the rank of the selected server among all servers ordered by transfer time (1 is the best)
+     * @return a JSON object
+     */
+    nlohmann::json ActivityWMS::getProximityReport() {
+        return this->proximity_report;
+    }
+
+    /**
+     * @brief Use the distances between the client and the storage servers measured in a previous run, instead of
+     *        waiting for the network proximity service to measure them
+     * @param distances: the distance between the client and each storage server
+     */
+    void ActivityWMS::setWarmStartDistances(const std::map<std::string, double> &distances) {
+        this->warm_start_distances = distances;
+    }
+
+    /**
+     * @brief Select the storage server closest to the client according to the network proximity service
+     *        (or to the warm start distances)
+     * @param np_service: the network proximity service
+     * @param storage_services: the storage servers
+     * @param distances: set to the known distances between the servers and the client
+     * @param num_known: set to the number of servers whose distance to the client is known
+     * @param record: whether to log and record the distances
+     * @return the closest storage server
+     */
+    std::shared_ptr<StorageService> ActivityWMS::selectStorageService(
+            const std::shared_ptr<NetworkProximityService> &np_service,
+            const std::vector<std::shared_ptr<StorageService>> &storage_services,
+            std::map<std::shared_ptr<StorageService>, double> &distances, unsigned long &num_known, bool record) {
+
+        std::shared_ptr<StorageService> chosen_storage_service = *storage_services.begin();
+        double min_distance = DBL_MAX;
+        distances.clear();
+        num_known = 0;
+
+        //find minimal distance between the storage service and client host
+        for (const auto &storage_service : storage_services) {
+            double proximity = -1;
+            if (this->warm_start_distances.empty()) {
+                proximity = np_service->getHostPairDistance({"Client", storage_service->getHostname()}).first;
+            } else if (this->warm_start_distances.find(storage_service->getHostname()) !=
+                       this->warm_start_distances.end()) {
+                proximity = this->warm_start_distances.at(storage_service->getHostname());
+            }
+            if ((proximity < 0) or (proximity >= DBL_MAX)) {
+                continue;
+            }
+            num_known++;
+            distances[storage_service] = proximity;
+
+            if (record) {
+                TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_GREEN);
+
+                WRENCH_INFO("Proximity between Client and host %s is %e",
+                            storage_service->getHostname().c_str(), proximity);
+                EventLog::record("proximity", {{"hosts",    {"Client", storage_service->getHostname()}},
+                                               {"distance", proximity}});
+            }
+
+            if (proximity < min_distance) {
+                min_distance = proximity;
+                chosen_storage_service = storage_service;
+            }
+        }
+        return chosen_storage_service;
+    }
+
+    /**
+     * @brief Get the rank of a storage server among all servers ordered by transfer time to the client
+     * @param storage_service: the storage server
+     * @return a rank (1 for the servers with the shortest transfer time)
+     */
+    unsigned long ActivityWMS::getRank(const std::shared_ptr<StorageService> &storage_service) {
+        double transfer_time = this->transfer_times.at(storage_service->getHostname());
+        unsigned long rank = 1;
+        for (auto const &t : this->transfer_times) {
+            if (t.second < transfer_time) {
+                rank++;
+            }
+        }
+        return rank;
+    }
+
+    /**
+     * @brief Get the throughput of a download source
+     * @return the throughput in bytes/sec, or 0 if no chunk was received from the source yet
+     */
+    double ActivityWMS::DownloadSource::getThroughput() const {
+        return (this->busy_time > 0) ? this->bytes / this->busy_time : 0.0;
+    }
+
+    /**
+     * @brief Assign chunks to download sources in proportion to their weights (the chunks already queued
+     *        at a source are kept)
+     * @param sources: the download sources
+     * @param chunks: the chunks, which are appended to the queues in order
+     */
+    void ActivityWMS::assignChunks(std::vector<DownloadSource> &sources, const std::vector<WorkflowFile *> &chunks) {
+        double total_weight = 0;
+        for (auto const &source : sources) {
+            total_weight += source.weight;
+        }
+
+        // largest remainder method
+        std::vector<unsigned long> counts;
+        std::vector<std::pair<double, unsigned long>> remainders;
+        unsigned long num_assigned = 0;
+        for (unsigned long i = 0; i < sources.size(); i++) {
+            double share = chunks.size() * sources[i].weight / total_weight;
+            counts.push_back((unsigned long) std::floor(share));
+            remainders.emplace_back(share - std::floor(share), i);
+            num_assigned += counts.back();
+        }
+        std::sort(remainders.begin(), remainders.end(), std::greater<std::pair<double, unsigned long>>());
+        for (unsigned long i = 0; num_assigned < chunks.size(); i++, num_assigned++) {
+            counts[remainders[i % remainders.size()].second]++;
+        }
+
+        auto chunk = chunks.begin();
+        for (unsigned long i = 0; i < sources.size(); i++) {
+            for (unsigned long j = 0; j < counts[i]; j++) {
+                sources[i].queue.push_back(*(chunk++));
+            }
+        }
+    }
+
+    /**
+     * @brief Start the copy of the next queued chunk of a download source, if any
+     * @param data_manager: the data movement manager
+     * @param source: the download source
+     * @param client_storage_service: the storage service to download to
+     */
+    void ActivityWMS::startNextChunk(const std::shared_ptr<DataMovementManager> &data_manager, DownloadSource &source,
+                                     const std::shared_ptr<StorageService> &client_storage_service) {
+        if (source.queue.empty()) {
+            return;
+        }
+        source.in_flight = source.queue.front();
+        source.queue.pop_front();
+        source.in_flight_start = Simulation::getCurrentSimulatedDate();
+        EventLog::record("file_copy_start", {{"file", source.in_flight->getID()},
+                                             {"src",  source.storage_service->getHostname()},
+                                             {"dst",  client_storage_service->getHostname()}});
+        data_manager->initiateAsynchronousFileCopy(source.in_flight,
+                                                   FileLocation::LOCATION(source.storage_service),
+                                                   FileLocation::LOCATION(client_storage_service));
+    }
+
+    /**
+     * @brief Download the chunks concurrently from the closest servers, one chunk at a time per server. A server
+     *        that has sent all its chunks takes a queued chunk from the server expected to finish last, if it can
+     *        send it sooner (and, with the "bandwidth" chunk weighting, the queued chunks are re-assigned in
+     *        proportion to the measured throughputs after each chunk)
+     * @param data_manager: the data movement manager
+     * @param storage_services: the storage servers
+     * @param distances: the distances between the servers and the client
+     * @param client_storage_service: the storage service to download to
+     * @return the download report
+     *
+     * @throws std::runtime_error
+     */
+    nlohmann::json ActivityWMS::multiSourceDownload(const std::shared_ptr<DataMovementManager> &data_manager,
+                                                    const std::vector<std::shared_ptr<StorageService>> &storage_services,
+                                                    const std::map<std::shared_ptr<StorageService>, double> &distances,
+                                                    const std::shared_ptr<StorageService> &client_storage_service) {
+
+        // the closest servers (those whose distance is unknown last)
+        std::vector<std::pair<double, std::shared_ptr<StorageService>>> ranked;
+        for (auto const &storage_service : storage_services) {
+            auto distance = distances.find(storage_service);
+            ranked.emplace_back((distance != distances.end()) ? distance->second : DBL_MAX, storage_service);
+        }
+        std::stable_sort(ranked.begin(), ranked.end(),
+                         [](const std::pair<double, std::shared_ptr<StorageService>> &a,
+                            const std::pair<double, std::shared_ptr<StorageService>> &b) {
+                             return a.first < b.first;
+                         });
+
+        std::vector<DownloadSource> sources;
+        for (unsigned long i = 0; i < std::min<unsigned long>(this->num_download_sources, ranked.size()); i++) {
+            double weight = 1.0;
+            if ((this->chunk_weighting == "proximity") and (ranked[i].first < DBL_MAX)) {
+                weight = 1.0 / std::max<double>(ranked[i].first, DBL_MIN);
+            }
+            sources.push_back(DownloadSource{ranked[i].second, weight, {}, nullptr, 0, 0, 0, 0});
+        }
+        if (this->chunk_weighting == "proximity") {
+            // servers whose distance is unknown get the smallest known weight
+            double min_weight = DBL_MAX;
+            for (unsigned long i = 0; i < sources.size(); i++) {
+                if (ranked[i].first < DBL_MAX) {
+                    min_weight = std::min<double>(min_weight, sources[i].weight);
+                }
+            }
+            for (unsigned long i = 0; i < sources.size(); i++) {
+                if ((ranked[i].first == DBL_MAX) and (min_weight < DBL_MAX)) {
+                    sources[i].weight = min_weight;
+                }
+            }
+        }
+        assignChunks(sources, this->chunks);
+
+        WRENCH_INFO("Receiving the file as %lu chunks from %lu servers", this->chunks.size(), sources.size());
+        double download_start = Simulation::getCurrentSimulatedDate();
+        for (auto &source : sources) {
+            this->startNextChunk(data_manager, source, client_storage_service);
+        }
+
+        unsigned long num_stolen = 0;
+        while (std::any_of(sources.begin(), sources.end(), [](const DownloadSource &s) { return s.in_flight; })) {
+            auto event = this->waitForNextEvent();
+            if (auto failure = std::dynamic_pointer_cast<FileCopyFailedEvent>(event)) {
+                throw std::runtime_error("Chunk download failed: " + failure->failure_cause->toString());
+            }
+            auto completion = std::dynamic_pointer_cast<FileCopyCompletedEvent>(event);
+            if (not completion) {
+                continue;
+            }
+            auto source = std::find_if(sources.begin(), sources.end(), [&completion](const DownloadSource &s) {
+                return s.in_flight == completion->file;
+            });
+            if (source == sources.end()) {
+                continue;
+            }
+            EventLog::record("file_copy_completion", {{"file", completion->file->getID()}});
+            source->busy_time += Simulation::getCurrentSimulatedDate() - source->in_flight_start;
+            source->bytes += completion->file->getSize();
+            source->num_chunks++;
+            source->in_flight = nullptr;
+
+            if (this->chunk_weighting == "bandwidth") {
+                // re-assign the queued chunks in proportion to the measured throughputs (or evenly, until
+                // every server has sent a chunk)
+                if (std::all_of(sources.begin(), sources.end(), [](const DownloadSource &s) {
+                    return s.getThroughput() > 0;
+                })) {
+                    std::set<WorkflowFile *> queued_set;
+                    for (auto &s : sources) {
+                        queued_set.insert(s.queue.begin(), s.queue.end());
+                        s.queue.clear();
+                        s.weight = s.getThroughput();
+                    }
+                    std::vector<WorkflowFile *> queued;
+                    for (auto const &chunk : this->chunks) {
+                        if (queued_set.find(chunk) != queued_set.end()) {
+                            queued.push_back(chunk);
+                        }
+                    }
+                    assignChunks(sources, queued);
+                }
+            }
+
+            if (source->queue.empty()) {
+                // take a chunk from the server expected to finish last, if this server can send it sooner
+                auto remaining_time = [](const DownloadSource &s) {
+                    double queued_bytes = 0;
+                    for (auto const &chunk : s.queue) {
+                        queued_bytes += chunk->getSize();
+                    }
+                    return (s.getThroughput() > 0) ? queued_bytes / s.getThroughput() : DBL_MAX;
+                };
+                auto slowest = std::max_element(sources.begin(), sources.end(),
+                                                [&remaining_time](const DownloadSource &a, const DownloadSource &b) {
+                                                    return (a.queue.empty() ? -1.0 : remaining_time(a)) <
+                                                           (b.queue.empty() ? -1.0 : remaining_time(b));
+                                                });
+                if (not slowest->queue.empty()) {
+                    auto chunk = slowest->queue.back();
+                    if (chunk->getSize() / source->getThroughput() < remaining_time(*slowest)) {
+                        slowest->queue.pop_back();
+                        source->queue.push_back(chunk);
+                        num_stolen++;
+                    }
+                }
+            }
+
+            this->startNextChunk(data_manager, *source, client_storage_service);
+        }
+        double download_time = Simulation::getCurrentSimulatedDate() - download_start;
+
+        double file_size = 0;
+        for (auto const &chunk : this->chunks) {
+            file_size += chunk->getSize();
+        }
+        nlohmann::json report = {{"chunk_weighting", this->chunk_weighting},
+                                 {"num_chunks",      this->chunks.size()},
+                                 {"time",            download_time},
+                                 {"bandwidth",       file_size / download_time},
+                                 {"num_rebalanced",  num_stolen},
+                                 {"sources",         nlohmann::json::array()}};
+        for (auto const &source : sources) {
+            report["sources"].push_back({{"server",     source.storage_service->getHostname()},
+                                         {"num_chunks", source.num_chunks},
+                                         {"bytes",      source.bytes},
+                                         {"bandwidth",  source.getThroughput()}});
+        }
+        return report;
+    }
 
     /**
      * @brief WMS main method
@@ -35,6 +363,8 @@ namespace wrench {
     int ActivityWMS::main() {
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_MAGENTA);
 
+        EventLog::record("wms_start");
+
         auto input_file = this->getWorkflow()->getFileByID("data.file");
 
         // Create a job manager
@@ -58,43 +388,82 @@ namespace wrench {
         for (const auto &storage_service : server_storage_services) {
             // storing file into storage service
             WRENCH_INFO("Storing file into storage service %s", storage_service->getHostname().c_str());
+            EventLog::record("file_copy_start", {{"file", input_file->getID()},
+                                                 {"src",  client_storage_service->getHostname()},
+                                                 {"dst",  storage_service->getHostname()}});
             data_manager->doSynchronousFileCopy(input_file,
                                                 FileLocation::LOCATION(client_storage_service),
                                                 FileLocation::LOCATION(storage_service),
                                                 file_registry);
+            EventLog::record("file_copy_completion", {{"file", input_file->getID()}});
         }
         file_registry->removeEntry(input_file, FileLocation::LOCATION(client_storage_service));
 
-        WRENCH_INFO("Sleep for 30 minutes so Network Proximity Service has time to ping and find proximity");
-        Simulation::sleep(1800.0);
-
         // using network proximity service
-        WRENCH_INFO("Using Network Proximity Service to find closest storage unit...");
-        std::shared_ptr<StorageService> chosen_storage_service = *server_storage_services.begin();
-        auto np_service = *np_services.begin();
-        double min_distance = DBL_MAX;
-
-//        WRENCH_INFO("Network Proximity algorithm: %s", np_service->getNetworkProximityServiceType().c_str());
-
-        //find minimal distance between the storage service and client host
-        for (const auto &storage_service : server_storage_services) {
-            if (storage_service->getHostname() != "Client") {
-                double proximity = np_service->getHostPairDistance(
-                        {"Client", storage_service->getHostname()}).first;
-
-                TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_GREEN);
+        bool warm_start = not this->warm_start_distances.empty();
+        auto np_service = np_services.empty() ? nullptr : *np_services.begin();
+        double probe_start = Simulation::getCurrentSimulatedDate();
+        int num_periods = warm_start ? 1 : this->probe_budget;
+        if (warm_start) {
+            WRENCH_INFO("Using the distances measured by a previous run");
+        } else {
+            WRENCH_INFO("Sleep for %d measurement periods so Network Proximity Service has time to ping and find proximity",
+                        this->probe_budget);
+        }
 
-                WRENCH_INFO("Proximity between Client and host %s is %e",
-                            storage_service->getHostname().c_str(), proximity);
+        // the selection at the end of each measurement period, until the probe budget is exhausted
+        nlohmann::json samples = nlohmann::json::array();
+        std::shared_ptr<StorageService> chosen_storage_service;
+        std::map<std::shared_ptr<StorageService>, double> distances;
+        double stable_since = probe_start;
+        for (int period = 1; period <= num_periods; period++) {
+            if (not warm_start) {
+                Simulation::sleep(std::max<double>(0.0, probe_start + period * this->probe_period -
+                                                        Simulation::getCurrentSimulatedDate()));
+            }
 
-                if (proximity < min_distance) {
-                    min_distance = proximity;
-                    chosen_storage_service = storage_service;
-                }
+            bool last = (period == num_periods);
+            if (last) {
+                WRENCH_INFO("Using Network Proximity Service to find closest storage unit...");
+            }
+            unsigned long num_known;
+            auto selection = this->selectStorageService(np_service, server_storage_services, distances, num_known,
+                                                        last);
+            if (selection != chosen_storage_service) {
+                stable_since = Simulation::getCurrentSimulatedDate();
+                chosen_storage_service = selection;
             }
+            unsigned long rank = this->getRank(selection);
+            samples.push_back({{"time",      Simulation::getCurrentSimulatedDate()},
+                               {"selection", selection->getHostname()},
+                               {"rank",      rank},
+                               {"correct",   rank == 1},
+                               {"known",     num_known}});
         }
 
+        unsigned long rank = this->getRank(chosen_storage_service);
+        double best_transfer_time = DBL_MAX;
+        for (auto const &t : this->transfer_times) {
+            best_transfer_time = std::min<double>(best_transfer_time, t.second);
+        }
+        nlohmann::json distances_by_host = nlohmann::json::object();
+        for (auto const &distance : distances) {
+            distances_by_host[distance.first->getHostname()] = distance.second;
+        }
+        this->proximity_report = {{"warm_start",       warm_start},
+                                  {"distances",        distances_by_host},
+                                  {"samples",          samples},
+                                  {"convergence_time", stable_since - probe_start},
+                                  {"selection",        chosen_storage_service->getHostname()},
+                                  {"rank",             rank},
+                                  {"correct",          rank == 1},
+                                  {"regret",           this->transfer_times.at(chosen_storage_service->getHostname()) /
+                                                       best_transfer_time - 1.0}};
+
         WRENCH_INFO("Nearest Storage Service: %s", chosen_storage_service->getHostname().c_str());
+        EventLog::record("server_selection", {{"server",           chosen_storage_service->getHostname()},
+                                              {"convergence_time", stable_since - probe_start},
+                                              {"rank",             rank}});
 
         WRENCH_INFO("----------------------------------------");
 
@@ -103,12 +472,35 @@ namespace wrench {
         //Copy from chosen server storage back to client
         WRENCH_INFO("Receiving the file stored in %s", chosen_storage_service->getHostname().c_str());
 
+        double download_start = Simulation::getCurrentSimulatedDate();
+        EventLog::record("file_copy_start", {{"file", input_file->getID()},
+                                             {"src",  chosen_storage_service->getHostname()},
+                                             {"dst",  client_storage_service->getHostname()}});
         data_manager->doSynchronousFileCopy(input_file,
                                             FileLocation::LOCATION(chosen_storage_service),
                                             FileLocation::LOCATION(client_storage_service),
                                             file_registry);
+        EventLog::record("file_copy_completion", {{"file", input_file->getID()}});
+        double download_time = Simulation::getCurrentSimulatedDate() - download_start;
 
         WRENCH_INFO("File received!");
+
+        if (this->num_download_sources > 1) {
+            nlohmann::json single_source = {{"server",    chosen_storage_service->getHostname()},
+                                            {"time",      download_time},
+                                            {"bandwidth", input_file->getSize() / download_time}};
+            nlohmann::json multi_source = this->multiSourceDownload(data_manager, server_storage_services, distances,
+                                                                    client_storage_service);
+            WRENCH_INFO("Chunks received from %lu servers at %.2f MBps (%.2f MBps from %s alone)",
+                        multi_source["sources"].size(), multi_source["bandwidth"].get<double>() / (1000.0 * 1000.0),
+                        single_source["bandwidth"].get<double>() / (1000.0 * 1000.0),
+                        chosen_storage_service->getHostname().c_str());
+            this->proximity_report["download"] = {{"single_source", single_source},
+                                                  {"multi_source",  multi_source},
+                                                  {"speedup",       download_time / multi_source["time"].get<double>()}};
+        }
+
+        EventLog::record("wms_end");
         return 0;
     }
 }
@@ -8,90 +8,225 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <random>
+#include <sstream>
 #include <string>
 #include <algorithm>
+#include <cstring>
 
 #include <simgrid/s4u.hpp>
 #include <wrench.h>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
+#include "BatchMode.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(main, "Log category for Simple WMS");
 
+/** @brief The disk bandwidth of the storage servers in MBps */
+const int SERVER_DISK_BANDWIDTH = 50;
+
+/**
+ * @brief A storage server, described by the link between it and the client
+ */
+struct Replica {
+    /** @brief The link bandwidth in MBps */
+    int bandwidth;
+    /** @brief The link latency in us */
+    int latency;
+};
+
+/**
+ * @brief Generates replicas with random client link bandwidths (below the server disk bandwidth, so
+ *        that the link of each server, which the proximity service measures, bounds its transfer
+ *        time) and latencies
+ * @param num_replicas: the number of replicas
+ * @param seed: the seed of the random number generator
+ * @return the replicas
+ */
+std::vector<Replica> generateReplicas(int num_replicas, long seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> bandwidth_distribution(5, SERVER_DISK_BANDWIDTH - 1);
+    std::uniform_int_distribution<> latency_distribution(10, 100);
+
+    std::vector<Replica> replicas;
+    for (int i = 0; i < num_replicas; i++) {
+        int bandwidth = bandwidth_distribution(gen);
+        replicas.push_back(Replica{bandwidth, latency_distribution(gen)});
+    }
+    return replicas;
+}
+
+/**
+ * @brief Reads replicas from a file with one "<bandwidth in MBps> <latency in us>" line per replica
+ *        (empty lines and lines starting with # are ignored)
+ * @param path: the file path
+ * @return the replicas
+ *
+ * @throws std::invalid_argument
+ */
+std::vector<Replica> readReplicaFile(const std::string &path) {
+    std::ifstream file(path);
+    if (not file) {
+        throw std::invalid_argument("cannot read replica file " + path);
+    }
+
+    std::vector<Replica> replicas;
+    std::string line;
+    while (std::getline(file, line)) {
+        if ((line.find_first_not_of(" \t\r") == std::string::npos) or (line[line.find_first_not_of(" \t")] == '#')) {
+            continue;
+        }
+        std::istringstream fields(line);
+        Replica replica;
+        if (not (fields >> replica.bandwidth >> replica.latency)) {
+            throw std::invalid_argument("invalid line in replica file " + path + ": " + line);
+        }
+        replicas.push_back(replica);
+    }
+    return replicas;
+}
+
+/**
+ * @brief Get the JSON description of replicas, which identifies the topology of a proximity file
+ * @param replicas: the replicas
+ * @return a JSON array of [bandwidth, latency] pairs
+ */
+nlohmann::json replicasToJSON(const std::vector<Replica> &replicas) {
+    nlohmann::json json = nlohmann::json::array();
+    for (auto const &replica : replicas) {
+        json.push_back({replica.bandwidth, replica.latency});
+    }
+    return json;
+}
+
+/**
+ * @brief Reads the distances between the client and the servers measured by a previous run (see
+ *        dumpProximityFile())
+ * @param path: the file path
+ * @param replicas: the replicas, which must be those of the previous run
+ * @param type: set to the network proximity service type of the previous run
+ * @return the distance between the client and each server
+ *
+ * @throws std::invalid_argument
+ */
+std::map<std::string, double> loadProximityFile(const std::string &path, const std::vector<Replica> &replicas,
+                                                std::string &type) {
+    std::ifstream file(path);
+    if (not file) {
+        throw std::invalid_argument("cannot read proximity file " + path);
+    }
+
+    std::map<std::string, double> distances;
+    try {
+        auto proximity = nlohmann::json::parse(file);
+        if (proximity.at("replicas") != replicasToJSON(replicas)) {
+            throw std::invalid_argument("the proximity file " + path + " was written for other replicas");
+        }
+        type = proximity.at("type").get<std::string>();
+        for (auto const &distance : proximity.at("distances").items()) {
+            distances[distance.key()] = distance.value().get<double>();
+        }
+    } catch (nlohmann::json::exception &e) {
+        throw std::invalid_argument("invalid proximity file " + path + ": " + e.what());
+    }
+    if (distances.empty()) {
+        throw std::invalid_argument("the proximity file " + path + " holds no distances");
+    }
+    return distances;
+}
+
+/**
+ * @brief Writes the distances between the client and the servers measured by the network proximity service,
+ *        so that later runs on the same replicas can start without measuring them
+ * @param path: the file path
+ * @param replicas: the replicas
+ * @param type: the network proximity service type
+ * @param distances: the distance between the client and each server (a JSON object)
+ */
+void dumpProximityFile(const std::string &path, const std::vector<Replica> &replicas, const std::string &type,
+                       const nlohmann::json &distances) {
+    std::ofstream file(path);
+    file << nlohmann::json({{"type",      type},
+                            {"replicas",  replicasToJSON(replicas)},
+                            {"distances", distances}}).dump() << std::endl;
+    if (not file) {
+        throw std::runtime_error("cannot write proximity file " + path);
+    }
+}
+
 /**
- * @brief Generates a platform with a single multi-core host
- * @param platform_file_path: path to write the platform file to
+ * @brief Generates a platform with a client, a services host and one storage server per replica.
+ *        The client reaches each server over the replica link, and the services host reaches the
+ *        client over its own link.
  *
- * @throws std::invalid_argumemnt
+ *        For servers given as arguments, every route is listed (Full routing), as it always was:
+ *        the services host and the servers reach the servers over a single shared link. For servers
+ *        given with --replicas or --replica-file, whose number makes that quadratic, the hosts are
+ *        connected by a star around a backbone router (Dijkstra routing): the client with an
+ *        unbounded link, each server with its replica link, and the services host with the shared
+ *        link. Traffic between two servers then crosses both replica links.
+ *
+ * @param replicas: the client-server links of the replicas
+ * @param full_routing: whether to list every route
+ * @return the platform description
  */
-void generatePlatform(std::string &platform_file_path,
-                      int server_link_bandwidth[],
-                      int server_link_latency[]) {
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
-
-    // Create the platform file
-    std::string xml_string = "<?xml version='1.0'?>\n"
-                             "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                             "<platform version=\"4.1\">\n"
-                             "   <zone id=\"AS0\" routing=\"Full\">\n"
-                             "       <host id=\"Services\" speed=\"100Gf\" core=\"16\">\n"
-                             "       </host>\n"
-                             "       <host id=\"Client\" speed=\"100f\" core=\"16\">\n"
-                             "           <disk id=\"hard_disk\" read_bw=\"100000TBps\" write_bw=\"100000TBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "       </host>\n";
-
-    for (int i = 1; i <= 3; ++i) {
-        xml_string += "       <host id=\"StorageService_" + std::to_string(i) + "\" speed=\"100Gf\" core=\"16\">\n";
-        xml_string += "           <disk id=\"large_disk\" read_bw=\"50MBps\" write_bw=\"50MBps\">\n"
-                      "                            <prop id=\"size\" value=\"5000GiB\"/>\n"
-                      "                            <prop id=\"mount\" value=\"/\"/>\n"
-                      "           </disk>\n"
-                      "       </host>\n";
-        xml_string += "       <link id=\"network_link_" + std::to_string(i) + "\" bandwidth=\"" +
-                      std::to_string(server_link_bandwidth[i - 1]) + "MBps\" latency=\"" +
-                      std::to_string(server_link_latency[i - 1]) + "us\"/>\n";
-    }
-
-    xml_string += "       <link id=\"servers_link\" bandwidth=\"100MBps\" latency=\"1us\"/>"
-                  "       <link id=\"client_link\" bandwidth=\"20MBps\" latency=\"20us\"/>\n";
-
-    for (int i = 1; i <= 3; i++) {
-        // client to server route
-        xml_string += "       <route src=\"Client\" dst=\"StorageService_" + std::to_string(i) + "\">";
-        xml_string += "           <link_ctn id=\"network_link_" + std::to_string(i) + "\"/>\n</route>\n";
-
-        // services to server route
-        xml_string += "       <route src=\"Services\" dst=\"StorageService_" + std::to_string(i) + "\">";
-        xml_string += "           <link_ctn id=\"servers_link\"/>\n</route>\n";
-
-        // server to server routes
-        for (int j = i + 1; j <= 3; ++j) {
-            xml_string += "       <route src=\"StorageService_" + std::to_string(i) + "\" dst=\"StorageService_" +
-                          std::to_string(j) + "\">";
-            xml_string += "           <link_ctn id=\"servers_link\"/>\n</route>\n";
-        }
-    }
-
-    xml_string += "       <route src=\"Services\" dst=\"Client\">"
-                  "           <link_ctn id=\"client_link\"/>"
-                  "       </route>\n"
-                  "   </zone>\n"
-                  "</platform>\n";
-
-    pugi::xml_document xml_doc;
-
-    if (xml_doc.load_string(xml_string.c_str(), pugi::parse_doctype)) {
-        xml_doc.save_file(platform_file_path.c_str());
+PlatformBuilder::Zone generatePlatform(const std::vector<Replica> &replicas, bool full_routing) {
+
+    PlatformBuilder::Zone platform("AS0", full_routing ? "Full" : "DijkstraCache");
+    platform.addHost("Services", "100Gf", 16);
+    platform.addHost("Client", "100f", 16).addDisk("hard_disk", "100000TBps", "100000TBps");
+    if (not full_routing) {
+        platform.addRouter("backbone");
+    }
+
+    std::string disk_bandwidth = std::to_string(SERVER_DISK_BANDWIDTH) + "MBps";
+    for (int i = 1; i <= (int) replicas.size(); ++i) {
+        platform.addHost("StorageService_" + std::to_string(i), "100Gf", 16)
+                .addDisk("large_disk", disk_bandwidth, disk_bandwidth);
+        platform.addLink("network_link_" + std::to_string(i),
+                         std::to_string(replicas[i - 1].bandwidth) + "MBps",
+                         std::to_string(replicas[i - 1].latency) + "us");
+    }
+
+    if (not full_routing) {
+        platform.addLink("backbone_link", "100000TBps", "0us");
+    }
+    platform.addLink("servers_link", "100MBps", "1us");
+    platform.addLink("client_link", "20MBps", "20us");
+
+    if (full_routing) {
+        for (int i = 1; i <= (int) replicas.size(); i++) {
+            // client to server route
+            platform.addRoute("Client", "StorageService_" + std::to_string(i), {"network_link_" + std::to_string(i)});
+
+            // services to server route
+            platform.addRoute("Services", "StorageService_" + std::to_string(i), {"servers_link"});
+
+            // server to server routes
+            for (int j = i + 1; j <= (int) replicas.size(); ++j) {
+                platform.addRoute("StorageService_" + std::to_string(i), "StorageService_" + std::to_string(j),
+                                  {"servers_link"});
+            }
+        }
     } else {
-        throw std::runtime_error("something went wrong with parsing xml string");
+        // each route counts one link, so that a shortest path between two hosts goes through the
+        // backbone router (client to server: backbone_link and network_link_<i>), except between
+        // the services host and the client
+        platform.addRoute("Client", "backbone", {"backbone_link"});
+        platform.addRoute("Services", "backbone", {"servers_link"});
+        for (int i = 1; i <= (int) replicas.size(); i++) {
+            platform.addRoute("StorageService_" + std::to_string(i), "backbone",
+                              {"network_link_" + std::to_string(i)});
+        }
     }
+
+    platform.addRoute("Services", "Client", {"client_link"});
+    return platform;
 }
 
 /**
@@ -101,12 +236,29 @@ void generatePlatform(std::string &platform_file_path,
  * @return
  */
 int main(int argc, char **argv) {
+    BatchMode::init(&argc, &argv, "storage_network_proximity");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "storage_network_proximity");
+    EventLog::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "storage_network_proximity");
+
+    const int MAX_REPLICAS = 1000;
 
     long FILE_SIZE; // 10 GB
-    int SERVER_LINK_BANDWIDTH[3];
-    int SERVER_LINK_LATENCY[3];
+    std::vector<Replica> REPLICAS;
+    std::string PROXIMITY_SERVICE_TYPE = "ALLTOALL";
+    double PROBE_PERIOD = 60;
+    std::string PROBE_COVERAGE = "1.0";
+    int PROBE_BUDGET = 30;
+    int DOWNLOAD_SOURCES = 1;
+    int DOWNLOAD_CHUNKS = 64;
+    std::string CHUNK_WEIGHTING = "bandwidth";
+    std::string PROXIMITY_DUMP_FILE;
+    std::map<std::string, double> WARM_START_DISTANCES;
+    // whether the servers were given as arguments (see generatePlatform())
+    bool FULL_ROUTING;
 
     std::vector<std::string> HOST_LIST;
 
@@ -115,46 +267,127 @@ int main(int argc, char **argv) {
     const std::string SERVICES("Services");
 
     try {
-        if (argc != 8) {
+        int num_replicas = 0;
+        long seed = std::random_device{}();
+        std::string replica_file;
+        std::string proximity_load_file;
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg.rfind("--replicas=", 0) == 0) {
+                num_replicas = std::stoi(arg.substr(strlen("--replicas=")));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                seed = std::stol(arg.substr(strlen("--seed=")));
+            } else if (arg.rfind("--replica-file=", 0) == 0) {
+                replica_file = arg.substr(strlen("--replica-file="));
+            } else if (arg == "--vivaldi") {
+                PROXIMITY_SERVICE_TYPE = "VIVALDI";
+            } else if (arg.rfind("--probe-period=", 0) == 0) {
+                PROBE_PERIOD = std::stod(arg.substr(strlen("--probe-period=")));
+            } else if (arg.rfind("--probe-coverage=", 0) == 0) {
+                PROBE_COVERAGE = arg.substr(strlen("--probe-coverage="));
+            } else if (arg.rfind("--probe-budget=", 0) == 0) {
+                PROBE_BUDGET = std::stoi(arg.substr(strlen("--probe-budget=")));
+            } else if (arg.rfind("--download-sources=", 0) == 0) {
+                DOWNLOAD_SOURCES = std::stoi(arg.substr(strlen("--download-sources=")));
+            } else if (arg.rfind("--download-chunks=", 0) == 0) {
+                DOWNLOAD_CHUNKS = std::stoi(arg.substr(strlen("--download-chunks=")));
+            } else if (arg.rfind("--chunk-weighting=", 0) == 0) {
+                CHUNK_WEIGHTING = arg.substr(strlen("--chunk-weighting="));
+            } else if (arg.rfind("--proximity-dump=", 0) == 0) {
+                PROXIMITY_DUMP_FILE = arg.substr(strlen("--proximity-dump="));
+            } else if (arg.rfind("--proximity-load=", 0) == 0) {
+                proximity_load_file = arg.substr(strlen("--proximity-load="));
+            } else {
+                arguments.push_back(arg);
+            }
+        }
+
+        if ((arguments.size() < 1) or (arguments.size() % 2 != 1)) {
             throw std::invalid_argument("Invalid number of arguments");
         }
-        FILE_SIZE = std::stol(std::string(argv[1]));
-        SERVER_LINK_BANDWIDTH[0] = std::stoi(std::string(argv[2]));
-        SERVER_LINK_LATENCY[0] = std::stoi(std::string(argv[3]));
-        SERVER_LINK_BANDWIDTH[1] = std::stoi(std::string(argv[4]));
-        SERVER_LINK_LATENCY[1] = std::stoi(std::string(argv[5]));
-        SERVER_LINK_BANDWIDTH[2] = std::stoi(std::string(argv[6]));
-        SERVER_LINK_LATENCY[2] = std::stoi(std::string(argv[7]));
+        FILE_SIZE = std::stol(arguments[0]);
+        for (unsigned long i = 1; i < arguments.size(); i += 2) {
+            REPLICAS.push_back(Replica{std::stoi(arguments[i]), std::stoi(arguments[i + 1])});
+        }
+        FULL_ROUTING = not REPLICAS.empty();
+        int num_replica_sources = (REPLICAS.empty() ? 0 : 1) + ((num_replicas > 0) ? 1 : 0) + (replica_file.empty() ? 0 : 1);
+        if (num_replica_sources != 1) {
+            throw std::invalid_argument("Replicas must be given either as arguments, with --replicas or with --replica-file");
+        }
+        if (num_replicas > 0) {
+            REPLICAS = generateReplicas(num_replicas, seed);
+        } else if (not replica_file.empty()) {
+            REPLICAS = readReplicaFile(replica_file);
+        }
+
+        if (REPLICAS.empty() or ((int) REPLICAS.size() > MAX_REPLICAS)) {
+            throw std::invalid_argument("Invalid number of replicas (must be in range [1," + std::to_string(MAX_REPLICAS) + "])");
+        }
+        for (auto const &replica : REPLICAS) {
+            if ((replica.bandwidth < 1) or (replica.latency < 0)) {
+                throw std::invalid_argument("Invalid replica link bandwidth or latency");
+            }
+        }
+        if ((PROBE_PERIOD <= 0) or (PROBE_BUDGET < 1) or
+            (std::stod(PROBE_COVERAGE) <= 0) or (std::stod(PROBE_COVERAGE) > 1)) {
+            throw std::invalid_argument("Invalid probe period, budget or coverage");
+        }
+        if ((DOWNLOAD_SOURCES < 1) or (DOWNLOAD_SOURCES > (int) REPLICAS.size()) or
+            (DOWNLOAD_CHUNKS < 1) or (DOWNLOAD_CHUNKS > FILE_SIZE) or
+            ((CHUNK_WEIGHTING != "bandwidth") and (CHUNK_WEIGHTING != "proximity"))) {
+            throw std::invalid_argument("Invalid download sources, chunks or chunk weighting");
+        }
+        if (not proximity_load_file.empty()) {
+            WARM_START_DISTANCES = loadProximityFile(proximity_load_file, REPLICAS, PROXIMITY_SERVICE_TYPE);
+        }
 
     } catch (std::invalid_argument &e) {
         std::cerr << e.what() << std::endl;
         std::cerr << "Usage: " << argv[0]
-                  << " <file_size> <server1_bandwidth> <server1_latency> <server2_bandwidth> <server2_latency>"
-                     " <server3_bandwidth> <server3_latency>"
+                  << " <file_size> [<server1_bandwidth> <server1_latency> <server2_bandwidth> <server2_latency> ...]"
+                     " [--replicas=<n> [--seed=<seed>] | --replica-file=<path>]"
+                     " [--vivaldi] [--probe-period=<seconds>] [--probe-coverage=<fraction>] [--probe-budget=<periods>]"
+                     " [--download-sources=<n> [--download-chunks=<n>] [--chunk-weighting=bandwidth|proximity]]"
+                     " [--proximity-dump=<path>] [--proximity-load=<path>]"
                   << std::endl;
+        std::cerr << "   server bandwidths in MBps, server latencies in us" << std::endl;
+        std::cerr << "   --replicas: generate n servers with random bandwidths in [5," << SERVER_DISK_BANDWIDTH - 1
+                  << "] MBps (below the server disk bandwidth) and latencies in [10,100] us" << std::endl;
+        std::cerr << "   --replica-file: read one \"<bandwidth> <latency>\" line per server" << std::endl;
+        std::cerr << "   --vivaldi: use Vivaldi coordinates instead of all-to-all measurements" << std::endl;
+        std::cerr << "   --probe-period: measurement period of the network proximity service (default: 60 s)" << std::endl;
+        std::cerr << "   --probe-coverage: fraction of the other hosts each host probes (default: 1.0)" << std::endl;
+        std::cerr << "   --probe-budget: measurement periods before the server selection (default: 30)" << std::endl;
+        std::cerr << "   --download-sources: also download the file in chunks from the n closest servers at once" << std::endl;
+        std::cerr << "   --download-chunks: number of chunks of the multi-source download (default: 64)" << std::endl;
+        std::cerr << "   --chunk-weighting: assign chunks in proportion to the measured bandwidth of the servers (default)"
+                     " or to their proximity" << std::endl;
+        std::cerr << "   --proximity-dump: write the measured client-server distances to a file" << std::endl;
+        std::cerr << "   --proximity-load: use the distances written by a previous run on the same servers,"
+                     " without measuring them" << std::endl;
         return 1;
     }
 
-    //setting up random number generator
-//    std::random_device rd;
-//    std::mt19937 gen(rd());
-//    std::uniform_int_distribution<> bandwidth_distribution(100, 1000);
-//    std::uniform_int_distribution<> latency_distribution(10, 100);
-//    int SERVER_LINK_BANDWIDTH[3] = {bandwidth_distribution(gen),
-//                                    bandwidth_distribution(gen),
-//                                    bandwidth_distribution(gen)};
-//    int SERVER_LINK_LATENCY[3] = {latency_distribution(gen),
-//                                  latency_distribution(gen),
-//                                  latency_distribution(gen)};
-
     // create workflow
     wrench::Workflow workflow;
     workflow.addFile("data.file", FILE_SIZE);
 
+    // the chunks of the multi-source download, which hold the content of the file
+    std::vector<wrench::WorkflowFile *> chunks;
+    if (DOWNLOAD_SOURCES > 1) {
+        for (int i = 0; i < DOWNLOAD_CHUNKS; i++) {
+            long chunk_size = FILE_SIZE / DOWNLOAD_CHUNKS + ((i < FILE_SIZE % DOWNLOAD_CHUNKS) ? 1 : 0);
+            chunks.push_back(workflow.addFile("data.file.chunk_" + std::to_string(i), chunk_size));
+        }
+    }
+
     // read and instantiate the platform with the desired HPC specifications
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, SERVER_LINK_BANDWIDTH, SERVER_LINK_LATENCY);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(REPLICAS, FULL_ROUTING));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     std::set<std::shared_ptr<wrench::StorageService>> storage_services;
 
@@ -164,39 +397,76 @@ int main(int argc, char **argv) {
             {{wrench::SimpleStorageServiceProperty::BUFFER_SIZE, "50000000"}}));
     storage_services.insert(client_storage_service);
 
-    for (int i = 1; i <= 3; ++i) {
+    // the (ground truth) time to transfer the file from each server to the client
+    std::map<std::string, double> TRANSFER_TIMES;
+
+    for (int i = 1; i <= (int) REPLICAS.size(); ++i) {
         auto server_storage_service = simulation.add(new wrench::SimpleStorageService(
                 "StorageService_" + std::to_string(i), {"/"},
                 {{wrench::SimpleStorageServiceProperty::BUFFER_SIZE, "50000000"}}));
         storage_services.insert(server_storage_service);
         HOST_LIST.push_back("StorageService_" + std::to_string(i));
+        TRANSFER_TIMES["StorageService_" + std::to_string(i)] =
+                REPLICAS[i - 1].latency / (1000.0 * 1000.0) +
+                FILE_SIZE / (std::min<double>(REPLICAS[i - 1].bandwidth, SERVER_DISK_BANDWIDTH) * 1000.0 * 1000.0);
     }
 
     //instantiate wms and file registry
     auto file_registry = new wrench::FileRegistryService(SERVICES, {}, {});
     auto file_registry_ptr = simulation.add(file_registry);
 
-//    std::cerr << "----------------------------------------" << std::endl;
-//    for (int i = 0; i < 3; ++i) {
-//        std::cerr << "StorageService_" << i + 1 << ":" << std::endl;
-//        std::cerr << "  Bandwidth: " << SERVER_LINK_BANDWIDTH[i] << " Mbps" << std::endl;
-//        std::cerr << "  Latency: " << SERVER_LINK_LATENCY[i] << " us" << std::endl;
-//    }
-//    std::cerr << "----------------------------------------" << std::endl;
-
-    HOST_LIST.push_back(CLIENT);
-    auto np_service = simulation.add(new wrench::NetworkProximityService(
-            SERVICES, HOST_LIST,
-            {{wrench::NetworkProximityServiceProperty::NETWORK_PROXIMITY_SERVICE_TYPE,
-                     "ALLTOALL"}}, {}));
+    // with warm start distances, there is no network proximity service (nor probe traffic)
+    std::set<std::shared_ptr<wrench::NetworkProximityService>> np_services;
+    if (WARM_START_DISTANCES.empty()) {
+        HOST_LIST.push_back(CLIENT);
+        np_services.insert(simulation.add(new wrench::NetworkProximityService(
+                SERVICES, HOST_LIST,
+                {{wrench::NetworkProximityServiceProperty::NETWORK_PROXIMITY_SERVICE_TYPE, PROXIMITY_SERVICE_TYPE},
+                 {wrench::NetworkProximityServiceProperty::NETWORK_PROXIMITY_MEASUREMENT_PERIOD, std::to_string(PROBE_PERIOD)},
+                 {wrench::NetworkProximityServiceProperty::NETWORK_DAEMON_COMMUNICATION_COVERAGE, PROBE_COVERAGE}}, {})));
+    }
     auto wms = simulation.add(
-            new wrench::ActivityWMS(file_registry_ptr, {np_service}, storage_services, CLIENT));
+            new wrench::ActivityWMS(file_registry_ptr, np_services, storage_services, CLIENT, TRANSFER_TIMES,
+                                    PROBE_PERIOD, PROBE_BUDGET));
+    if (not WARM_START_DISTANCES.empty()) {
+        wms->setWarmStartDistances(WARM_START_DISTANCES);
+    }
+    if (DOWNLOAD_SOURCES > 1) {
+        wms->setMultiSourceDownload(DOWNLOAD_SOURCES, chunks, CHUNK_WEIGHTING);
+    }
     wms->addWorkflow(&workflow);
 
     //stage file
     auto file = workflow.getFileByID("data.file");
     simulation.stageFile(file, client_storage_service);
+    for (auto const &storage_service : storage_services) {
+        if (storage_service != client_storage_service) {
+            for (auto const &chunk : chunks) {
+                simulation.stageFile(chunk, storage_service);
+            }
+        }
+    }
+    PhaseTimer::start("simulation");
     simulation.launch();
+    PhaseTimer::start("output");
+
+    auto proximity_report = wms->getProximityReport();
+    proximity_report["type"] = PROXIMITY_SERVICE_TYPE;
+    proximity_report["num_replicas"] = REPLICAS.size();
+    proximity_report["probe_period"] = PROBE_PERIOD;
+    proximity_report["probe_coverage"] = std::stod(PROBE_COVERAGE);
+    proximity_report["probe_budget"] = PROBE_BUDGET;
+    std::ofstream report_file(OutputDirectory::path("proximity_report.json"));
+    report_file << proximity_report.dump() << std::endl;
+
+    if (not PROXIMITY_DUMP_FILE.empty()) {
+        dumpProximityFile(PROXIMITY_DUMP_FILE, REPLICAS, PROXIMITY_SERVICE_TYPE, proximity_report["distances"]);
+    }
+
+    WRENCH_INFO("Selected %s (rank %lu among %lu servers by transfer time), converged after %.2f seconds",
+                proximity_report["selection"].get<std::string>().c_str(),
+                proximity_report["rank"].get<unsigned long>(), REPLICAS.size(),
+                proximity_report["convergence_time"].get<double>());
 
     // Gather the data transfer completion times
     auto file_copy_starts = simulation.getOutput().getTrace<wrench::SimulationTimestampFileCopyStart>();
@@ -0,0 +1,264 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/**
+ * Workflow profiler: reads a WfCommons (Pegasus JSON) workflow and reports, per level,
+ * the task count, total/max work, input/output volume and file fan-in/fan-out, as well
+ * as the critical-path length and the maximum width of the parallelism profile.
+ *
+ * The workflow is parsed directly (no WRENCH/SimGrid initialization) and every
+ * statistic is computed in a single pass over a topological order, so that workflows
+ * with hundreds of thousands of tasks can be profiled in a few seconds.
+ */
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define GFLOPS (1000.0*1000.0*1000.0)
+#define MB (1000.0*1000.0)
+
+struct Task {
+    std::string name;
+    double flops = 0.0;
+    double input_bytes = 0.0;
+    double output_bytes = 0.0;
+    unsigned long num_input_files = 0;
+    unsigned long num_output_files = 0;
+    std::vector<unsigned long> children;
+    unsigned long num_parents = 0;
+};
+
+struct Level {
+    unsigned long num_tasks = 0;
+    double total_flops = 0.0;
+    double max_flops = 0.0;
+    double input_bytes = 0.0;
+    double output_bytes = 0.0;
+    unsigned long fan_in = 0;
+    unsigned long fan_out = 0;
+};
+
+static void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--reference-gflops=<speed>] [--json] <json workflow file>" << std::endl;
+    std::cerr << "   reference-gflops: compute speed used to convert task runtimes into work (default: 43)" << std::endl;
+    std::cerr << "   json: print the profile as a JSON document instead of a table" << std::endl;
+}
+
+/**
+ * @brief Parse the task list of a WfCommons workflow
+ *
+ * @param workflow_file: the path to the JSON file
+ * @param reference_flops: the flop rate used to convert runtimes into work
+ * @return the tasks, with children given as indices into the returned vector
+ *
+ * @throws std::invalid_argument
+ */
+static std::vector<Task> parseWorkflow(const std::string &workflow_file, double reference_flops) {
+    std::ifstream input(workflow_file);
+    if (not input.good()) {
+        throw std::invalid_argument("cannot open workflow file " + workflow_file);
+    }
+
+    nlohmann::json j = nlohmann::json::parse(input);
+    auto const &jobs = j.at("workflow").contains("jobs") ? j.at("workflow").at("jobs") : j.at("workflow").at("tasks");
+
+    std::vector<Task> tasks(jobs.size());
+    std::unordered_map<std::string, unsigned long> task_index;
+    task_index.reserve(jobs.size());
+
+    for (unsigned long i = 0; i < jobs.size(); i++) {
+        auto const &job = jobs[i];
+        Task &task = tasks[i];
+        task.name = job.at("name").get<std::string>();
+        task.flops = job.value("runtime", 0.0) * reference_flops;
+        if (job.contains("files")) {
+            for (auto const &f : job.at("files")) {
+                double size = f.value("size", 0.0);
+                if (f.at("link").get<std::string>() == "input") {
+                    task.input_bytes += size;
+                    task.num_input_files++;
+                } else {
+                    task.output_bytes += size;
+                    task.num_output_files++;
+                }
+            }
+        }
+        task_index[task.name] = i;
+    }
+
+    // Dependencies are taken from the "parents" lists
+    for (unsigned long i = 0; i < jobs.size(); i++) {
+        if (not jobs[i].contains("parents")) {
+            continue;
+        }
+        for (auto const &parent : jobs[i].at("parents")) {
+            auto it = task_index.find(parent.get<std::string>());
+            if (it == task_index.end()) {
+                throw std::invalid_argument("task " + tasks[i].name + " has unknown parent " + parent.get<std::string>());
+            }
+            tasks[it->second].children.push_back(i);
+            tasks[i].num_parents++;
+        }
+    }
+
+    return tasks;
+}
+
+int main(int argc, char **argv) {
+
+    double reference_flops = 43 * GFLOPS;
+    bool json_output = false;
+    std::string workflow_file;
+
+    for (int i = 1; i < argc; i++) {
+        if (not strncmp(argv[i], "--reference-gflops=", strlen("--reference-gflops="))) {
+            reference_flops = std::stod(std::string(argv[i] + strlen("--reference-gflops="))) * GFLOPS;
+        } else if (not strcmp(argv[i], "--json")) {
+            json_output = true;
+        } else if (workflow_file.empty()) {
+            workflow_file = argv[i];
+        } else {
+            usage(argv[0]);
+            exit(1);
+        }
+    }
+    if (workflow_file.empty() or reference_flops <= 0) {
+        usage(argv[0]);
+        exit(1);
+    }
+
+    std::vector<Task> tasks;
+    try {
+        tasks = parseWorkflow(workflow_file, reference_flops);
+    } catch (std::exception &e) {
+        std::cerr << "Problem parsing workflow file: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    // Kahn traversal: a task is visited once all its parents have been, which gives its
+    // top level, its earliest start/finish dates, and the length of the longest path to it
+    unsigned long num_tasks = tasks.size();
+    std::vector<unsigned long> top_level(num_tasks, 0);
+    std::vector<double> earliest_start(num_tasks, 0.0);
+    std::vector<unsigned long> remaining_parents(num_tasks);
+    std::vector<unsigned long> order;
+    order.reserve(num_tasks);
+    for (unsigned long i = 0; i < num_tasks; i++) {
+        remaining_parents[i] = tasks[i].num_parents;
+        if (remaining_parents[i] == 0) {
+            order.push_back(i);
+        }
+    }
+
+    std::vector<Level> levels;
+    double critical_path = 0.0;
+    for (unsigned long k = 0; k < order.size(); k++) {
+        unsigned long i = order[k];
+        Task const &task = tasks[i];
+        double finish = earliest_start[i] + task.flops / reference_flops;
+        critical_path = std::max<double>(critical_path, finish);
+
+        if (top_level[i] >= levels.size()) {
+            levels.resize(top_level[i] + 1);
+        }
+        Level &level = levels[top_level[i]];
+        level.num_tasks++;
+        level.total_flops += task.flops;
+        level.max_flops = std::max<double>(level.max_flops, task.flops);
+        level.input_bytes += task.input_bytes;
+        level.output_bytes += task.output_bytes;
+        level.fan_in += task.num_input_files;
+        level.fan_out += task.num_output_files;
+
+        for (auto child : task.children) {
+            top_level[child] = std::max<unsigned long>(top_level[child], top_level[i] + 1);
+            earliest_start[child] = std::max<double>(earliest_start[child], finish);
+            if (--remaining_parents[child] == 0) {
+                order.push_back(child);
+            }
+        }
+    }
+
+    if (order.size() != num_tasks) {
+        std::cerr << "The workflow has a dependency cycle (" << num_tasks - order.size()
+                  << " tasks unreachable)" << std::endl;
+        exit(1);
+    }
+
+    // Parallelism profile of the as-soon-as-possible schedule (unbounded resources):
+    // its maximum width is the largest number of tasks running at the same date
+    std::vector<std::pair<double, int>> boundaries;
+    boundaries.reserve(2 * num_tasks);
+    for (unsigned long i = 0; i < num_tasks; i++) {
+        double duration = tasks[i].flops / reference_flops;
+        if (duration > 0) {
+            boundaries.emplace_back(earliest_start[i], +1);
+            boundaries.emplace_back(earliest_start[i] + duration, -1);
+        }
+    }
+    // at equal dates, process ends before starts
+    std::sort(boundaries.begin(), boundaries.end());
+    long width = 0, max_width = 0;
+    for (auto const &b : boundaries) {
+        width += b.second;
+        max_width = std::max<long>(max_width, width);
+    }
+    unsigned long max_level_width = 0;
+    for (auto const &level : levels) {
+        max_level_width = std::max<unsigned long>(max_level_width, level.num_tasks);
+    }
+
+    if (json_output) {
+        nlohmann::json output;
+        output["num_tasks"] = num_tasks;
+        output["num_levels"] = levels.size();
+        output["critical_path_seconds"] = critical_path;
+        output["max_level_width"] = max_level_width;
+        output["max_parallelism"] = max_width;
+        output["levels"] = nlohmann::json::array();
+        for (auto const &level : levels) {
+            output["levels"].push_back({
+                    {"num_tasks",    level.num_tasks},
+                    {"total_flops",  level.total_flops},
+                    {"max_flops",    level.max_flops},
+                    {"input_bytes",  level.input_bytes},
+                    {"output_bytes", level.output_bytes},
+                    {"fan_in",       level.fan_in},
+                    {"fan_out",      level.fan_out}
+            });
+        }
+        std::cout << output.dump() << std::endl;
+        return 0;
+    }
+
+    printf("%-6s %8s %14s %12s %12s %12s %8s %8s\n",
+           "level", "tasks", "work(GFlop)", "max(GFlop)", "in(MB)", "out(MB)", "fan-in", "fan-out");
+    for (unsigned long i = 0; i < levels.size(); i++) {
+        Level const &level = levels[i];
+        printf("%-6lu %8lu %14.2f %12.2f %12.2f %12.2f %8lu %8lu\n",
+               i, level.num_tasks, level.total_flops / GFLOPS, level.max_flops / GFLOPS,
+               level.input_bytes / MB, level.output_bytes / MB, level.fan_in, level.fan_out);
+    }
+    printf("\n");
+    printf("Tasks:                  %lu\n", num_tasks);
+    printf("Levels:                 %lu\n", levels.size());
+    printf("Critical path:          %.2f sec (at %.2f GFlop/sec)\n", critical_path, reference_flops / GFLOPS);
+    printf("Max level width:        %lu tasks\n", max_level_width);
+    printf("Max parallelism (ASAP): %ld tasks\n", max_width);
+
+    return 0;
+}
@@ -7,7 +7,10 @@
  * the Free Software Foundation, either version 3 of the License, or
  * (at your option) any later version.
  */
+#include <algorithm>
+
 #include "ThrustDJobScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_scheduler, "Log category for Simple Scheduler");
 
@@ -92,11 +95,67 @@ void ThrustDJobScheduler::createCoresTracker(std::set<std::shared_ptr<wrench::Co
     }
 }
 
+/**
+ * @brief Method to compute the upward rank (bottom level) of every task of a workflow, i.e., the length
+ *        of the longest path from the task to an exit task, counting task execution times and the
+ *        times to transfer the files between a task and its children
+ *
+ * @param workflow: the workflow
+ * @param reference_flops: the per-core compute speed used to estimate task execution times (flop/sec)
+ * @param reference_bandwidth: the bandwidth used to estimate file transfer times (byte/sec)
+ */
+void ThrustDJobScheduler::computeUpwardRanks(wrench::Workflow *workflow, double reference_flops, double reference_bandwidth) {
+    if ((reference_flops <= 0) or (reference_bandwidth <= 0)) {
+        throw std::invalid_argument("ThrustDJobScheduler::computeUpwardRanks(): reference speed and bandwidth must be positive");
+    }
+
+    // Children are always at a deeper top level than their parents, so going from the
+    // deepest level up, the ranks of all children are known when a task is visited
+    for (long level = (long) workflow->getNumLevels() - 1; level >= 0; level--) {
+        for (auto const &task : workflow->getTasksInTopLevelRange(level, level)) {
+            auto outputs = task->getOutputFiles();
+            std::set<wrench::WorkflowFile *> output_files(outputs.begin(), outputs.end());
+
+            double max_child_rank = 0.0;
+            for (auto const &child : workflow->getTaskChildren(task)) {
+                double transferred_bytes = 0.0;
+                for (auto const &f : child->getInputFiles()) {
+                    if (output_files.find(f) != output_files.end()) {
+                        transferred_bytes += f->getSize();
+                    }
+                }
+                max_child_rank = std::max<double>(max_child_rank,
+                                                  transferred_bytes / reference_bandwidth + this->upward_ranks[child]);
+            }
+
+            double execution_time = task->getFlops() / (reference_flops * (double) std::max<unsigned long>(1, task->getMinNumCores()));
+            this->upward_ranks[task] = execution_time + max_child_rank;
+        }
+    }
+}
+
+/**
+ * @brief Method to sort tasks by decreasing upward rank (tasks keep their relative order if
+ *        no ranks were computed, or if their ranks are equal)
+ *
+ * @param tasks: the tasks to sort
+ */
+void ThrustDJobScheduler::prioritizeTasks(std::vector<wrench::WorkflowTask *> &tasks) {
+    if (this->upward_ranks.empty()) {
+        return;
+    }
+    auto const &ranks = this->upward_ranks;
+    std::stable_sort(tasks.begin(), tasks.end(), [&ranks](wrench::WorkflowTask *a, wrench::WorkflowTask *b) {
+        return ranks.at(a) > ranks.at(b);
+    });
+}
+
 /**
  * @brief Schedule and run a set of ready tasks on available bare metal resources
  *
  * @param compute_services: a set of compute services available to run jobs
- * @param tasks: a map of (ready) workflow tasks
+ * @param tasks: a list of (ready) workflow tasks, in priority order; tasks that do not fit in
+ *        the available cores are skipped so that later (smaller) tasks can backfill leftover cores
  *
  * @throw std::runtime_error
  */
@@ -235,6 +294,8 @@ void ThrustDJobScheduler::scheduleTasks(const std::shared_ptr<wrench::ComputeSer
 
         getJobManager()->submitJob(
                 standard_job, selected_cs, service_specific_argument);
+        EventLog::record("job_submission", {{"tasks",           {task->getID()}},
+                                            {"compute_service", selected_cs->getHostname()}});
 
 //        if (isCloudTask(task->getID())) {
 //            // since bms are created in code, we need to tell the task which bms it ran on,
@@ -33,6 +33,8 @@ public:
   std::map<wrench::WorkflowTask *, std::shared_ptr<wrench::BareMetalComputeService>> tasks_run_on;
   std::shared_ptr<wrench::JobManager> getJobManager();
   void setJobManager(std::shared_ptr<wrench::JobManager> job_manager);
+  void computeUpwardRanks(wrench::Workflow *workflow, double reference_flops, double reference_bandwidth);
+  void prioritizeTasks(std::vector<wrench::WorkflowTask *> &tasks);
 private:
   std::shared_ptr<wrench::StorageService> default_storage_service;
   std::shared_ptr<wrench::StorageService> cloud_storage_service;
@@ -41,6 +43,7 @@ private:
   std::set<std::string> cloud_tasks_set;
   int num_vm_instances;
   std::shared_ptr<wrench::JobManager> job_manager;
+  std::map<wrench::WorkflowTask *, double> upward_ranks;
 };
 
 #endif //MY_SIMPLESCHEDULER_H
@@ -10,8 +10,16 @@
 #include <wrench.h>
 #include "ThrustDJobScheduler.h"
 #include "ThrustDWMS.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 #include <chrono>
 #include <ratio>
 
@@ -23,8 +31,283 @@ static bool ends_with(const std::string& str, const std::string& suffix) {
     return str.size() >= suffix.size() && 0 == str.compare(str.size()-suffix.size(), suffix.size(), suffix);
 }
 
+/**
+ * @brief A power state of a compute host
+ */
+struct PState {
+    double frequency;
+    std::string speed;
+    double idle_power;
+    double max_power;
+};
+
+/**
+ * @brief A group of identical compute hosts
+ */
+struct HostGroup {
+    int num_hosts;
+    int cores;
+    int pstate;
+    std::string speed;
+    std::string wattage;
+};
+
+/**
+ * @brief Load a pstate table from a CSV file with a "frequency,speed,idle_power,max_power" header
+ *        line and then one line per pstate (lines starting with '#' are ignored)
+ *
+ * @param pstate_table_file: the CSV file
+ * @return the pstates, in file order
+ *
+ * @throws std::invalid_argument
+ */
+static std::vector<PState> loadPStateTable(const std::string &pstate_table_file) {
+    std::ifstream csv(pstate_table_file);
+    if (not csv.good()) {
+        throw std::invalid_argument("cannot open pstate table " + pstate_table_file);
+    }
+
+    std::vector<PState> pstates;
+    std::string line;
+    bool header = true;
+    while (std::getline(csv, line)) {
+        if (line.empty() or line[0] == '#') {
+            continue;
+        }
+        if (header) {
+            header = false;
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 4) {
+            throw std::invalid_argument("invalid pstate table line '" + line + "' in " + pstate_table_file);
+        }
+        PState pstate;
+        pstate.frequency = std::stod(fields[0]);
+        pstate.speed = fields[1];
+        pstate.idle_power = std::stod(fields[2]);
+        pstate.max_power = std::stod(fields[3]);
+        pstates.push_back(pstate);
+    }
+    if (pstates.empty()) {
+        throw std::invalid_argument("pstate table " + pstate_table_file + " has no pstates");
+    }
+    return pstates;
+}
+
+/**
+ * @brief Convert a pstate table into the SimGrid host speed and "wattage_per_state" specifications
+ *
+ * @param pstates: the pstates
+ * @param speed: set to the comma-separated list of speeds
+ * @param wattage: set to the comma-separated list of idle:idle:max wattages
+ */
+static void pstateTableToSpecs(const std::vector<PState> &pstates, std::string &speed, std::string &wattage) {
+    speed = "";
+    wattage = "";
+    for (auto const &pstate : pstates) {
+        std::ostringstream power;
+        power << pstate.idle_power << ":" << pstate.idle_power << ":" << pstate.max_power;
+        speed += (speed.empty() ? "" : ", ") + pstate.speed;
+        wattage += (wattage.empty() ? "" : ", ") + power.str();
+    }
+}
+
+/**
+ * @brief Describe the platform: the WMS host, the storage host and the compute hosts (each
+ *        connected to the storage host by its own link) and, optionally, the cloud provider host
+ *        and the cloud hosts, connected to the rest of the platform by a wide-area link
+ *
+ * @param host_groups: the groups of compute hosts
+ * @param use_cloud: whether to add the cloud hosts
+ * @param num_cloud_hosts: the number of cloud hosts
+ * @param cloud_cores: the number of cores per cloud host
+ * @param cloud_speed: the speed specification of the cloud hosts
+ * @param cloud_pstate: the pstate of the cloud hosts
+ * @param cloud_wattage: the "wattage_per_state" specification of the cloud hosts
+ * @param cloud_bandwidth: the bandwidth of the wide-area link
+ * @return the platform description
+ */
+static PlatformBuilder::Zone generatePlatform(const std::vector<HostGroup> &host_groups, bool use_cloud,
+                                              int num_cloud_hosts, int cloud_cores, const std::string &cloud_speed,
+                                              int cloud_pstate, const std::string &cloud_wattage,
+                                              const std::string &cloud_bandwidth) {
+
+    PlatformBuilder::Zone platform("AS0");
+
+    platform.addHost("WMSHost", "1Gf", 1)
+            .setPState(0)
+            .setProperty("wattage_per_state", "0.0:0.0")
+            .setProperty("wattage_off", "0");
+
+    platform.addHost("storage_host", "1Gf", 1)
+            .setPState(0)
+            .setProperty("wattage_per_state", "10.00:100.00")
+            .setProperty("wattage_off", "0")
+            .addDisk("hard_drive", "100MBps", "100MBps", "500GB");
+
+    if (use_cloud) {
+        platform.addHost("cloud_provider_host", "1Gf", 1)
+                .setPState(0)
+                .setProperty("wattage_per_state", "10.00:100.00")
+                .setProperty("wattage_off", "0")
+                .addDisk("hard_drive", "100MBps", "100MBps", "500GB");
+        for (int i = 1; i < num_cloud_hosts + 1; i++) {
+            platform.addHost("cloud_host_" + std::to_string(i), cloud_speed, cloud_cores)
+                    .setPState(cloud_pstate)
+                    .setProperty("wattage_per_state", cloud_wattage)
+                    .setProperty("wattage_off", "0");
+        }
+    }
+
+    // compute hosts are numbered consecutively across host groups
+    int num_hosts = 0;
+    for (auto const &group : host_groups) {
+        for (int i = 0; i < group.num_hosts; i++) {
+            num_hosts++;
+            platform.addHost("compute_host_" + std::to_string(num_hosts), group.speed, group.cores)
+                    .setPState(group.pstate)
+                    .setProperty("wattage_per_state", group.wattage)
+                    .setProperty("wattage_off", "0");
+        }
+    }
+
+    // links between each compute host and storage host (1 to hosts)
+    for (int i = 1; i < num_hosts + 1; i++) {
+        platform.addLink(std::to_string(i), "5000GBps", "0us");
+    }
+
+    // link between WMS Host and Storage host
+    platform.addLink(std::to_string(num_hosts + 1), "5000GBps", "0us");
+
+    if (use_cloud) {
+        // links between each cloud compute host and cloud provider host
+        for (int i = num_hosts + 2; i < num_hosts + num_cloud_hosts + 2; i++) {
+            platform.addLink(std::to_string(i), "5000GBps", "0us");
+        }
+        platform.addLink("WIDE_AREA_LINK", cloud_bandwidth, "0ms");
+    }
+
+    // routes between each compute host and storage host
+    for (int i = 1; i < num_hosts + 1; i++) {
+        platform.addRoute("compute_host_" + std::to_string(i), "storage_host", {std::to_string(i)});
+    }
+    // route between WMS Host and Storage host
+    platform.addRoute("WMSHost", "storage_host", {std::to_string(num_hosts + 1)});
+
+    if (use_cloud) {
+        // routes between each cloud compute host and cloud provider host
+        for (int i = num_hosts + 2; i < num_hosts + num_cloud_hosts + 2; i++) {
+            platform.addRoute("cloud_host_" + std::to_string(i - num_hosts - 1), "cloud_provider_host",
+                              {std::to_string(i)});
+        }
+        // routes between each compute host and cloud provider host
+        for (int i = 1; i < num_hosts + 1; i++) {
+            platform.addRoute("compute_host_" + std::to_string(i), "cloud_provider_host",
+                              {std::to_string(i), "WIDE_AREA_LINK"});
+        }
+        // routes between each cloud compute host and storage host
+        for (int i = num_hosts + 2; i < num_hosts + num_cloud_hosts + 2; i++) {
+            platform.addRoute("cloud_host_" + std::to_string(i - num_hosts - 1), "storage_host",
+                              {std::to_string(i), "WIDE_AREA_LINK"});
+        }
+        // route between WMS Host and Cloud Provider host
+        platform.addRoute("WMSHost", "cloud_provider_host", {"WIDE_AREA_LINK"});
+        // route between Storage Host and Cloud Provider Host
+        platform.addRoute("storage_host", "cloud_provider_host", {"WIDE_AREA_LINK"});
+    }
+
+    return platform;
+}
+
+/**
+ * @brief Load a workflow from a DAX or JSON file
+ *
+ * @param workflow_file: the workflow file
+ * @param reference_speed: the reference compute speed for task work
+ * @param min_cores: the min number of cores per task
+ * @param max_cores: the max number of cores per task
+ * @return the workflow (nullptr if the file extension is not recognized)
+ */
+static wrench::Workflow *loadWorkflow(const std::string &workflow_file, const std::string &reference_speed,
+                                      int min_cores, int max_cores) {
+    if (ends_with(workflow_file, "dax")) {
+        return wrench::PegasusWorkflowParser::createWorkflowFromDAX(workflow_file, reference_speed, false,
+                                                                    min_cores, max_cores, true);
+    } else if (ends_with(workflow_file, "json")) {
+        return wrench::PegasusWorkflowParser::createWorkflowFromJSON(workflow_file, reference_speed, false,
+                                                                     min_cores, max_cores, true);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Copy the tasks, files and dependencies of a workflow into another workflow,
+ *        prefixing all task and file IDs so that several copies can coexist
+ *
+ * @param destination: the workflow to copy into
+ * @param source: the workflow to copy
+ * @param prefix: the ID prefix
+ * @param reference_flops: the reference compute speed, in flop/sec
+ * @param critical_path: set to the critical-path length of the workflow at the reference speed
+ * @return the copied tasks
+ */
+static std::vector<wrench::WorkflowTask *> mergeWorkflow(wrench::Workflow *destination, wrench::Workflow *source,
+                                                         const std::string &prefix, double reference_flops,
+                                                         double &critical_path) {
+    std::map<wrench::WorkflowTask *, wrench::WorkflowTask *> task_copies;
+    std::map<wrench::WorkflowFile *, wrench::WorkflowFile *> file_copies;
+
+    for (auto const &f : source->getFiles()) {
+        file_copies[f] = destination->addFile(prefix + f->getID(), f->getSize());
+    }
+
+    // Output files first, so that adding input files creates the data dependencies
+    std::vector<wrench::WorkflowTask *> tasks;
+    for (auto const &t : source->getTasks()) {
+        auto copy = destination->addTask(prefix + t->getID(), t->getFlops(), t->getMinNumCores(),
+                                         t->getMaxNumCores(), t->getMemoryRequirement());
+        for (auto const &f : t->getOutputFiles()) {
+            copy->addOutputFile(file_copies[f]);
+        }
+        task_copies[t] = copy;
+        tasks.push_back(copy);
+    }
+    for (auto const &t : source->getTasks()) {
+        for (auto const &f : t->getInputFiles()) {
+            task_copies[t]->addInputFile(file_copies[f]);
+        }
+        for (auto const &parent : source->getTaskParents(t)) {
+            destination->addControlDependency(task_copies[parent], task_copies[t]);
+        }
+    }
+
+    // Longest path, visiting tasks level by level so that parents come first
+    std::map<wrench::WorkflowTask *, double> finish_dates;
+    critical_path = 0.0;
+    for (unsigned long level = 0; level < source->getNumLevels(); level++) {
+        for (auto const &t : source->getTasksInTopLevelRange(level, level)) {
+            double start = 0.0;
+            for (auto const &parent : source->getTaskParents(t)) {
+                start = std::max<double>(start, finish_dates[parent]);
+            }
+            finish_dates[t] = start + t->getFlops() / reference_flops;
+            critical_path = std::max<double>(critical_path, finish_dates[t]);
+        }
+    }
+
+    return tasks;
+}
+
 int main(int argc, char **argv) {
 
+    BatchMode::init(&argc, &argv, "thrustd");
+
     // Declaration of the top-level WRENCH simulation object
     wrench::Simulation simulation;
 
@@ -38,6 +321,10 @@ int main(int argc, char **argv) {
 
     // Initialization of the simulation
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "thrustd");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "thrustd");
 
     // Parsing of the command-line arguments for this WRENCH simulation
     if (argc != 2) {
@@ -53,16 +340,56 @@ int main(int argc, char **argv) {
         std::cerr << "Problem parsing JSON input file: " + std::string(e.what()) + "\n";
     }
 
-    // number of compute nodes
-    int num_hosts = j.at("num_hosts").get<int>();
     // the number of cores per compute node
-    int cores = j.at("cores").get<int>();
+    int cores = j.value("cores", 0);
     // pstate spec
-    int pstate = j.at("pstate").get<int>();
+    int pstate = j.value("pstate", 0);
     // compute host speed
-    std::string speed = j.at("speed").get<std::string>();
+    std::string speed = j.value("speed", std::string(""));
     // pstate value
-    std::string pstate_value = j.at("value").get<std::string>();
+    std::string pstate_value = j.value("value", std::string(""));
+
+    // pstate table (optional): a CSV file that replaces the "speed" and "value" specs
+    std::string pstate_table_file = j.value("pstate_table", std::string(""));
+
+    // host groups (optional): groups of compute nodes, each with its own number of nodes and, optionally,
+    // its own "cores", "pstate", and "pstate_table" (by default, those given above for all compute nodes)
+    std::vector<HostGroup> host_groups;
+    int num_hosts = 0;
+    try {
+        if (not pstate_table_file.empty()) {
+            pstateTableToSpecs(loadPStateTable(pstate_table_file), speed, pstate_value);
+        }
+        if (j.contains("host_groups")) {
+            for (auto const &g : j.at("host_groups")) {
+                HostGroup group = {g.at("num_hosts").get<int>(), g.value("cores", cores), g.value("pstate", pstate),
+                                   speed, pstate_value};
+                if (g.contains("pstate_table")) {
+                    pstateTableToSpecs(loadPStateTable(g.at("pstate_table").get<std::string>()),
+                                       group.speed, group.wattage);
+                }
+                host_groups.push_back(group);
+            }
+        } else {
+            // number of compute nodes
+            host_groups.push_back({j.at("num_hosts").get<int>(), cores, pstate, speed, pstate_value});
+        }
+        for (auto const &group : host_groups) {
+            long num_pstates = std::count(group.speed.begin(), group.speed.end(), ',') + 1;
+            if ((group.num_hosts < 0) or (group.cores < 1) or group.speed.empty() or
+                (group.pstate < 0) or (group.pstate >= num_pstates)) {
+                throw std::invalid_argument("each host group needs a number of hosts, cores, a speed, and a valid pstate");
+            }
+            num_hosts += group.num_hosts;
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Invalid compute host specification: " << e.what() << std::endl;
+        exit(1);
+    } catch (nlohmann::json::exception &e) {
+        // a missing or mistyped "num_hosts", "cores", "pstate" or "pstate_table" entry
+        std::cerr << "Invalid compute host specification: " << e.what() << std::endl;
+        exit(1);
+    }
     // energy cost per MWh ($/MWh)
     double cost = j.at("energy_cost_per_mwh").get<double>();
     // energy CO2 per MWh (CO2/MWh)
@@ -85,132 +412,16 @@ int main(int argc, char **argv) {
     // cloud energy cost per MWh ($/MWh)
     double cloud_cost = j.at("cloud_cost_per_mwh").get<double>();
 
-    // platform description file, written in XML following the SimGrid-defined DTD
-    std::string xml = "<?xml version='1.0'?>\n"
-                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                      "<platform version=\"4.1\">\n"
-                      "   <zone id=\"AS0\" routing=\"Full\">\n\n"
-                      "       <host id=\"WMSHost\" speed=\"1Gf\" pstate=\"0\" core=\"1\">\n"
-                      "           <prop id=\"wattage_per_state\" value=\"0.0:0.0\"/>\n"
-                      "           <prop id=\"wattage_off\" value=\"0\"/>\n"
-                      "       </host>\n\n"
-                      "       <host id=\"storage_host\" speed=\"1Gf\" pstate=\"0\" core=\"1\">\n"
-                      "           <disk id=\"hard_drive\" read_bw=\"100MBps\" write_bw=\"100MBps\">\n"
-                      "               <prop id=\"size\" value=\"500GB\"/>\n"
-                      "               <prop id=\"mount\" value=\"/\"/>\n"
-                      "           </disk>\n"
-                      "           <prop id=\"wattage_per_state\" value=\"10.00:100.00\"/>\n"
-                      "           <prop id=\"wattage_off\" value=\"0\"/>\n"
-                      "       </host>\n\n";
-
-    if (use_cloud == true) {
-        xml.append("       <host id=\"cloud_provider_host\" speed=\"1Gf\" pstate=\"0\" core=\"1\">\n"
-                   "           <disk id=\"hard_drive\" read_bw=\"100MBps\" write_bw=\"100MBps\">\n"
-                   "               <prop id=\"size\" value=\"500GB\"/>\n"
-                   "               <prop id=\"mount\" value=\"/\"/>\n"
-                   "           </disk>\n"
-                   "           <prop id=\"wattage_per_state\" value=\"10.00:100.00\"/>\n"
-                   "           <prop id=\"wattage_off\" value=\"0\"/>\n"
-                   "       </host>\n\n");
-        for (int i = 1; i < num_cloud_hosts + 1; i++) {
-            xml.append("       <host id=\"cloud_host_" + std::to_string(i)
-                       + "\" speed=\"" + cloud_speed + "\" pstate=\"" + std::to_string(cloud_pstate) + "\" core=\""
-                       + std::to_string(cloud_cores) + "\">\n" +
-                       "           <prop id=\"wattage_per_state\" value=\"" + cloud_pstate_value + "\"/>\n" +
-                       "           <prop id=\"wattage_off\" value=\"0\"/>\n" +
-                       "       </host>\n");
-        }
-        xml.append("\n");
-    }
-
-    for (int i = 1; i < num_hosts + 1; i++) {
-        xml.append("       <host id=\"compute_host_" + std::to_string(i)
-                   + "\" speed=\"" + speed + "\" pstate=\"" + std::to_string(pstate) + "\" core=\""
-                   + std::to_string(cores) + "\">\n" +
-                   "           <prop id=\"wattage_per_state\" value=\"" + pstate_value + "\"/>\n" +
-                   "           <prop id=\"wattage_off\" value=\"0\"/>\n" +
-                   "       </host>\n");
-    }
-    xml.append("\n");
+    // time series sampling period in seconds (optional, 0 means no time series output)
+    double timeseries_period = j.value("timeseries_period", 0.0);
 
-    // links between each compute host and storage host (1 to hosts)
-    for (int i = 1; i < num_hosts + 1; i++) {
-        xml.append("       <link id=\"" + std::to_string(i)
-                   + "\" bandwidth=\"5000GBps\" latency=\"0us\"/>\n");
-    }
-
-    // link between WMS Host and Storage host
-    xml.append("       <link id=\"" + std::to_string(num_hosts + 1)
-               + "\" bandwidth=\"5000GBps\" latency=\"0us\"/>\n");
-
-    if (use_cloud == true) {
-        // links between each cloud compute host and cloud provider host
-        for (int i = num_hosts + 2; i < num_hosts + num_cloud_hosts + 2; i++) {
-            xml.append("       <link id=\"" + std::to_string(i)
-                       + "\" bandwidth=\"5000GBps\" latency=\"0us\"/>\n");
-        }
-        // WIDE_AREA_LINK
-        xml.append("       <link id=\"WIDE_AREA_LINK\" bandwidth=\"" + cloud_bandwidth + "\" latency=\"0ms\"/>\n");
-        // link between Storage Host and Cloud Provider Host
-//        xml.append("       <link id=\"" + std::to_string(num_hosts + num_cloud_hosts + 3)
-//                   + "\" bandwidth=\"" + cloud_bandwidth + "\" latency=\"0us\"/>\n");
-    }
+    PhaseTimer::start("platform_generation");
 
-    xml.append("\n");
+    std::string platform_file = PlatformBuilder::cache(
+            generatePlatform(host_groups, use_cloud, num_cloud_hosts, cloud_cores, cloud_speed, cloud_pstate,
+                             cloud_pstate_value, cloud_bandwidth));
 
-    // routes between each compute host and storage host (1 to hosts)
-    for (int i = 1; i < num_hosts + 1; i++) {
-        xml.append("       <route src=\"compute_host_" + std::to_string(i) +
-                   "\" dst=\"storage_host\"> <link_ctn id=\"" + std::to_string(i) + "\"/> </route>\n");
-    }
-    // routes between WMS Host and Storage host
-    xml.append("       <route src=\"WMSHost\" dst=\"storage_host\"> "
-               "<link_ctn id=\"" + std::to_string(num_hosts + 1) + "\"/> </route>\n");
-
-    if (use_cloud) {
-        // routes between each cloud compute host and cloud provider host
-        for (int i = num_hosts + 2; i < num_hosts + num_cloud_hosts + 2; i++) {
-            xml.append("       <route src=\"cloud_host_" + std::to_string(i - num_hosts - 1) +
-                       "\" dst=\"cloud_provider_host\"> <link_ctn id=\"" + std::to_string(i) + "\"/> </route>\n");
-        }
-        // routes between each compute host and cloud provider host
-        for (int i = 1; i < num_hosts + 1; i++) {
-            xml.append("       <route src=\"compute_host_" + std::to_string(i) +
-                       "\" dst=\"cloud_provider_host\"> <link_ctn id=\"" + std::to_string(i) + "\"/> <link_ctn id=\"WIDE_AREA_LINK\"/> </route>\n");
-        }
-        // routes between each cloud compute host and Storage Host host
-        for (int i = num_hosts + 2; i < num_hosts + num_cloud_hosts + 2; i++) {
-            xml.append("       <route src=\"cloud_host_" + std::to_string(i - num_hosts - 1) +
-                       "\" dst=\"storage_host\"> <link_ctn id=\"" + std::to_string(i) + "\"/> <link_ctn id=\"WIDE_AREA_LINK\"/> </route>\n");
-        }
-        // route between WMS Host and Cloud Provider host
-        xml.append("       <route src=\"WMSHost\" dst=\"cloud_provider_host\"> "
-                   "<link_ctn id=\"WIDE_AREA_LINK\"/> </route>\n");
-        // route between Storage Host and Cloud Provider Host
-        xml.append("       <route src=\"storage_host\" dst=\"cloud_provider_host\"> "
-                   "<link_ctn id=\"WIDE_AREA_LINK\"/> </route>\n");
-//                   "<link_ctn id=\"" + std::to_string(num_hosts + num_cloud_hosts + 3) + "\"/> </route>\n");
-    }
-
-    xml.append("\n");
-
-    xml.append(
-            "   </zone>\n"
-            "</platform>\n");
-
-    char const* username = std::getenv("USER");
-    std::string platform_file = "/tmp/hosts_" + std::to_string(getuid()) + ".xml";
-    auto xml_file = fopen(platform_file.c_str(), "w");
-    if (xml_file == NULL) {
-        std::cerr << "Cannot open platform (.xml) file" << std::endl;
-        exit(1);
-    }
-    fprintf(xml_file, "%s", xml.c_str());
-    fclose(xml_file);
-
-    // workflow description file, written in XML using the DAX DTD
-    std::string s = j.at("workflow_file").get<std::string>();
-    char *workflow_file = &s[0];
+    PhaseTimer::start("workflow_loading");
 
     // Reading and parsing the workflow description file to create a wrench::Workflow object
     WRENCH_INFO("Loading workflow...");
@@ -223,22 +434,45 @@ int main(int argc, char **argv) {
     int max_cores = j.at("max_cores_per_task").get<int>();
 
     std::string reference_speed = "43Gf";
-    if (ends_with(workflow_file, "dax")) {
-        workflow = wrench::PegasusWorkflowParser::createWorkflowFromDAX(workflow_file, reference_speed, false,
-                                                                        min_cores, max_cores, true);
-    } else if (ends_with(workflow_file, "json")) {
-        workflow = wrench::PegasusWorkflowParser::createWorkflowFromJSON(workflow_file, reference_speed, false,
-                                                                         min_cores, max_cores, true);
+    const double reference_flops = 43.0 * 1000 * 1000 * 1000;
+
+    // multi-tenant mode: a trace of workflow submissions, each with a workflow file and an arrival time
+    // (the IDs of the tasks of the i-th submission, e.g., in "cloud_tasks", are prefixed with "w<i>_")
+    std::vector<ThrustDSubmission> submissions;
+    if (j.contains("workflow_trace")) {
+        workflow = new wrench::Workflow();
+        for (auto const &entry : j.at("workflow_trace")) {
+            std::string workflow_file = entry.at("workflow_file").get<std::string>();
+            auto submitted_workflow = loadWorkflow(workflow_file, reference_speed, min_cores, max_cores);
+            if (submitted_workflow == nullptr) {
+                std::cerr << "Workflow file name must end with '.dax' or '.json'" << std::endl;
+                exit(1);
+            }
+            ThrustDSubmission submission;
+            submission.name = "w" + std::to_string(submissions.size());
+            submission.arrival_time = entry.at("arrival_time").get<double>();
+            submission.tasks = mergeWorkflow(workflow, submitted_workflow, submission.name + "_",
+                                             reference_flops, submission.critical_path);
+            submissions.push_back(submission);
+            delete submitted_workflow;
+        }
     } else {
-        std::cerr << "Workflow file name must end with '.dax' or '.json'" << std::endl;
-        exit(1);
+        // workflow description file, written in XML using the DAX DTD or in JSON
+        std::string workflow_file = j.at("workflow_file").get<std::string>();
+        workflow = loadWorkflow(workflow_file, reference_speed, min_cores, max_cores);
+        if (workflow == nullptr) {
+            std::cerr << "Workflow file name must end with '.dax' or '.json'" << std::endl;
+            exit(1);
+        }
     }
 
     WRENCH_INFO("The workflow has %ld tasks", workflow->getNumberOfTasks());
 
     // Reading and parsing the platform description file to instantiate a simulated platform
     WRENCH_INFO("Instantiating SimGrid platform...");
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file);
+    PhaseTimer::start("simulation_setup");
     WRENCH_INFO("SimGrid platform instantiated");
 
     // Get a vector of all the hosts in the simulated platform
@@ -311,13 +545,32 @@ int main(int argc, char **argv) {
 
 
 
+    // Instantiate a job scheduler, optionally prioritizing tasks by upward rank ("none" or "upward_rank")
+    auto job_scheduler = new ThrustDJobScheduler(storage_service, cloud_storage_service);
+    std::string task_priority = j.value("task_priority", std::string("none"));
+    if (task_priority == "upward_rank") {
+        // file transfers are estimated at the bandwidth of the storage host's disk
+        const double reference_bandwidth = 100.0 * 1000 * 1000;
+        job_scheduler->computeUpwardRanks(workflow, reference_flops, reference_bandwidth);
+    } else if (task_priority != "none") {
+        std::cerr << "Unknown task priority '" << task_priority << "' (must be 'none' or 'upward_rank')" << std::endl;
+        exit(1);
+    }
+
     // Instantiate a WMS
     auto wms = simulation.add(
-            new ThrustDWMS(std::unique_ptr<ThrustDJobScheduler>(
-                    new ThrustDJobScheduler(storage_service, cloud_storage_service)),
+            new ThrustDWMS(std::unique_ptr<ThrustDJobScheduler>(job_scheduler),
                            compute_services, storage_services, wms_host));
     wms->addWorkflow(workflow);
 
+    if (not submissions.empty()) {
+        // queueing discipline between workflows ("fcfs", "scpf", or "fair")
+        wms->setQueueDiscipline(j.value("queue_discipline", std::string("fcfs")));
+        for (auto const &submission : submissions) {
+            wms->addSubmission(submission);
+        }
+    }
+
 
     if (use_cloud) {
         // number of cloud vm instances
@@ -331,6 +584,26 @@ int main(int argc, char **argv) {
         wms->setCloudTasks("");
     }
 
+    if (timeseries_period > 0) {
+        // sample every powered host and every link of the generated platform
+        std::vector<std::string> sampled_hosts = {"WMSHost", "storage_host"};
+        std::vector<std::string> sampled_links;
+        for (int i = 1; i < num_hosts + 1; i++) {
+            sampled_hosts.push_back("compute_host_" + std::to_string(i));
+            sampled_links.push_back(std::to_string(i));
+        }
+        sampled_links.push_back(std::to_string(num_hosts + 1));
+        if (use_cloud) {
+            sampled_hosts.push_back("cloud_provider_host");
+            for (int i = 1; i < num_cloud_hosts + 1; i++) {
+                sampled_hosts.push_back("cloud_host_" + std::to_string(i));
+                sampled_links.push_back(std::to_string(num_hosts + 1 + i));
+            }
+            sampled_links.push_back("WIDE_AREA_LINK");
+        }
+        wms->setTimeSeriesSampling(timeseries_period, sampled_hosts, sampled_links);
+    }
+
     // Instantiate a file registry service
     std::string file_registry_service_host = hostname_list[(hostname_list.size() > 2) ? 1 : 0];
     WRENCH_INFO("Instantiating a FileRegistryService on %s", file_registry_service_host.c_str());
@@ -354,7 +627,9 @@ int main(int argc, char **argv) {
     WRENCH_INFO("Launching the Simulation...");
     auto start = std::chrono::high_resolution_clock::now();
     try {
+        PhaseTimer::start("simulation");
         simulation.launch();
+        PhaseTimer::start("output");
     } catch (std::runtime_error &e) {
         std::cerr << "Exception: " << e.what() << std::endl;
         return 0;
@@ -430,17 +705,66 @@ int main(int argc, char **argv) {
                     {"exec_time", exec_time_buf}
             };
 
+    if (j.contains("host_groups")) {
+        // per host group energy consumption
+        output_json["host_groups"] = nlohmann::json::array();
+        int first_host = 1;
+        for (auto const &group : host_groups) {
+            double group_energy = 0.0;
+            for (int i = first_host; i < first_host + group.num_hosts; i++) {
+                group_energy += simulation.getEnergyConsumed("compute_host_" + std::to_string(i));
+            }
+            output_json["host_groups"].push_back({
+                    {"num_hosts", group.num_hosts},
+                    {"cores", group.cores},
+                    {"pstate", group.pstate},
+                    {"energy_consumption", group_energy}
+            });
+            first_host += group.num_hosts;
+        }
+    }
+
+    if (not submissions.empty()) {
+        // per-workflow turnaround, and slowdown relative to the critical path at the reference speed
+        output_json["workflows"] = nlohmann::json::array();
+        for (auto const &submission : wms->getSubmissions()) {
+            double finish_time = 0.0;
+            for (auto const &t : submission.tasks) {
+                finish_time = std::max<double>(finish_time, t->getEndDate());
+            }
+            double turnaround = finish_time - submission.arrival_time;
+            double slowdown = (submission.critical_path > 0) ? turnaround / submission.critical_path : 1.0;
+            std::cerr << "Workflow " << submission.name << ": arrival " << submission.arrival_time
+                      << " sec, turnaround " << turnaround << " sec, slowdown " << slowdown << std::endl;
+            output_json["workflows"].push_back({
+                    {"name", submission.name},
+                    {"arrival_time", submission.arrival_time},
+                    {"finish_time", finish_time},
+                    {"turnaround", turnaround},
+                    {"slowdown", slowdown}
+            });
+        }
+    }
+
     std::cout << output_json.dump() << std::endl;
 
     // simulation.getOutput().enableDiskTimestamps(true);
-    simulation.getOutput().dumpUnifiedJSON(workflow, "/tmp/workflow_data.json",
-                                           false,
-                                           true,
-                                           false,
-                                           false,
-                                           false,
-                                           false,
-                                           true);
+    if (ColumnarOutput::isEnabled()) {
+        ColumnarOutput::dump(simulation, workflow, OutputDirectory::path("workflow_data.ewc"));
+    } else {
+        simulation.getOutput().dumpUnifiedJSON(workflow, OutputDirectory::path("workflow_data.json"),
+                                               false,
+                                               true,
+                                               false,
+                                               false,
+                                               false,
+                                               false,
+                                               true);
+    }
+
+    if (timeseries_period > 0) {
+        wms->getTimeSeries().writeCSV(OutputDirectory::path("workflow_timeseries.csv"));
+    }
 
     return 0;
 }
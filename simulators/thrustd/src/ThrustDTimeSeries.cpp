@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#include <cstdio>
+#include <stdexcept>
+
+#include "ThrustDTimeSeries.h"
+
+/**
+ * @brief Method to declare a new series (all columns must be declared before the first row is added)
+ *
+ * @param name: the series name, used as the column header
+ * @return the column index
+ */
+unsigned long ThrustDTimeSeries::addColumn(const std::string &name) {
+    if (not this->dates.empty()) {
+        throw std::runtime_error("ThrustDTimeSeries::addColumn(): cannot add a column after rows have been added");
+    }
+    this->column_names.push_back(name);
+    this->columns.emplace_back();
+    return this->columns.size() - 1;
+}
+
+/**
+ * @brief Method to start a new row, in which all values default to zero
+ *
+ * @param date: the simulated date of the sample
+ */
+void ThrustDTimeSeries::addRow(double date) {
+    this->dates.push_back(date);
+    for (auto &column : this->columns) {
+        column.push_back(0.0);
+    }
+}
+
+/**
+ * @brief Method to set a value in the last row
+ *
+ * @param column: the column index
+ * @param value: the value
+ */
+void ThrustDTimeSeries::set(unsigned long column, double value) {
+    this->columns.at(column).back() = value;
+}
+
+/**
+ * @brief Method to get the number of rows
+ * @return a number of rows
+ */
+unsigned long ThrustDTimeSeries::getNumRows() {
+    return this->dates.size();
+}
+
+/**
+ * @brief Method to write the series to a CSV file (header line, then one line per sample)
+ *
+ * @param path: the file path
+ *
+ * @throw std::runtime_error
+ */
+void ThrustDTimeSeries::writeCSV(const std::string &path) {
+    auto csv_file = fopen(path.c_str(), "w");
+    if (csv_file == nullptr) {
+        throw std::runtime_error("Cannot open time series file " + path);
+    }
+
+    fprintf(csv_file, "time");
+    for (auto const &name : this->column_names) {
+        fprintf(csv_file, ",%s", name.c_str());
+    }
+    fprintf(csv_file, "\n");
+
+    for (unsigned long row = 0; row < this->dates.size(); row++) {
+        fprintf(csv_file, "%.3f", this->dates[row]);
+        for (auto const &column : this->columns) {
+            fprintf(csv_file, ",%.6g", column[row]);
+        }
+        fprintf(csv_file, "\n");
+    }
+    fclose(csv_file);
+}
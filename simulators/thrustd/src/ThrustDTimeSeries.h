@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) 2020. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef THRUSTD_TIME_SERIES_H
+#define THRUSTD_TIME_SERIES_H
+
+#include <string>
+#include <vector>
+
+/**
+ *  @brief A column-oriented store of periodically sampled values (one column per series)
+ */
+class ThrustDTimeSeries {
+public:
+    unsigned long addColumn(const std::string &name);
+    void addRow(double date);
+    void set(unsigned long column, double value);
+    unsigned long getNumRows();
+    void writeCSV(const std::string &path);
+private:
+    std::vector<double> dates;
+    std::vector<std::string> column_names;
+    std::vector<std::vector<double>> columns;
+};
+
+#endif //THRUSTD_TIME_SERIES_H
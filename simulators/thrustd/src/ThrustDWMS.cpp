@@ -7,13 +7,19 @@
  * the Free Software Foundation, either version 3 of the License, or
  * (at your option) any later version.
  */
+#include <algorithm>
+#include <cfloat>
 #include <iostream>
 
 #include "ThrustDWMS.h"
 #include "ThrustDJobScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms, "Log category for Simple WMS");
 
+// Tolerance when comparing simulated dates
+#define EPSILON 0.000001
+
 /**
  * @brief Create a Simple WMS with a workflow instance, a scheduler implementation, and a list of compute services
  */
@@ -47,6 +53,7 @@ int ThrustDWMS::main() {
     checkDeferredStart();
 
     WRENCH_INFO("About to execute a workflow with %lu tasks", this->getWorkflow()->getNumberOfTasks());
+    EventLog::record("wms_start", {{"num_tasks", this->getWorkflow()->getNumberOfTasks()}});
 
     // Create a job manager
     this->job_manager = this->createJobManager();
@@ -109,16 +116,45 @@ int ThrustDWMS::main() {
     // Set the num cores available for each compute service
     this->ss_job_scheduler->createCoresTracker(all_bms);
 
+    double next_sample_date = wrench::Simulation::getCurrentSimulatedDate() + this->time_series_period;
+
     while (true) {
-        // Get the ready tasks
-        std::vector<wrench::WorkflowTask *> ready_tasks = this->getWorkflow()->getReadyTasks();
+        // Get the ready tasks (in multi-tenant mode, those of the workflows that have arrived, in queueing order)
+        std::vector<wrench::WorkflowTask *> ready_tasks = this->getQueuedReadyTasks();
 
         this->ss_job_scheduler->scheduleTasks(compute_service, vm_css, ready_tasks);
 
+        for (auto const &task : ready_tasks) {
+            auto submission = this->task_submission.find(task);
+            if ((submission != this->task_submission.end()) and
+                (this->ss_job_scheduler->tasks_run_on.find(task) != this->ss_job_scheduler->tasks_run_on.end())) {
+                this->submissions.at(submission->second).running_cores += (long) task->getMinNumCores();
+            }
+        }
+
+        // The next date at which to wake up even if no execution event arrives before then
+        double wakeup_date = this->getNextArrivalDate();
+        if (this->time_series_period > 0) {
+            wakeup_date = std::min<double>(wakeup_date, next_sample_date);
+        }
+
         // Wait for a workflow execution event, and process it
         try {
             WRENCH_INFO("Waiting for some execution event (job completion or failure)");
-            this->waitForAndProcessNextEvent();
+            if (wakeup_date < DBL_MAX) {
+                double timeout = std::max<double>(0.0, wakeup_date - wrench::Simulation::getCurrentSimulatedDate());
+                if (not this->waitForAndProcessNextEvent(timeout)) {
+                    if ((this->time_series_period > 0) and
+                        (wrench::Simulation::getCurrentSimulatedDate() + EPSILON >= next_sample_date)) {
+                        // Tasks that were just submitted are no longer ready, so what remains is the ready queue
+                        this->recordTimeSeriesSample(this->getQueuedReadyTasks().size());
+                        next_sample_date += this->time_series_period;
+                    }
+                    continue;
+                }
+            } else {
+                this->waitForAndProcessNextEvent();
+            }
 //            WRENCH_INFO("Got the execution event");
         } catch (wrench::WorkflowExecutionException &e) {
             WRENCH_INFO("Error while getting next execution event (%s)... ignoring and trying again",
@@ -131,6 +167,13 @@ int ThrustDWMS::main() {
         }
     }
 
+    // Close the time series with a sample at the workflow completion date
+    if (this->time_series_period > 0) {
+        this->recordTimeSeriesSample(0);
+    }
+
+    EventLog::record("wms_end", {{"completed", this->getWorkflow()->isDone()}});
+
     this->job_manager.reset();
 
     return 0;
@@ -146,6 +189,8 @@ void ThrustDWMS::processEventStandardJobFailure(std::shared_ptr<wrench::Standard
     auto job = event->standard_job;
     WRENCH_INFO("Notified that a standard job has failed (failure cause: %s)",
                 event->failure_cause->toString().c_str());
+    EventLog::record("job_failure", {{"tasks", EventLog::taskIDs(job->getTasks())},
+                                     {"cause", event->failure_cause->toString()}});
     /* Retrieve the job's tasks */
     WRENCH_INFO("As a result, the following tasks have failed:");
     for (auto const &task : job->getTasks()) {
@@ -165,12 +210,17 @@ void ThrustDWMS::processEventStandardJobCompletion(std::shared_ptr<wrench::Stand
     /* Retrieve the job that this event is for */
     auto job = event->standard_job;
     WRENCH_INFO("Notified that a standard job has successfully completed");
+    EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(job->getTasks())}});
     /* Retrieve the job's tasks */
     WRENCH_INFO("As a result, the following tasks have completed:");
     for (auto const &task : job->getTasks()) {
         WRENCH_INFO(" - %s", task->getID().c_str());
         auto cs = this->ss_job_scheduler->tasks_run_on.find(task)->second;
         this->ss_job_scheduler->updateNumCoresAvailable(cs, task->getMinNumCores());
+        auto submission = this->task_submission.find(task);
+        if (submission != this->task_submission.end()) {
+            this->submissions.at(submission->second).running_cores -= (long) task->getMinNumCores();
+        }
     }
 }
 
@@ -213,3 +263,192 @@ void ThrustDWMS::convertCloudTasks(std::string tasks) {
 void ThrustDWMS::setCloudTasks(std::string tasks) {
     cloud_tasks = tasks;
 }
+
+/**
+ * @brief Method to enable periodic sampling of host power, link utilization, and ready-queue length
+ *
+ * @param period: the sampling period in seconds (0 disables sampling)
+ * @param hostnames: the hosts whose power consumption is sampled
+ * @param linknames: the links whose utilization is sampled
+ */
+void ThrustDWMS::setTimeSeriesSampling(double period,
+                                       const std::vector<std::string> &hostnames,
+                                       const std::vector<std::string> &linknames) {
+    if (period < 0) {
+        throw std::invalid_argument("ThrustDWMS::setTimeSeriesSampling(): period must be non-negative");
+    }
+    this->time_series_period = period;
+    this->sampled_hosts = hostnames;
+    this->sampled_links = linknames;
+    this->last_energy_consumed.assign(hostnames.size(), 0.0);
+
+    // Column layout: one power column per host, one utilization column per link, then the ready-queue length
+    for (auto const &hostname : hostnames) {
+        this->time_series.addColumn("power:" + hostname);
+    }
+    for (auto const &linkname : linknames) {
+        this->time_series.addColumn("link:" + linkname);
+    }
+    this->time_series.addColumn("ready_tasks");
+}
+
+/**
+ * @brief Method to get the sampled time series
+ * @return the time series
+ */
+ThrustDTimeSeries &ThrustDWMS::getTimeSeries() {
+    return this->time_series;
+}
+
+/**
+ * @brief Method to record one time series sample at the current simulated date
+ *
+ * @param num_ready_tasks: the number of ready tasks that are waiting for cores
+ */
+void ThrustDWMS::recordTimeSeriesSample(unsigned long num_ready_tasks) {
+    double now = wrench::Simulation::getCurrentSimulatedDate();
+    double elapsed = now - this->last_sample_date;
+
+    this->time_series.addRow(now);
+    unsigned long column = 0;
+
+    // Average power over the last period, derived from the energy meters of the hosts
+    for (unsigned long i = 0; i < this->sampled_hosts.size(); i++) {
+        double energy = this->simulation->getEnergyConsumed(this->sampled_hosts.at(i));
+        if (elapsed > 0) {
+            this->time_series.set(column, (energy - this->last_energy_consumed.at(i)) / elapsed);
+        }
+        this->last_energy_consumed.at(i) = energy;
+        column++;
+    }
+
+    // Instantaneous link utilization, as a fraction of the link bandwidth
+    for (auto const &linkname : this->sampled_links) {
+        double bandwidth = wrench::S4U_Simulation::getLinkBandwidth(linkname);
+        double usage = this->simulation->getLinkUsage(linkname, false);
+        this->time_series.set(column, (bandwidth > 0) ? usage / bandwidth : 0.0);
+        column++;
+    }
+
+    this->time_series.set(column, (double) num_ready_tasks);
+    this->last_sample_date = now;
+}
+
+/**
+ * @brief Method to add a workflow submission (multi-tenant mode), whose tasks must all belong
+ *        to the workflow executed by this WMS
+ *
+ * @param submission: the submission
+ */
+void ThrustDWMS::addSubmission(const ThrustDSubmission &submission) {
+    for (auto const &task : submission.tasks) {
+        this->task_submission[task] = this->submissions.size();
+    }
+    this->submissions.push_back(submission);
+    this->submissions.back().running_cores = 0;
+}
+
+/**
+ * @brief Method to set the order in which the ready tasks of different workflow submissions are scheduled
+ *
+ * @param discipline: "fcfs" (earliest arrival first), "scpf" (shortest critical path first),
+ *                    or "fair" (round-robin across workflows, those using the fewest cores first)
+ */
+void ThrustDWMS::setQueueDiscipline(const std::string &discipline) {
+    if ((discipline != "fcfs") and (discipline != "scpf") and (discipline != "fair")) {
+        throw std::invalid_argument("ThrustDWMS::setQueueDiscipline(): unknown queue discipline " + discipline);
+    }
+    this->queue_discipline = discipline;
+}
+
+/**
+ * @brief Method to get the workflow submissions
+ * @return the submissions
+ */
+const std::vector<ThrustDSubmission> &ThrustDWMS::getSubmissions() {
+    return this->submissions;
+}
+
+/**
+ * @brief Method to get the date of the next workflow arrival
+ * @return a date (DBL_MAX if no more workflow is to arrive)
+ */
+double ThrustDWMS::getNextArrivalDate() {
+    double now = wrench::Simulation::getCurrentSimulatedDate();
+    double next_arrival = DBL_MAX;
+    for (auto const &submission : this->submissions) {
+        if (submission.arrival_time > now + EPSILON) {
+            next_arrival = std::min<double>(next_arrival, submission.arrival_time);
+        }
+    }
+    return next_arrival;
+}
+
+/**
+ * @brief Method to get the ready tasks in the order in which they should be scheduled. In
+ *        multi-tenant mode, tasks of workflows that have not arrived yet are left out.
+ *
+ * @return a list of ready tasks
+ */
+std::vector<wrench::WorkflowTask *> ThrustDWMS::getQueuedReadyTasks() {
+    auto ready_tasks = this->getWorkflow()->getReadyTasks();
+    if (this->submissions.empty()) {
+        this->ss_job_scheduler->prioritizeTasks(ready_tasks);
+        return ready_tasks;
+    }
+
+    // Group the ready tasks of the workflows that have arrived
+    double now = wrench::Simulation::getCurrentSimulatedDate();
+    std::vector<std::vector<wrench::WorkflowTask *>> queues(this->submissions.size());
+    for (auto const &task : ready_tasks) {
+        unsigned long index = this->task_submission.at(task);
+        if (this->submissions.at(index).arrival_time <= now + EPSILON) {
+            queues.at(index).push_back(task);
+        }
+    }
+
+    // Order the workflows according to the queueing discipline, and the tasks of each workflow by priority
+    std::vector<unsigned long> order;
+    for (unsigned long i = 0; i < queues.size(); i++) {
+        if (not queues.at(i).empty()) {
+            this->ss_job_scheduler->prioritizeTasks(queues.at(i));
+            order.push_back(i);
+        }
+    }
+    auto const &subs = this->submissions;
+    if (this->queue_discipline == "scpf") {
+        std::stable_sort(order.begin(), order.end(), [&subs](unsigned long a, unsigned long b) {
+            return subs.at(a).critical_path < subs.at(b).critical_path;
+        });
+    } else if (this->queue_discipline == "fair") {
+        std::stable_sort(order.begin(), order.end(), [&subs](unsigned long a, unsigned long b) {
+            return subs.at(a).running_cores < subs.at(b).running_cores;
+        });
+    } else {
+        std::stable_sort(order.begin(), order.end(), [&subs](unsigned long a, unsigned long b) {
+            return subs.at(a).arrival_time < subs.at(b).arrival_time;
+        });
+    }
+
+    std::vector<wrench::WorkflowTask *> queued_tasks;
+    if (this->queue_discipline == "fair") {
+        // Interleave the workflows so that each one gets a turn before any gets a second one
+        for (unsigned long position = 0; queued_tasks.size() < ready_tasks.size(); position++) {
+            bool added = false;
+            for (auto const &index : order) {
+                if (position < queues.at(index).size()) {
+                    queued_tasks.push_back(queues.at(index).at(position));
+                    added = true;
+                }
+            }
+            if (not added) {
+                break;
+            }
+        }
+    } else {
+        for (auto const &index : order) {
+            queued_tasks.insert(queued_tasks.end(), queues.at(index).begin(), queues.at(index).end());
+        }
+    }
+    return queued_tasks;
+}
@@ -12,9 +12,26 @@
 
 #include <wrench-dev.h>
 #include "ThrustDJobScheduler.h"
+#include "ThrustDTimeSeries.h"
 
 class Simulation;
 
+/**
+ *  @brief A workflow submitted to the WMS in multi-tenant mode
+ */
+struct ThrustDSubmission {
+    /** @brief The submission name (also the prefix of its task IDs) */
+    std::string name;
+    /** @brief The date at which the workflow arrives */
+    double arrival_time;
+    /** @brief The critical-path length of the workflow at the reference speed */
+    double critical_path;
+    /** @brief The tasks of the workflow */
+    std::vector<wrench::WorkflowTask *> tasks;
+    /** @brief The number of cores currently used by the workflow's tasks */
+    long running_cores;
+};
+
 /**
  *  @brief A simple WMS implementation
  */
@@ -30,11 +47,30 @@ public:
     void setNumVmInstances(int num_vm_instances);
     void convertCloudTasks(std::string tasks);
     void setCloudTasks(std::string tasks);
+    void setTimeSeriesSampling(double period,
+                               const std::vector<std::string> &hostnames,
+                               const std::vector<std::string> &linknames);
+    ThrustDTimeSeries &getTimeSeries();
+    void addSubmission(const ThrustDSubmission &submission);
+    void setQueueDiscipline(const std::string &discipline);
+    const std::vector<ThrustDSubmission> &getSubmissions();
 private:
     std::unique_ptr<ThrustDJobScheduler> ss_job_scheduler;
     int num_vm_instances;
     std::set<std::string> cloud_tasks_set;
     std::string cloud_tasks;
+    double time_series_period = 0.0;
+    double last_sample_date = 0.0;
+    std::vector<std::string> sampled_hosts;
+    std::vector<std::string> sampled_links;
+    std::vector<double> last_energy_consumed;
+    ThrustDTimeSeries time_series;
+    void recordTimeSeriesSample(unsigned long num_ready_tasks);
+    std::vector<ThrustDSubmission> submissions;
+    std::map<wrench::WorkflowTask *, unsigned long> task_submission;
+    std::string queue_discipline = "fcfs";
+    std::vector<wrench::WorkflowTask *> getQueuedReadyTasks();
+    double getNextArrivalDate();
     int main() override;
     void processEventStandardJobFailure(std::shared_ptr<wrench::StandardJobFailedEvent> event) override;
     void processEventStandardJobCompletion(std::shared_ptr<wrench::StandardJobCompletedEvent> event) override;
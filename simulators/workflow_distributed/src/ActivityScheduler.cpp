@@ -8,6 +8,7 @@
  */
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -82,6 +83,8 @@ namespace wrench {
                     std::map<std::string, std::string> service_specific_arguments;
                     service_specific_arguments[t->getID()] = h.first+":1";
                     this->getJobManager()->submitJob(job, compute_service, service_specific_arguments);
+                    EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                        {"compute_service", compute_service->getHostname()}});
 
                     this->idle_core_counts[h.first]--;
                     this->available_rams[h.first] -= t->getMemoryRequirement();
@@ -11,11 +11,16 @@
 #include <iomanip>
 #include <string>
 #include <wrench.h>
-#include <pugixml.hpp>
 #include <sstream>
 
 #include "ActivityWMS.h"
 #include "ActivityScheduler.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
  * @brief Generate the workflow
@@ -49,17 +54,15 @@ void generateWorkflow(wrench::Workflow *workflow) {
 }
 
 /**
- * @brief Generate the platform file
- * @param platform_file_path: path to write the file to
+ * @brief Generate the platform
  * @param num_hosts: number of hosts
  * @param num_cores_per_host: number of cores per host
  * @param effective_nework_bandwidth: wide-area bandwidth in MB/sec
+ * @return the platform description
+ *
+ * @throws std::invalid_argument
  */
-void generatePlatform(std::string platform_file_path, int num_hosts, int num_cores_per_host, int effective_network_bandwidth) {
-
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
+PlatformBuilder::Zone generatePlatform(int num_hosts, int num_cores_per_host, int effective_network_bandwidth) {
 
     if ((num_hosts < 1) || (num_cores_per_host < 1) || (effective_network_bandwidth < 1)) {
         throw std::invalid_argument("generatePlatform() bandwidth must be greater than 1");
@@ -71,90 +74,49 @@ void generatePlatform(std::string platform_file_path, int num_hosts, int num_cor
     int wide_area_bandwidth_in_kb_p_sec = (int)(1000.0 * effective_network_bandwidth / .97);
     int local_area_bandwidth_in_kb_p_sec = (int)(10 * (GB/1000.0) / .97);
 
-    // Create a the platform file
-    std::string xml = "<?xml version='1.0'?>\n"
-                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                      "<platform version=\"4.1\">\n";
-    xml += "   <zone id=\"AS0\" routing=\"Full\">\n";
-
-    xml += "    <zone id=\"AS1\" routing=\"Full\">\n";
+    PlatformBuilder::Zone platform("AS0");
 
+    PlatformBuilder::Zone &cluster = platform.addZone("AS1");
 
-
-    // The cluster's storage node)
-    xml += "          <host id=\"hpc_0.edu\" speed=\"100Gf\" core=\"1\">\n";
-    xml += "                <disk id=\"hpc_disk\" read_bw=\"500MBps\" write_bw=\"500MBps\">\n";
-    xml += "                       <prop id=\"size\" value=\"5000GiB\"/>\n";
-    xml += "                       <prop id=\"mount\" value=\"/\"/>\n";
-    xml += "                </disk>\n";
-    xml += "          </host>\n";
+    // The cluster's storage node
+    cluster.addHost("hpc_0.edu", "100Gf", 1).addDisk("hpc_disk", "500MBps", "500MBps");
 
     // The cluster's other compute nodes
     for (int i = 1; i < num_hosts + 1; i++) {
-        xml += "        <host id=\"hpc_" + std::to_string(i) + ".edu\" speed=\"100Gf\" core=\"" +
-               std::to_string(num_cores_per_host) + "\">\n";
-        xml += "         <prop id=\"ram\" value=\"32000000000\"/>\n";
-        xml += "        </host>\n";
+        cluster.addHost("hpc_" + std::to_string(i) + ".edu", "100Gf", num_cores_per_host)
+                .setProperty("ram", "32000000000");
     }
 
     // The cluster's router
-    xml += "       <router id=\"hpc_router\"> </router>\n";
+    cluster.addRouter("hpc_router");
 
     // The loopback link
-    xml += "      <link id=\"loopback\" bandwidth=\"50000GBps\" latency=\"0ns\"/>\n";
+    cluster.addLink("loopback", "50000GBps", "0ns");
 
     // The cluster's network links
     for (int i = 0; i < num_hosts + 1; i++) {
-        xml += "        <link id=\"link_" + std::to_string(i) +
-               "\" bandwidth=\""+ std::to_string(local_area_bandwidth_in_kb_p_sec) +"kBps\" latency=\"10us\"/>\n";
+        cluster.addLink("link_" + std::to_string(i), std::to_string(local_area_bandwidth_in_kb_p_sec) + "kBps", "10us");
     }
 
     // The cluster's routes
     for (int i = 1; i < num_hosts + 1; i++) {
-        xml += "        <route src=\"hpc_" + std::to_string(i) + ".edu\" dst=\"hpc_router\">\n";
-        xml += "            <link_ctn id=\"link_" + std::to_string(i) + "\"/>\n";
-        xml += "        </route>\n";
-        xml += "        <route src=\"hpc_" + std::to_string(i) + ".edu\" dst=\"hpc_" + std::to_string(i) + ".edu\">\n";
-        xml += "            <link_ctn id=\"loopback\"/>\n";
-        xml += "        </route>\n";
-        xml += "        <route src=\"hpc_" + std::to_string(i) + ".edu\" dst=\"hpc_" + std::to_string(0) + ".edu\">\n";
-        xml += "            <link_ctn id=\"link_" + std::to_string(i) + "\"/>\n";
-        xml += "            <link_ctn id=\"link_" + std::to_string(0) + "\"/>\n";
-        xml += "        </route>\n";
+        std::string host = "hpc_" + std::to_string(i) + ".edu";
+        cluster.addRoute(host, "hpc_router", {"link_" + std::to_string(i)});
+        cluster.addRoute(host, host, {"loopback"});
+        cluster.addRoute(host, "hpc_0.edu", {"link_" + std::to_string(i), "link_0"});
     }
-    xml += "      </zone>\n";
 
     // The rest of the platform
-    xml += "      <zone id=\"AS2\" routing=\"Full\">\n";
-    xml += "          <host id=\"storage.edu\" speed=\"1000Gf\">\n";
-    xml += "                <disk id=\"large_disk\" read_bw=\"500MBps\" write_bw=\"500MBps\">\n";
-    xml += "                       <prop id=\"size\" value=\"5000GiB\"/>\n";
-    xml += "                       <prop id=\"mount\" value=\"/\"/>\n";
-    xml += "                </disk>\n";
-    xml += "          </host>\n";
-    xml += "      </zone>\n";
-    xml += "      <zone id=\"AS3\" routing=\"Full\">\n";
-    xml += "          <host id=\"user.edu\" speed=\"1000Gf\" core=\"1\">\n";
-    xml += "          </host>\n";
-    xml += "      </zone>\n";
-
-    xml += "      <link id=\"wide_area_link\" bandwidth=\"" + std::to_string(wide_area_bandwidth_in_kb_p_sec) + "kBps\" latency=\"10ms\"/>\n";
-    xml += "      <link id=\"fast_wide_area_link\" bandwidth=\"1000000GBps\" latency=\"1us\"/>\n";
-    xml += "      <zoneRoute src=\"AS3\" dst=\"AS2\" gw_src=\"user.edu\" gw_dst=\"storage.edu\">\n";
-    xml += "        <link_ctn id=\"fast_wide_area_link\"/>\n";
-    xml += "      </zoneRoute>\n";
-    xml += "      <zoneRoute src=\"AS3\" dst=\"AS1\" gw_src=\"user.edu\" gw_dst=\"hpc_router\">\n";
-    xml += "        <link_ctn id=\"fast_wide_area_link\"/>\n";
-    xml += "      </zoneRoute>\n";
-    xml += "      <zoneRoute src=\"AS2\" dst=\"AS1\" gw_src=\"storage.edu\" gw_dst=\"hpc_router\">\n";
-    xml += "        <link_ctn id=\"wide_area_link\"/>\n";
-    xml += "      </zoneRoute>\n";
-    xml += "   </zone>\n";
-    xml += "</platform>\n";
-
-    FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-    fprintf(platform_file, "%s", xml.c_str());
-    fclose(platform_file);
+    platform.addZone("AS2").addHost("storage.edu", "1000Gf").addDisk("large_disk", "500MBps", "500MBps");
+    platform.addZone("AS3").addHost("user.edu", "1000Gf", 1);
+
+    platform.addLink("wide_area_link", std::to_string(wide_area_bandwidth_in_kb_p_sec) + "kBps", "10ms");
+    platform.addLink("fast_wide_area_link", "1000000GBps", "1us");
+    platform.addZoneRoute("AS3", "AS2", "user.edu", "storage.edu", {"fast_wide_area_link"});
+    platform.addZoneRoute("AS3", "AS1", "user.edu", "hpc_router", {"fast_wide_area_link"});
+    platform.addZoneRoute("AS2", "AS1", "storage.edu", "hpc_router", {"wide_area_link"});
+
+    return platform;
 }
 
 /**
@@ -165,8 +127,14 @@ void generatePlatform(std::string platform_file_path, int num_hosts, int num_cor
  */
 int main(int argc, char **argv) {
 
+    BatchMode::init(&argc, &argv, "workflow_distributed");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "workflow_distributed");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "workflow_distributed");
 
     int NUM_HOSTS;
     int NUM_CORES_PER_HOST;
@@ -215,9 +183,11 @@ int main(int argc, char **argv) {
     generateWorkflow(&workflow);
 
     // generate platform
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, NUM_HOSTS, NUM_CORES_PER_HOST, WIDE_AREA_BW);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(NUM_HOSTS, NUM_CORES_PER_HOST, WIDE_AREA_BW));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     // Remote storage service
     auto storage_service = simulation.add(new wrench::SimpleStorageService(
@@ -272,7 +242,17 @@ int main(int argc, char **argv) {
     }
 
     // launch the simulation
+    PhaseTimer::start("simulation");
     simulation.launch();
+    PhaseTimer::start("output");
+
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json", false, true, true, false, true, true, true);
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"), false, true, true, false, true, true, true);
+
+    }
 }
@@ -8,6 +8,7 @@
  */
 
 #include "ActivityScheduler.h"
+#include "EventLog.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms_scheduler, "Log category for Simple WMS Scheduler");
 
@@ -56,6 +57,8 @@ namespace wrench {
                 }
                 auto job = this->getJobManager()->createStandardJob(t, file_locations);
                 this->getJobManager()->submitJob(job, compute_service, {});
+                EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                                    {"compute_service", compute_service->getHostname()}});
 
                 idle_core_count--;
                 free_ram -= t->getMemoryRequirement();
@@ -1,5 +1,6 @@
 
 #include "ActivityWMS.h"
+#include "EventLog.h"
 #include <algorithm>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms, "Log category for Simple WMS");
@@ -36,6 +37,8 @@ namespace wrench {
 
         WRENCH_INFO("About to execute a workflow with %lu tasks", this->getWorkflow()->getNumberOfTasks());
 
+        EventLog::record("wms_start", {{"num_tasks", this->getWorkflow()->getNumberOfTasks()}});
+
         // Create a job manager
         this->job_manager = this->createJobManager();
 
@@ -80,6 +83,8 @@ namespace wrench {
             WRENCH_INFO("Workflow execution is incomplete!");
         }
 
+        EventLog::record("wms_end", {{"completed", this->getWorkflow()->isDone()}});
+
         this->job_manager.reset();
 
         return 0;
@@ -91,6 +96,7 @@ namespace wrench {
      */
     void ActivityWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> event) {
         auto standard_job = event->standard_job;
+        EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(standard_job->getTasks())}});
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);
         for (const auto &t : standard_job->getTasks()) { WRENCH_INFO("Notified that %s has completed",
                                                                      t->getID().c_str());
@@ -103,6 +109,8 @@ namespace wrench {
      */
     void ActivityWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> event) {
         auto standard_job = event->standard_job;
+        EventLog::record("job_failure", {{"tasks", EventLog::taskIDs(standard_job->getTasks())},
+                                         {"cause", event->failure_cause->toString()}});
         TerminalOutput::setThisProcessLoggingColor(TerminalOutput::Color::COLOR_RED);
         for (const auto &t : standard_job->getTasks()) {
             WRENCH_INFO("Notified that %s has failed  (%s)",
@@ -10,10 +10,15 @@
 #include <iostream>
 #include <string>
 #include <wrench.h>
-#include <pugixml.hpp>
 
 #include "ActivityWMS.h"
 #include "ActivityScheduler.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
  * @brief Generate the workflow for activity 1
@@ -66,43 +71,26 @@ void generateWorkflow(wrench::Workflow *workflow) {
 }
 
 /**
- * @brief Generate the platform file for activity 1
- * @param platform_file_path: path to write the file to
- * @param compute_speed: compute speed in GFlop/sec
+ * @brief Generate the platform for activity 1
+ * @param num_cores: number of cores of the host
+ * @param disk_bw: disk bandwidth in MB/sec
+ * @return the platform description
+ *
+ * @throws std::invalid_argument
  */
-void generatePlatform(std::string platform_file_path, int num_cores, int disk_bw) {
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
-
-    int effective_bandwidth = 10 * 1000 * 1000; // 10 MBps
+PlatformBuilder::Zone generatePlatform(int num_cores, int disk_bw) {
 
     if ((num_cores < 1) || (disk_bw < 1)) {
         throw std::invalid_argument("generatePlatform() bandwidth must be greater than 1");
     }
 
-    std::string xml_string = "<?xml version='1.0'?>\n"
-                             "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                             "<platform version=\"4.1\">\n"
-                             "   <zone id=\"AS0\" routing=\"Full\">\n"
-                             "       <host id=\"the_host\" speed=\"50Gf\" core=\"" + std::to_string(num_cores) + "\">\n"
-                             "           <disk id=\"disk\" read_bw=\""+std::to_string(disk_bw)+"MBps\" write_bw=\"" +std::to_string(disk_bw)+"MBps\">\n"
-                             "                            <prop id=\"size\" value=\"5000GB\"/>\n"
-                             "                            <prop id=\"mount\" value=\"/\"/>\n"
-                             "           </disk>\n"
-                             "           <prop id=\"ram\" value=\"16GB\" />"
-                             "       </host>\n"
-                             "       <link id=\"loopback\" bandwidth=\"100000GBps\" latency=\"0us\"/>\n"
-                             "       <route src=\"the_host\" dst=\"the_host\">\n"
-                             "           <link_ctn id=\"loopback\"/>\n"
-                             "       </route>\n"
-                             "    </zone>\n"
-                             "</platform>";
-
-    FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-    fprintf(platform_file, "%s", xml_string.c_str());
-    fclose(platform_file);
-
+    PlatformBuilder::Zone platform("AS0");
+    platform.addHost("the_host", "50Gf", num_cores)
+            .setProperty("ram", "16GB")
+            .addDisk("disk", std::to_string(disk_bw) + "MBps", std::to_string(disk_bw) + "MBps", "5000GB");
+    platform.addLink("loopback", "100000GBps", "0us");
+    platform.addRoute("the_host", "the_host", {"loopback"});
+    return platform;
 }
 
 /**
@@ -113,8 +101,14 @@ void generatePlatform(std::string platform_file_path, int num_cores, int disk_bw
  */
 int main(int argc, char **argv) {
 
+    BatchMode::init(&argc, &argv, "workflow_fundamentals");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "workflow_fundamentals");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "workflow_fundamentals");
 
     int NUM_CORES;
     int DISK_BW;
@@ -148,9 +142,11 @@ int main(int argc, char **argv) {
     generateWorkflow(&workflow);
 
     // generate platform
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path, NUM_CORES, DISK_BW);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform(NUM_CORES, DISK_BW));
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     // storage service
     auto storage_service = simulation.add(new wrench::SimpleStorageService("the_host", {"/"},
@@ -186,7 +182,17 @@ int main(int argc, char **argv) {
     }
 
     // launch the simulation
+    PhaseTimer::start("simulation");
     simulation.launch();
+    PhaseTimer::start("output");
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json");
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"));
+
+    }
 }
@@ -1,5 +1,6 @@
 
 #include "ActivityWMS.h"
+#include "EventLog.h"
 #include <algorithm>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(simple_wms, "Log category for Simple WMS");
@@ -29,6 +30,9 @@ namespace wrench {
         auto cs = *((this->getAvailableComputeServices<ComputeService>()).begin());
         auto job = this->job_manager->createStandardJob(this->getWorkflow()->getTaskByID(task_name));
         this->job_manager->submitJob(job, cs, {{task_name, host_name}});
+        EventLog::record("job_submission", {{"tasks",           EventLog::taskIDs(job->getTasks())},
+                                            {"compute_service", cs->getHostname()},
+                                            {"execution_host",  host_name}});
         WRENCH_INFO("%s task starting on %lu cores on %s",
                     task_name.c_str(),
                     this->getWorkflow()->getTaskByID(task_name)->getMinNumCores(),
@@ -45,6 +49,8 @@ namespace wrench {
 
         WRENCH_INFO("About to execute a workflow with %lu tasks", this->getWorkflow()->getNumberOfTasks());
 
+        EventLog::record("wms_start", {{"num_tasks", this->getWorkflow()->getNumberOfTasks()}});
+
         // Create the job manager
         this->job_manager = this->createJobManager();
 
@@ -59,6 +65,7 @@ namespace wrench {
         {
             submitTask("green", "host1");
             auto event = this->waitForNextEvent();
+            EventLog::record("job_completion", {{"tasks", nlohmann::json::array({"green"})}});
             WRENCH_INFO("green task has completed");
         }
         // Submit blue task on host1
@@ -98,6 +105,7 @@ namespace wrench {
             auto event = this->waitForNextEvent();
             num_pending_tasks--;
             auto real_event = std::dynamic_pointer_cast<StandardJobCompletedEvent>(event);
+            EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(real_event->standard_job->getTasks())}});
             auto num_cores = real_event->standard_job->getTasks().at(0)->getMinNumCores();
             auto hostname = real_event->standard_job->getTasks().at(0)->getExecutionHost();
             WRENCH_INFO("%s task has completed", real_event->standard_job->getTasks().at(0)->getID().c_str());
@@ -107,6 +115,7 @@ namespace wrench {
         while (num_pending_tasks--) {
             auto event = waitForNextEvent();
             auto real_event = std::dynamic_pointer_cast<StandardJobCompletedEvent>(event);
+            EventLog::record("job_completion", {{"tasks", EventLog::taskIDs(real_event->standard_job->getTasks())}});
             WRENCH_INFO("%s task has completed", real_event->standard_job->getTasks().at(0)->getID().c_str());
         }
 
@@ -114,6 +123,7 @@ namespace wrench {
         {
             submitTask("red", "host1");
             this->waitForNextEvent();
+            EventLog::record("job_completion", {{"tasks", nlohmann::json::array({"red"})}});
             WRENCH_INFO("red task has completed");
         }
 
@@ -124,6 +134,8 @@ namespace wrench {
             WRENCH_INFO("Workflow execution is incomplete!");
         }
 
+        EventLog::record("wms_end", {{"completed", this->getWorkflow()->isDone()}});
+
         job_manager.reset();
 
         return 0;
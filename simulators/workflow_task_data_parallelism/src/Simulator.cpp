@@ -12,6 +12,12 @@
 #include <wrench.h>
 
 #include "ActivityWMS.h"
+#include "BatchMode.h"
+#include "ColumnarOutput.h"
+#include "EventLog.h"
+#include "OutputDirectory.h"
+#include "PhaseTimer.h"
+#include "PlatformBuilder.h"
 
 /**
  * @brief Generate the workflow
@@ -66,52 +72,26 @@ void generateWorkflow(wrench::Workflow *workflow,
 }
 
 /**
- * @brief Generate the platform file
- * @param platform_file_path: path to write the file to
- * @param num_hosts: number of hosts
- * @param num_cores_per_host: number of cores per host
- * @param effective_nework_bandwidth: wide-area bandwidth in MB/sec
+ * @brief Generate the platform (two 3-core hosts)
+ * @return the platform description
  */
-void generatePlatform(std::string platform_file_path) {
-
-    if (platform_file_path.empty()) {
-        throw std::invalid_argument("generatePlatform() platform_file_path cannot be empty");
-    }
-
-    const double MB = 1000.0 * 1000.0;
-    const double GB = MB * 1000.0;
-
-    // Create a the platform file
-    std::string xml = "<?xml version='1.0'?>\n"
-                      "<!DOCTYPE platform SYSTEM \"http://simgrid.gforge.inria.fr/simgrid/simgrid.dtd\">\n"
-                      "<platform version=\"4.1\">\n";
-    xml += "   <zone id=\"AS0\" routing=\"Full\">\n";
+PlatformBuilder::Zone generatePlatform() {
 
+    PlatformBuilder::Zone platform("AS0");
 
     // The two hosts
-    xml += "      <host id=\"host1\" speed=\"100Gf\" core=\"3\"/>\n";
-    xml += "      <host id=\"host2\" speed=\"100Gf\" core=\"3\"/>\n";
+    platform.addHost("host1", "100Gf", 3);
+    platform.addHost("host2", "100Gf", 3);
 
     // The loopback link
-    xml += "      <link id=\"loopback\" bandwidth=\"50000GBps\" latency=\"0ns\"/>\n";
+    platform.addLink("loopback", "50000GBps", "0ns");
 
     // The routes
-    xml += "      <route src=\"host1\" dst=\"host2\">\n";
-    xml += "          <link_ctn id=\"loopback\"/>\n";
-    xml += "      </route>\n";
-    xml += "      <route src=\"host1\" dst=\"host1\">\n";
-    xml += "          <link_ctn id=\"loopback\"/>\n";
-    xml += "      </route>\n";
-    xml += "      <route src=\"host2\" dst=\"host2\">\n";
-    xml += "          <link_ctn id=\"loopback\"/>\n";
-    xml += "      </route>\n";
-
-    xml += "   </zone>\n";
-    xml += "</platform>\n";
-
-    FILE *platform_file = fopen(platform_file_path.c_str(), "w");
-    fprintf(platform_file, "%s", xml.c_str());
-    fclose(platform_file);
+    platform.addRoute("host1", "host2", {"loopback"});
+    platform.addRoute("host1", "host1", {"loopback"});
+    platform.addRoute("host2", "host2", {"loopback"});
+
+    return platform;
 }
 
 /**
@@ -122,8 +102,14 @@ void generatePlatform(std::string platform_file_path) {
  */
 int main(int argc, char **argv) {
 
+    BatchMode::init(&argc, &argv, "workflow_task_data_parallelism");
+
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
+    OutputDirectory::init(&argc, argv, "workflow_task_data_parallelism");
+    EventLog::init(&argc, argv);
+    ColumnarOutput::init(&argc, argv);
+    PhaseTimer::init(&argc, argv, "workflow_task_data_parallelism");
 
     int BLUE_NUM_CORES;
     int YELLOW_NUM_CORES;
@@ -163,9 +149,11 @@ int main(int argc, char **argv) {
     generateWorkflow(&workflow, BLUE_NUM_CORES, YELLOW_NUM_CORES, PURPLE_NUM_CORES);
 
     // generate platform
-    std::string platform_file_path = "/tmp/platform.xml";
-    generatePlatform(platform_file_path);
+    PhaseTimer::start("platform_generation");
+    std::string platform_file_path = PlatformBuilder::cache(generatePlatform());
+    PhaseTimer::start("platform_instantiation");
     simulation.instantiatePlatform(platform_file_path);
+    PhaseTimer::start("simulation_setup");
 
     std::vector<std::string> compute_hosts = {"host1", "host2"};
     auto compute_service = simulation.add(new wrench::BareMetalComputeService(
@@ -183,7 +171,17 @@ int main(int argc, char **argv) {
     wms->addWorkflow(&workflow);
 
     // launch the simulation
+    PhaseTimer::start("simulation");
     simulation.launch();
+    PhaseTimer::start("output");
 
-    simulation.getOutput().dumpUnifiedJSON(&workflow, "/tmp/workflow_data.json");
+    if (ColumnarOutput::isEnabled()) {
+
+        ColumnarOutput::dump(simulation, &workflow, OutputDirectory::path("workflow_data.ewc"));
+
+    } else {
+
+        simulation.getOutput().dumpUnifiedJSON(&workflow, OutputDirectory::path("workflow_data.json"));
+
+    }
 }
@@ -26,8 +26,9 @@ const NetworkBandwidthUsageChart = ({
 
   if (data.link_usage) {
     const links = data.link_usage.links
-    chartData = { labels: [], datasets: [] }
-    let labels = []
+    // samples are unevenly spaced (and a change is recorded as two samples at the same time), so
+    // each dataset has its own (time, usage) points on a linear time axis
+    chartData = { datasets: [] }
 
     Object.keys(links).forEach(function(key) {
       let link = links[key]
@@ -35,16 +36,14 @@ const NetworkBandwidthUsageChart = ({
         return
       }
 
-      let bytes = []
+      let points = []
       for (let idx in link.link_usage_trace) {
         let entry = link.link_usage_trace[idx]
         if (!range || (range && entry.time >= range[0] && entry.time <= range[1])) {
-          let parsedTime = parseFloat(entry.time).toFixed(2)
-          if (!labels.includes(parsedTime)) {
-            labels.push(parsedTime)
-          }
-          // zoomMaxRange = Math.max(zoomMaxRange, entry.time)
-          bytes.push(parseFloat(entry["bytes per second"] / Math.pow(10, unit[2])).toFixed(3))
+          points.push({
+            x: parseFloat(entry.time),
+            y: parseFloat((entry["bytes per second"] / Math.pow(10, unit[2])).toFixed(3))
+          })
         }
       }
 
@@ -54,15 +53,15 @@ const NetworkBandwidthUsageChart = ({
         backgroundColor: color,
         borderColor: color,
         stepped: true,
-        data: bytes,
+        data: points,
         fill: true
       })
     })
-    chartData.labels = labels
 
     options = {
       scales: {
         x: {
+          type: "linear",
           title: {
             display: true,
             text: "Time (seconds)"
@@ -77,7 +76,8 @@ const NetworkBandwidthUsageChart = ({
       },
       plugins: {
         tooltip: {
-          mode: "index",
+          mode: "nearest",
+          axis: "x",
           intersect: false
         }
       }